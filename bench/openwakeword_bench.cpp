@@ -0,0 +1,626 @@
+// Benchmarks for every pipeline stage and the end-to-end path.
+//
+// Each model is timed call by call on its own (mel spectrogram, embedding,
+// every wake word model), as are the inter-stage buffers, followed by the
+// full pipeline over a synthetic or given recording at each step size and
+// model count, and custom verifiers per candidate batch. Every result
+// reports mean, p50 and p99 latency and the real-time factor (processing
+// time per second of audio covered), so ONNX Runtime settings and code
+// changes can be compared with numbers.
+//
+// Options other than the --bench-* ones are passed to the regular
+// openwakeword parser, so models, frontends and buffering are selected
+// exactly as for the main program.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <onnxruntime_cxx_api.h>
+#include "core/mel_frontend.h"
+#include "core/model_wrapper.h"
+#include "core/ort_environment.h"
+#include "core/pipeline.h"
+#include "core/spsc_ring_buffer.h"
+#include "core/thread_safe_buffer.h"
+#include "core/types.h"
+#include "processors/audio_converter.h"
+#include "processors/audio_reader.h"
+#include "utils/config.h"
+#include "utils/kernels.h"
+#include "utils/metrics.h"
+
+using namespace openwakeword;
+
+namespace {
+
+struct BenchOptions {
+    size_t iterations = 500;
+    std::filesystem::path audioPath;   // Empty: synthetic audio
+    double audioSeconds = 60.0;        // Length of the synthetic audio
+    std::vector<size_t> stepFrames = {1, 2, 4, 8};
+    std::vector<size_t> threads;       // Intra-op thread counts; empty uses the config's
+    std::string filter;                // Only benchmarks whose name contains this
+};
+
+struct Result {
+    std::string name;
+    uint64_t calls = 0;
+    double mean = 0.0;         // Seconds
+    double p50 = 0.0;
+    double p99 = 0.0;
+    double audioPerCall = 0.0; // Seconds of audio covered by one call
+    bool bucketed = false;     // Quantiles are histogram bucket bounds
+
+    double realTimeFactor() const { return audioPerCall > 0.0 ? mean / audioPerCall : 0.0; }
+};
+
+void printUsage(const char* programName) {
+    std::cerr << "Usage: " << programName << " [BENCH OPTIONS] --model MODEL [OPENWAKEWORD OPTIONS]" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "BENCH OPTIONS:" << std::endl;
+    std::cerr << "  --bench-iterations NUM        Timed calls per stage benchmark (default: 500)" << std::endl;
+    std::cerr << "  --bench-audio FILE            16 kHz mono WAV/PCM file for the pipeline (default: synthetic)" << std::endl;
+    std::cerr << "  --bench-seconds SECS          Length of the synthetic audio (default: 60)" << std::endl;
+    std::cerr << "  --bench-step-frames LIST      Comma-separated step sizes in 80 ms chunks (default: 1,2,4,8)" << std::endl;
+    std::cerr << "  --bench-threads LIST          Comma-separated ONNX Runtime intra-op thread counts" << std::endl;
+    std::cerr << "                                (default: the configured count)" << std::endl;
+    std::cerr << "  --bench-filter TEXT           Only run benchmarks whose name contains TEXT" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "All other options are those of openwakeword (see openwakeword --help); the pipeline" << std::endl;
+    std::cerr << "is run with the first 1..N of the given --model options. --json prints one JSON" << std::endl;
+    std::cerr << "object per result." << std::endl;
+}
+
+bool parseList(const std::string& text, std::vector<size_t>& values) {
+    values.clear();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        char* end = nullptr;
+        unsigned long value = std::strtoul(item.c_str(), &end, 10);
+        if (item.empty() || *end != '\0' || value == 0) {
+            return false;
+        }
+        values.push_back(value);
+    }
+    return !values.empty();
+}
+
+// Deterministic test signal: low-level noise with alternating one-second
+// bursts of a harmonic tone, so every stage sees non-trivial input
+std::vector<AudioSample> syntheticAudio(double seconds) {
+    size_t count = static_cast<size_t>(seconds * SAMPLE_RATE);
+    std::vector<AudioSample> audio(count);
+    std::mt19937 generator(1234);
+    std::normal_distribution<float> noise(0.0f, 300.0f);
+    for (size_t i = 0; i < count; ++i) {
+        float sample = noise(generator);
+        if ((i / SAMPLE_RATE) % 2 == 1) {
+            double t = static_cast<double>(i) / SAMPLE_RATE;
+            sample += static_cast<float>(4000.0 * std::sin(2.0 * std::numbers::pi * 220.0 * t) +
+                                         2000.0 * std::sin(2.0 * std::numbers::pi * 660.0 * t));
+        }
+        audio[i] = static_cast<AudioSample>(std::clamp(sample, -32768.0f, 32767.0f));
+    }
+    return audio;
+}
+
+bool loadAudio(const BenchOptions& options, std::vector<AudioSample>& audio) {
+    if (options.audioPath.empty()) {
+        audio = syntheticAudio(options.audioSeconds);
+        return true;
+    }
+
+    MappedAudioReader reader(options.audioPath.string());
+    if (!reader.isOpen()) {
+        std::cerr << "[ERROR] Failed to open benchmark audio: " << options.audioPath << std::endl;
+        return false;
+    }
+    if (reader.getSampleRate() != SAMPLE_RATE || reader.getChannels() != 1) {
+        std::cerr << "[ERROR] Benchmark audio must be 16 kHz mono: " << options.audioPath << std::endl;
+        return false;
+    }
+    auto samples = reader.samples();
+    audio.assign(samples.begin(), samples.end());
+    return true;
+}
+
+// Time fn(i) call by call after a short warm-up
+template<typename Fn>
+Result measure(const std::string& name, size_t iterations, double audioPerCall, Fn fn) {
+    size_t warmup = std::max<size_t>(iterations / 10, 1);
+    for (size_t i = 0; i < warmup; ++i) {
+        fn(i);
+    }
+
+    std::vector<double> times(iterations);
+    for (size_t i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn(warmup + i);
+        times[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    Result result;
+    result.name = name;
+    result.calls = iterations;
+    result.audioPerCall = audioPerCall;
+    if (!times.empty()) {
+        double total = 0.0;
+        for (double time : times) {
+            total += time;
+        }
+        result.mean = total / static_cast<double>(times.size());
+        std::sort(times.begin(), times.end());
+        result.p50 = times[std::min(times.size() - 1, times.size() / 2)];
+        result.p99 = times[std::min(times.size() - 1, times.size() * 99 / 100)];
+    }
+    return result;
+}
+
+void printResult(const Result& result, bool json) {
+    if (json) {
+        std::cout << "{\"benchmark\":\"" << result.name << "\",\"calls\":" << result.calls
+                  << ",\"mean_ms\":" << result.mean * 1e3
+                  << ",\"p50_ms\":" << result.p50 * 1e3
+                  << ",\"p99_ms\":" << result.p99 * 1e3
+                  << ",\"real_time_factor\":" << result.realTimeFactor()
+                  << ",\"bucketed\":" << (result.bucketed ? "true" : "false") << "}" << std::endl;
+        return;
+    }
+
+    const char* bound = result.bucketed ? "<=" : "  ";
+    std::cout << std::left << std::setw(44) << result.name << std::right
+              << std::setw(9) << result.calls
+              << std::fixed << std::setprecision(3)
+              << std::setw(11) << result.mean * 1e3
+              << std::setw(4) << bound << std::setw(9) << result.p50 * 1e3
+              << std::setw(4) << bound << std::setw(9) << result.p99 * 1e3
+              << std::setprecision(5) << std::setw(11) << result.realTimeFactor()
+              << std::defaultfloat << std::endl;
+}
+
+void printHeader(bool json) {
+    if (json) {
+        return;
+    }
+    std::cout << std::left << std::setw(44) << "benchmark" << std::right
+              << std::setw(9) << "calls" << std::setw(11) << "mean ms"
+              << std::setw(13) << "p50 ms" << std::setw(13) << "p99 ms"
+              << std::setw(11) << "RTF" << std::endl;
+}
+
+// Summary of a pipeline histogram; quantiles are bucket upper bounds
+Result fromSnapshot(const std::string& name, const LatencyHistogram::Snapshot& snapshot,
+                    double audioPerCall) {
+    Result result;
+    result.name = name;
+    result.calls = snapshot.count;
+    result.mean = snapshot.mean();
+    result.p50 = snapshot.quantile(0.5);
+    result.p99 = snapshot.quantile(0.99);
+    result.audioPerCall = audioPerCall;
+    result.bucketed = true;
+    return result;
+}
+
+class Bench {
+public:
+    Bench(const Config& config, const BenchOptions& options, std::vector<AudioSample> audio)
+        : config_(config), options_(options), audio_(std::move(audio)),
+          ortEnvironment_(OrtEnvironment::acquire(config)), env_(ortEnvironment_->env()),
+          json_(config.outputMode == OutputMode::JSON) {
+        floatAudio_.resize(audio_.size());
+        kernels::convertInt16ToFloat(audio_.data(), floatAudio_.data(), audio_.size());
+    }
+
+    // Returns the number of benchmarks that failed to set up
+    size_t run() {
+        printHeader(json_);
+
+        // Global pools are sized once, when the environment is created
+        std::vector<size_t> threadCounts = options_.threads;
+        if (threadCounts.empty() || ortEnvironment_->hasGlobalThreadPools()) {
+            threadCounts.clear();
+            threadCounts.push_back(static_cast<size_t>(config_.intraOpNumThreads));
+        }
+
+        for (size_t threads : threadCounts) {
+            Config threadConfig = config_;
+            threadConfig.intraOpNumThreads = static_cast<int>(threads);
+            Ort::SessionOptions sessionOptions = ortEnvironment_->createSessionOptions(threadConfig);
+            std::string suffix = " threads=" + std::to_string(threads);
+
+            for (size_t steps : options_.stepFrames) {
+                benchOnnxMel(sessionOptions, steps, suffix);
+            }
+            benchEmbedding(sessionOptions, suffix);
+            benchWakeWords(sessionOptions, suffix);
+            benchVerifiers(sessionOptions, suffix);
+        }
+
+        // Model-free benchmarks do not depend on the thread count
+        for (size_t steps : options_.stepFrames) {
+            benchNativeMel(steps);
+        }
+        benchConverters();
+        benchBuffers();
+
+        for (size_t threads : threadCounts) {
+            for (size_t steps : options_.stepFrames) {
+                for (size_t models = 1; models <= config_.wakeWordConfigs.size(); ++models) {
+                    benchPipeline(threads, steps, models);
+                }
+            }
+        }
+        return failures_;
+    }
+
+private:
+    Config config_;
+    BenchOptions options_;
+    std::vector<AudioSample> audio_;
+    std::vector<AudioFloat> floatAudio_;
+    std::shared_ptr<OrtEnvironment> ortEnvironment_;
+    Ort::Env& env_;
+    bool json_;
+    size_t failures_ = 0;
+
+    bool selected(const std::string& name) const {
+        return options_.filter.empty() || name.find(options_.filter) != std::string::npos;
+    }
+
+    void fail(const std::string& name, const std::string& reason) {
+        std::cerr << "[ERROR] " << name << ": " << reason << std::endl;
+        failures_++;
+    }
+
+    // Start of call i's frame, cycling through the audio
+    const AudioFloat* frameAt(size_t i, size_t frameSize) const {
+        size_t frames = std::max<size_t>(floatAudio_.size() / frameSize, 1);
+        return floatAudio_.data() + (i % frames) * frameSize;
+    }
+
+    void benchOnnxMel(const Ort::SessionOptions& sessionOptions, size_t steps, const std::string& suffix) {
+        size_t frameSize = steps * CHUNK_SAMPLES;
+        std::string name = "mel/onnx frame=" + std::to_string(frameSize) + suffix;
+        if (!selected(name)) {
+            return;
+        }
+        if (floatAudio_.size() < frameSize) {
+            fail(name, "audio shorter than one frame");
+            return;
+        }
+
+        MelSpectrogramModel model;
+        if (!model.loadModel(config_.melModelPath, env_, sessionOptions) || !model.prepare(frameSize)) {
+            fail(name, "failed to load " + config_.melModelPath.string());
+            return;
+        }
+        printResult(measure(name, options_.iterations, static_cast<double>(frameSize) / SAMPLE_RATE,
+                            [&](size_t i) { model.computeMelSpectrogram(frameAt(i, frameSize), frameSize); }),
+                    json_);
+    }
+
+    void benchNativeMel(size_t steps) {
+        size_t frameSize = steps * CHUNK_SAMPLES;
+        std::string name = "mel/native frame=" + std::to_string(frameSize);
+        if (!selected(name)) {
+            return;
+        }
+        if (floatAudio_.size() < frameSize) {
+            fail(name, "audio shorter than one frame");
+            return;
+        }
+
+        NativeMelFrontend frontend;
+        frontend.prepare(frameSize);
+        printResult(measure(name, options_.iterations, static_cast<double>(frameSize) / SAMPLE_RATE,
+                            [&](size_t i) { frontend.computeMelSpectrogram(frameAt(i, frameSize), frameSize); }),
+                    json_);
+    }
+
+    // Mel windows computed from the audio, so the embedding model sees
+    // realistic input
+    std::vector<AudioFloat> melWindows(size_t count) {
+        NativeMelFrontend frontend;
+        size_t windowSamples = (EMBEDDING_WINDOW_SIZE - 1) * MEL_HOP_SAMPLES + MEL_WINDOW_SAMPLES;
+        frontend.prepare(windowSamples);
+        std::vector<AudioFloat> windows;
+        for (size_t i = 0; i < count && floatAudio_.size() >= windowSamples; ++i) {
+            auto mels = frontend.computeMelSpectrogram(frameAt(i, windowSamples), windowSamples);
+            windows.insert(windows.end(), mels.begin(), mels.end());
+        }
+        return windows;
+    }
+
+    void benchEmbedding(const Ort::SessionOptions& sessionOptions, const std::string& suffix) {
+        std::string name = "embedding" + suffix;
+        if (!selected(name)) {
+            return;
+        }
+
+        constexpr size_t WINDOWS = 64;
+        constexpr size_t WINDOW_FLOATS = EMBEDDING_WINDOW_SIZE * NUM_MELS;
+        auto windows = melWindows(WINDOWS);
+        if (windows.empty()) {
+            fail(name, "audio shorter than one embedding window");
+            return;
+        }
+        size_t available = windows.size() / WINDOW_FLOATS;
+
+        EmbeddingModel model;
+        if (!model.loadModel(config_.embModelPath, env_, sessionOptions)) {
+            fail(name, "failed to load " + config_.embModelPath.string());
+            return;
+        }
+        model.bindIo();
+
+        // One window per 80 ms embedding step
+        double audioPerCall = static_cast<double>(EMBEDDING_STEP_SIZE * MEL_HOP_SAMPLES) / SAMPLE_RATE;
+        printResult(measure(name, options_.iterations, audioPerCall,
+                            [&](size_t i) { model.extractEmbeddings(windows.data() + (i % available) * WINDOW_FLOATS); }),
+                    json_);
+    }
+
+    void benchWakeWords(const Ort::SessionOptions& sessionOptions, const std::string& suffix) {
+        // Feature windows of plausible magnitude; wake word models are cheap
+        // enough that their cost hardly depends on the values
+        constexpr size_t WINDOWS = 64;
+        constexpr size_t WINDOW_FLOATS = WAKEWORD_FEATURES * EMBEDDING_FEATURES;
+        std::vector<AudioFloat> features(WINDOWS * WINDOW_FLOATS);
+        std::mt19937 generator(99);
+        std::normal_distribution<float> distribution(0.0f, 1.0f);
+        for (auto& value : features) {
+            value = distribution(generator);
+        }
+
+        for (const auto& wwConfig : config_.wakeWordConfigs) {
+            auto wakeWord = wwConfig.name;
+            std::string name = "wake_word/" + wakeWord + suffix;
+            if (!selected(name)) {
+                continue;
+            }
+
+            WakeWordModel model(wakeWord);
+            if (!model.loadModel(wwConfig.modelPath, env_, sessionOptions)) {
+                fail(name, "failed to load " + wwConfig.modelPath.string());
+                continue;
+            }
+            model.bindIo();
+
+            double audioPerCall = static_cast<double>(EMBEDDING_STEP_SIZE * MEL_HOP_SAMPLES) / SAMPLE_RATE;
+            printResult(measure(name, options_.iterations, audioPerCall,
+                                [&](size_t i) { model.predict(features.data() + (i % WINDOWS) * WINDOW_FLOATS); }),
+                        json_);
+        }
+    }
+
+    // Verifiers score candidates, not audio: no real-time factor
+    void benchVerifiers(const Ort::SessionOptions& sessionOptions, const std::string& suffix) {
+        constexpr size_t BATCHES[] = {1, 8};
+        constexpr size_t WINDOW_FLOATS = WAKEWORD_FEATURES * EMBEDDING_FEATURES;
+        std::vector<AudioFloat> features(BATCHES[1] * WINDOW_FLOATS);
+        std::mt19937 generator(7);
+        std::normal_distribution<float> distribution(0.0f, 1.0f);
+        for (auto& value : features) {
+            value = distribution(generator);
+        }
+        std::vector<const AudioFloat*> windows;
+        for (size_t i = 0; i < BATCHES[1]; ++i) {
+            windows.push_back(features.data() + i * WINDOW_FLOATS);
+        }
+
+        for (const auto& wwConfig : config_.wakeWordConfigs) {
+            if (wwConfig.verifierModelPath.empty()) {
+                continue;
+            }
+            auto wakeWord = wwConfig.name;
+            CustomVerifierModel model(wakeWord);
+            bool loaded = false;
+            for (size_t batch : BATCHES) {
+                std::string name = "verifier/" + wakeWord + " batch=" + std::to_string(batch) + suffix;
+                if (!selected(name)) {
+                    continue;
+                }
+                if (!loaded && !model.loadModel(wwConfig.verifierModelPath, env_, sessionOptions)) {
+                    fail(name, "failed to load " + wwConfig.verifierModelPath.string());
+                    break;
+                }
+                loaded = true;
+
+                std::vector<AudioFloat> scratch;
+                std::vector<float> probabilities(batch);
+                printResult(measure(name, options_.iterations, 0.0,
+                                    [&](size_t) {
+                                        model.verifyBatch(windows.data(), batch, scratch, probabilities.data());
+                                    }),
+                            json_);
+            }
+        }
+    }
+
+    // Push and pull of one 80 ms chunk on the calling thread, which isolates
+    // the per-call cost from thread wake-up latency
+    // Input conversion of one 80 ms chunk in common source formats
+    void benchConverters() {
+        const std::pair<size_t, size_t> formats[] = {{48000, 2}, {44100, 2}, {48000, 1}, {8000, 1}};
+        for (const auto& [rate, channels] : formats) {
+            std::string name = "convert/" + std::to_string(rate) + "x" + std::to_string(channels);
+            if (!selected(name)) {
+                continue;
+            }
+
+            std::vector<AudioSample> input(CHUNK_SAMPLES * rate / SAMPLE_RATE * channels);
+            for (size_t i = 0; i < input.size(); ++i) {
+                input[i] = audio_.empty() ? 0 : audio_[(i / channels) % audio_.size()];
+            }
+            AudioConverter converter(rate, channels, -1, input.size());
+            printResult(measure(name, options_.iterations, static_cast<double>(CHUNK_SAMPLES) / SAMPLE_RATE,
+                                [&](size_t) { converter.process(input); }),
+                        json_);
+        }
+    }
+
+    void benchBuffers() {
+        std::vector<AudioFloat> chunk(floatAudio_.begin(),
+                                      floatAudio_.begin() + std::min(floatAudio_.size(), CHUNK_SAMPLES));
+        chunk.resize(CHUNK_SAMPLES);
+        std::vector<AudioFloat> out(CHUNK_SAMPLES);
+        double audioPerCall = static_cast<double>(CHUNK_SAMPLES) / SAMPLE_RATE;
+        size_t iterations = options_.iterations * 20;
+
+        if (selected("buffer/thread_safe")) {
+            ThreadSafeBuffer<AudioFloat> buffer;
+            printResult(measure("buffer/thread_safe", iterations, audioPerCall, [&](size_t) {
+                buffer.push(chunk);
+                auto pulled = buffer.pull(CHUNK_SAMPLES);
+            }), json_);
+        }
+
+        if (selected("buffer/spsc_ring")) {
+            SpscRingBuffer<AudioFloat> buffer(2 * CHUNK_SAMPLES, config_.bufferWaitPolicy);
+            printResult(measure("buffer/spsc_ring", iterations, audioPerCall, [&](size_t) {
+                buffer.push(chunk.data(), chunk.size());
+                buffer.pull(out.data(), out.size());
+            }), json_);
+        }
+    }
+
+    // All of the audio through a full pipeline, as fast as it accepts it
+    void benchPipeline(size_t threads, size_t steps, size_t models) {
+        std::string name = "pipeline steps=" + std::to_string(steps) +
+                           " models=" + std::to_string(models) +
+                           " threads=" + std::to_string(threads);
+        if (!selected(name)) {
+            return;
+        }
+
+        Config config = config_;
+        config.outputMode = OutputMode::QUIET;
+        config.metricsPort = 0;
+        config.statsIntervalSeconds = 0;
+        config.intraOpNumThreads = static_cast<int>(threads);
+        config.stepFrames = steps;
+        config.frameSize = steps * CHUNK_SAMPLES;
+        config.wakeWordConfigs.resize(models);
+        config.wakeWordModelPaths.resize(std::min(models, config.wakeWordModelPaths.size()));
+
+        // Detections would otherwise reach stdout in between the results
+        Pipeline pipeline(config);
+        pipeline.setDetectionCallback([](const Detection&) {});
+        if (!pipeline.initialize()) {
+            fail(name, "failed to initialize pipeline");
+            return;
+        }
+        pipeline.start();
+        pipeline.waitUntilReady();
+
+        size_t readSize = config.streamingMel ? CHUNK_SAMPLES : config.frameSize;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t offset = 0; offset < audio_.size(); offset += readSize) {
+            pipeline.processAudio(audio_.data() + offset, std::min(readSize, audio_.size() - offset));
+        }
+        pipeline.stop();  // Drains every stage
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        Result total;
+        total.name = name;
+        total.calls = 1;
+        total.mean = total.p50 = total.p99 = elapsed;
+        total.audioPerCall = static_cast<double>(audio_.size()) / SAMPLE_RATE;
+        printResult(total, json_);
+
+        // Per-call inference time of each stage while running concurrently
+        const auto& metrics = pipeline.getMetrics();
+        double stepAudio = static_cast<double>(EMBEDDING_STEP_SIZE * MEL_HOP_SAMPLES) / SAMPLE_RATE;
+        for (const auto& stage : metrics.stageSummaries()) {
+            double audioPerCall = stage.stage == "mel" && !config.streamingMel
+                                      ? static_cast<double>(config.frameSize) / SAMPLE_RATE
+                                      : stepAudio;
+            std::string stageName = (json_ ? name + " " : "  ") + stage.stage +
+                                    (stage.model.empty() ? "" : "/" + stage.model);
+            printResult(fromSnapshot(stageName, stage.latency, audioPerCall), json_);
+        }
+        auto detections = metrics.detectionLatency();
+        if (detections.count > 0) {
+            printResult(fromSnapshot((json_ ? name + " " : "  ") + "detection_latency", detections, 0.0),
+                        json_);
+        }
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+
+    // Split off the benchmark options; the rest go to the regular parser
+    std::vector<char*> forwarded = {argv[0]};
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--bench-iterations" && hasValue) {
+            options.iterations = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--bench-audio" && hasValue) {
+            options.audioPath = argv[++i];
+        } else if (arg == "--bench-seconds" && hasValue) {
+            options.audioSeconds = std::atof(argv[++i]);
+        } else if (arg == "--bench-step-frames" && hasValue) {
+            if (!parseList(argv[++i], options.stepFrames)) {
+                std::cerr << "[ERROR] Invalid step frame list: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--bench-threads" && hasValue) {
+            if (!parseList(argv[++i], options.threads)) {
+                std::cerr << "[ERROR] Invalid thread count list: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--bench-filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg.rfind("--bench-", 0) == 0) {
+            std::cerr << "[ERROR] Missing value for " << arg << std::endl;
+            return 1;
+        } else if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            forwarded.push_back(argv[i]);
+        }
+    }
+
+    if (options.iterations == 0 || options.audioSeconds <= 0.0) {
+        std::cerr << "[ERROR] Iterations and audio length must be positive" << std::endl;
+        return 1;
+    }
+
+    Config config;
+    ParseResult parseResult = config.parseArgs(static_cast<int>(forwarded.size()), forwarded.data());
+    if (parseResult == ParseResult::ERROR_EXIT) {
+        return 1;
+    } else if (parseResult == ParseResult::INFO_EXIT) {
+        return 0;
+    }
+
+    std::vector<AudioSample> audio;
+    if (!loadAudio(options, audio)) {
+        return 1;
+    }
+
+    if (config.outputMode != OutputMode::QUIET && config.outputMode != OutputMode::JSON) {
+        std::cerr << "[LOG] Benchmarking with " << static_cast<double>(audio.size()) / SAMPLE_RATE
+                  << " s of " << (options.audioPath.empty() ? "synthetic audio" : options.audioPath.string())
+                  << ", " << config.wakeWordConfigs.size() << " wake word model(s)" << std::endl;
+    }
+
+    Bench bench(config, options, std::move(audio));
+    return bench.run() == 0 ? 0 : 1;
+}
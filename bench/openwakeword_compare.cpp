@@ -0,0 +1,318 @@
+// Accuracy check of reduced-precision models against FP32.
+//
+// Every reference recording is run through the FP32 embedding and wake word
+// models and through their INT8 or FP16 variants (<stem>_int8.onnx,
+// <stem>_fp16.onnx), both fed the same mel spectrograms. For the embeddings
+// and each wake word the mean and maximum absolute difference is reported,
+// along with the windows whose detection decision (score >= threshold)
+// differs. The exit status is 1 if any score differs by more than the
+// tolerance, so the check can gate a model release.
+//
+// Options other than the --compare-* ones are passed to the regular
+// openwakeword parser; reference recordings are given with --offline or
+// --file-list.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <onnxruntime_cxx_api.h>
+#include "core/mel_frontend.h"
+#include "core/model_wrapper.h"
+#include "core/offline_runner.h"
+#include "core/ort_environment.h"
+#include "core/types.h"
+#include "processors/audio_reader.h"
+#include "utils/config.h"
+#include "utils/kernels.h"
+
+using namespace openwakeword;
+
+namespace {
+
+struct CompareOptions {
+    ModelPrecision precision = ModelPrecision::INT8;
+    double tolerance = 0.05;  // Largest allowed score difference
+};
+
+// Absolute differences between reference and candidate outputs
+struct Difference {
+    std::string name;
+    uint64_t values = 0;
+    double sum = 0.0;
+    double max = 0.0;
+    uint64_t referencePositives = 0;  // Wake words: windows the FP32 model detects
+    uint64_t flipped = 0;             // Wake words: windows with a different decision
+
+    void add(float reference, float candidate) {
+        double diff = std::fabs(static_cast<double>(reference) - candidate);
+        sum += diff;
+        max = std::max(max, diff);
+        ++values;
+    }
+
+    double mean() const { return values > 0 ? sum / values : 0.0; }
+};
+
+void printUsage(const char* programName) {
+    std::cerr << "Usage: " << programName << " [COMPARE OPTIONS] --model MODEL --offline PATH [OPENWAKEWORD OPTIONS]" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "COMPARE OPTIONS:" << std::endl;
+    std::cerr << "  --compare-precision MODE      Variant compared with FP32: int8 or fp16 (default: int8)" << std::endl;
+    std::cerr << "  --compare-tolerance NUM       Largest allowed score difference (default: 0.05)" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "All other options are those of openwakeword (see openwakeword --help). Reference" << std::endl;
+    std::cerr << "recordings (16 kHz mono WAV) are given with --offline or --file-list. --json" << std::endl;
+    std::cerr << "prints one JSON object per model." << std::endl;
+}
+
+void printDifference(const Difference& diff, bool scores, bool json) {
+    if (json) {
+        std::cout << "{\"model\":\"" << diff.name << "\",\"values\":" << diff.values
+                  << ",\"mean_abs_diff\":" << diff.mean() << ",\"max_abs_diff\":" << diff.max;
+        if (scores) {
+            std::cout << ",\"reference_positives\":" << diff.referencePositives
+                      << ",\"flipped_decisions\":" << diff.flipped;
+        }
+        std::cout << "}" << std::endl;
+        return;
+    }
+
+    std::cout << std::left << std::setw(32) << diff.name << std::right
+              << std::setw(10) << diff.values
+              << std::setw(14) << std::scientific << std::setprecision(3) << diff.mean()
+              << std::setw(14) << diff.max << std::defaultfloat;
+    if (scores) {
+        std::cout << std::setw(12) << diff.referencePositives << std::setw(10) << diff.flipped;
+    }
+    std::cout << std::endl;
+}
+
+// One FP32 model and its variant
+template<typename Model>
+struct ModelPair {
+    std::unique_ptr<Model> reference;
+    std::unique_ptr<Model> candidate;
+};
+
+class Comparison {
+public:
+    Comparison(const Config& config, const CompareOptions& options)
+        : config_(config), options_(options),
+          ortEnvironment_(OrtEnvironment::acquire(config_)),
+          env_(ortEnvironment_->env()),
+          sessionOptions_(ortEnvironment_->createSessionOptions(config_)) {
+    }
+
+    bool initialize() {
+        melFrontend_ = createMelFrontend(config_, env_, sessionOptions_);
+        if (!melFrontend_) {
+            return false;
+        }
+
+        embedding_.reference = std::make_unique<EmbeddingModel>();
+        embedding_.candidate = std::make_unique<EmbeddingModel>();
+        if (!load(*embedding_.reference, *embedding_.candidate, config_.embModelPath)) {
+            return false;
+        }
+        embeddingDiff_.name = "embedding";
+
+        for (const auto& wwConfig : config_.wakeWordConfigs) {
+            auto wakeWord = wwConfig.name;
+            ModelPair<WakeWordModel> pair;
+            pair.reference = std::make_unique<WakeWordModel>(wakeWord);
+            pair.candidate = std::make_unique<WakeWordModel>(wakeWord);
+            if (!load(*pair.reference, *pair.candidate, wwConfig.modelPath)) {
+                return false;
+            }
+            wakeWords_.push_back(std::move(pair));
+            Difference diff;
+            diff.name = wakeWord;
+            scoreDiffs_.push_back(diff);
+        }
+        return true;
+    }
+
+    bool compareFile(const std::filesystem::path& file) {
+        MappedAudioReader reader(file.string());
+        if (!reader.isOpen()) {
+            std::cerr << "[ERROR] Failed to open " << file << std::endl;
+            return false;
+        }
+        if (reader.getSampleRate() != SAMPLE_RATE || reader.getChannels() != 1) {
+            std::cerr << "[ERROR] " << file.string() << ": expected 16 kHz mono" << std::endl;
+            return false;
+        }
+        auto samples = reader.samples();
+
+        // Mels as the pipeline computes them, one call per step of audio
+        const size_t frameSize = config_.frameSize;
+        std::vector<AudioFloat> audio(frameSize);
+        std::vector<AudioFloat> mels;
+        MelBuffer melOutput;
+        for (size_t offset = 0; offset + frameSize <= samples.size(); offset += frameSize) {
+            kernels::convertInt16ToFloat(samples.data() + offset, audio.data(), frameSize);
+            size_t frames = melFrontend_->computeMelSpectrogramBatch(audio.data(), 1, frameSize, melOutput);
+            mels.insert(mels.end(), melOutput.begin(), melOutput.begin() + frames * NUM_MELS);
+        }
+
+        // Embeddings of both models from the same mel windows
+        std::vector<AudioFloat> referenceFeatures;
+        std::vector<AudioFloat> candidateFeatures;
+        size_t melFrames = mels.size() / NUM_MELS;
+        for (size_t start = 0; start + EMBEDDING_WINDOW_SIZE <= melFrames; start += EMBEDDING_STEP_SIZE) {
+            const AudioFloat* window = mels.data() + start * NUM_MELS;
+            auto reference = embedding_.reference->extractEmbeddings(window);
+            referenceFeatures.insert(referenceFeatures.end(), reference.begin(), reference.end());
+            auto candidate = embedding_.candidate->extractEmbeddings(window);
+            candidateFeatures.insert(candidateFeatures.end(), candidate.begin(), candidate.end());
+        }
+        for (size_t i = 0; i < referenceFeatures.size(); ++i) {
+            embeddingDiff_.add(referenceFeatures[i], candidateFeatures[i]);
+        }
+
+        // Each model scores its own precision's features, as it would deployed
+        size_t embeddings = referenceFeatures.size() / EMBEDDING_FEATURES;
+        for (size_t m = 0; m < wakeWords_.size(); ++m) {
+            float threshold = config_.wakeWordConfigs[m].threshold;
+            auto& diff = scoreDiffs_[m];
+            for (size_t start = 0; start + WAKEWORD_FEATURES <= embeddings; ++start) {
+                float reference = wakeWords_[m].reference->predict(
+                    referenceFeatures.data() + start * EMBEDDING_FEATURES);
+                float candidate = wakeWords_[m].candidate->predict(
+                    candidateFeatures.data() + start * EMBEDDING_FEATURES);
+                diff.add(reference, candidate);
+                diff.referencePositives += reference >= threshold ? 1 : 0;
+                diff.flipped += (reference >= threshold) != (candidate >= threshold) ? 1 : 0;
+            }
+        }
+        return true;
+    }
+
+    // Print the differences; returns false if a score exceeds the tolerance
+    bool report() const {
+        bool json = config_.outputMode == OutputMode::JSON;
+        if (!json) {
+            std::cout << std::left << std::setw(32) << "model" << std::right
+                      << std::setw(10) << "values" << std::setw(14) << "mean diff"
+                      << std::setw(14) << "max diff" << std::setw(12) << "positives"
+                      << std::setw(10) << "flipped" << std::endl;
+        }
+        printDifference(embeddingDiff_, false, json);
+
+        bool withinTolerance = true;
+        for (const auto& diff : scoreDiffs_) {
+            printDifference(diff, true, json);
+            withinTolerance = withinTolerance && diff.max <= options_.tolerance;
+        }
+        return withinTolerance;
+    }
+
+private:
+    bool load(ModelWrapper& reference, ModelWrapper& candidate, const std::filesystem::path& path) {
+        auto variant = Config::modelVariant(path, options_.precision);
+        if (!std::filesystem::exists(variant)) {
+            std::cerr << "[ERROR] Reduced-precision variant not found: " << variant << std::endl;
+            return false;
+        }
+        if (!reference.loadModel(path, env_, sessionOptions_) ||
+            !candidate.loadModel(variant, env_, sessionOptions_)) {
+            return false;
+        }
+        if (config_.outputMode == OutputMode::VERBOSE) {
+            std::cerr << "[LOG] Comparing " << path << " with " << variant
+                      << (candidate.isHalfPrecision() ? " (FP16 tensors)" : "") << std::endl;
+        }
+        return true;
+    }
+
+    Config config_;
+    CompareOptions options_;
+    std::shared_ptr<OrtEnvironment> ortEnvironment_;
+    Ort::Env& env_;
+    Ort::SessionOptions sessionOptions_;
+
+    std::unique_ptr<MelFrontend> melFrontend_;
+    ModelPair<EmbeddingModel> embedding_;
+    std::vector<ModelPair<WakeWordModel>> wakeWords_;
+    Difference embeddingDiff_;
+    std::vector<Difference> scoreDiffs_;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    CompareOptions options;
+
+    // Split off the comparison options; the rest go to the regular parser
+    std::vector<char*> forwarded = {argv[0]};
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--compare-precision" && hasValue) {
+            std::string precision = argv[++i];
+            if (precision == "int8") {
+                options.precision = ModelPrecision::INT8;
+            } else if (precision == "fp16") {
+                options.precision = ModelPrecision::FP16;
+            } else {
+                std::cerr << "[ERROR] Compare precision must be int8 or fp16: " << precision << std::endl;
+                return 1;
+            }
+        } else if (arg == "--compare-tolerance" && hasValue) {
+            options.tolerance = std::atof(argv[++i]);
+        } else if (arg.rfind("--compare-", 0) == 0) {
+            std::cerr << "[ERROR] Missing value for " << arg << std::endl;
+            return 1;
+        } else if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            forwarded.push_back(argv[i]);
+        }
+    }
+
+    Config config;
+    ParseResult parseResult = config.parseArgs(static_cast<int>(forwarded.size()), forwarded.data());
+    if (parseResult == ParseResult::ERROR_EXIT) {
+        return 1;
+    } else if (parseResult == ParseResult::INFO_EXIT) {
+        return 0;
+    }
+    if (config.modelPrecision != ModelPrecision::FP32) {
+        std::cerr << "[ERROR] Give the FP32 models and select the variant with --compare-precision"
+                  << std::endl;
+        return 1;
+    }
+
+    std::vector<std::filesystem::path> files;
+    if (!OfflineRunner::collectInputs(config, files)) {
+        return 1;
+    }
+    if (files.empty()) {
+        std::cerr << "[ERROR] No reference recordings given (use --offline or --file-list)" << std::endl;
+        return 1;
+    }
+
+    Comparison comparison(config, options);
+    if (!comparison.initialize()) {
+        return 1;
+    }
+    size_t failed = 0;
+    for (const auto& file : files) {
+        failed += comparison.compareFile(file) ? 0 : 1;
+    }
+    if (failed > 0 && config.outputMode != OutputMode::QUIET) {
+        std::cerr << "[WARNING] " << failed << " file(s) could not be compared" << std::endl;
+    }
+
+    bool withinTolerance = comparison.report();
+    if (!withinTolerance && config.outputMode != OutputMode::QUIET) {
+        std::cerr << "[WARNING] Score difference exceeds the tolerance of " << options.tolerance << std::endl;
+    }
+    return withinTolerance ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+#ifndef OPENWAKEWORD_API_H
+#define OPENWAKEWORD_API_H
+
+/*
+ * Stable C interface to the wake word pipeline, for embedding detection in
+ * another process without piping audio through the openwakeword program.
+ * Audio is pushed by pointer and detections are delivered to a callback;
+ * nothing is written to stdout.
+ *
+ * Typical use:
+ *
+ *   const char* args[] = {"--model", "models/alexa_v0.1.onnx"};
+ *   oww_detector* detector = oww_create(2, args, on_detection, context);
+ *   while (capturing) oww_push_samples(detector, pcm, count);
+ *   oww_destroy(detector);
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(OPENWAKEWORD_BUILDING_LIBRARY)
+#    define OWW_API __declspec(dllexport)
+#  elif defined(OPENWAKEWORD_SHARED)
+#    define OWW_API __declspec(dllimport)
+#  else
+#    define OWW_API
+#  endif
+#else
+#  define OWW_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Opaque handle to a running pipeline */
+typedef struct oww_detector oww_detector;
+
+/* One detection; the strings are only valid during the callback */
+typedef struct oww_detection {
+    const char* wake_word;  /* Model name, e.g. "alexa_v0.1" */
+    float score;            /* Probability that triggered the detection */
+    uint64_t window_index;  /* Windows this model had scored before, one per 80 ms step */
+} oww_detection;
+
+/*
+ * Called on a pipeline thread for every detection. Calls never overlap, but
+ * the callback must return quickly: scoring waits while it runs.
+ */
+typedef void (*oww_detection_callback)(const oww_detection* detection, void* user_data);
+
+/* Library version, e.g. "1.0.0" */
+OWW_API const char* oww_version(void);
+
+/*
+ * Load the models and start the pipeline. argv holds openwakeword command
+ * line options without the program name (see openwakeword --help), e.g.
+ * {"--model", "alexa.onnx", "--threshold", "0.6"}. Logging is quiet unless
+ * --verbose is given; errors are reported on stderr. Returns NULL on
+ * failure.
+ */
+OWW_API oww_detector* oww_create(int argc, const char* const* argv,
+                                 oww_detection_callback callback, void* user_data);
+
+/*
+ * Queue count 16 kHz mono 16-bit samples. Chunks of any size are accepted;
+ * blocks only while the pipeline is behind. Call from one thread at a time.
+ * Returns 0 on success, -1 if the detector is stopped or invalid.
+ */
+OWW_API int oww_push_samples(oww_detector* detector, const int16_t* samples, size_t count);
+
+/* Score the queued audio, stop the pipeline and free the detector */
+OWW_API void oww_destroy(oww_detector* detector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OPENWAKEWORD_API_H */
@@ -2,6 +2,7 @@
 #define OPENWAKEWORD_AUDIO_PROCESSOR_H
 
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 #include "types.h"
@@ -57,20 +58,8 @@ protected:
     std::shared_ptr<std::vector<OutputType>> outputBuffer_;
 };
 
-// Interface for preprocessors (noise suppression, VAD, etc.)
-class Preprocessor {
-public:
-    virtual ~Preprocessor() = default;
-    
-    // Process audio frame in-place
-    virtual void process(AudioFrame& frame) = 0;
-    
-    // Check if preprocessor is enabled
-    virtual bool isEnabled() const = 0;
-    
-    // Get preprocessor name
-    virtual const std::string& getName() const = 0;
-};
+// Preprocessors (noise suppression, VAD, etc.) implement the Preprocessor
+// interface in preprocessors/preprocessor.h
 
 // Interface for postprocessors (custom verifiers, etc.)
 class Postprocessor {
@@ -80,6 +69,15 @@ public:
     // Process detection result
     virtual Detection process(const Detection& detection, const FeatureBuffer& features) = 0;
     
+    // Process the detections one batch of output holds, in place, where
+    // features[i] belongs to detections[i]. Override to score them together.
+    virtual void processBatch(std::span<Detection* const> detections,
+                              std::span<const FeatureBuffer* const> features) {
+        for (size_t i = 0; i < detections.size(); ++i) {
+            *detections[i] = process(*detections[i], *features[i]);
+        }
+    }
+    
     // Check if postprocessor should be applied to this detection
     virtual bool shouldProcess(const Detection& detection) const = 0;
     
@@ -0,0 +1,182 @@
+#ifndef OPENWAKEWORD_BROADCAST_RING_BUFFER_H
+#define OPENWAKEWORD_BROADCAST_RING_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "core/sliding_window.h"
+#include "core/spsc_ring_buffer.h"
+#include "core/types.h"
+
+namespace openwakeword {
+
+// Single-writer/multi-reader ring of fixed-size frames. Every reader owns a
+// cursor and reads frames in place, so publishing a frame costs the same no
+// matter how many readers there are. A slot is reused only once every reader
+// cursor has moved past it.
+//
+// Frames live in a MirroredRing, so any window of up to capacity frames is
+// contiguous in memory and can be handed to a model without copying.
+template<typename T>
+class BroadcastRingBuffer {
+public:
+    BroadcastRingBuffer(size_t frameSize, size_t capacityFrames,
+                        WaitPolicy waitPolicy = WaitPolicy::BLOCKING)
+        : frameSize_(frameSize),
+          capacity_(std::max<size_t>(capacityFrames, 1)),
+          waitPolicy_(waitPolicy),
+          frames_(frameSize_, capacity_) {}
+
+    BroadcastRingBuffer(const BroadcastRingBuffer&) = delete;
+    BroadcastRingBuffer& operator=(const BroadcastRingBuffer&) = delete;
+
+    // Register a reader before the writer starts; returns the reader id
+    size_t addReader() {
+        readers_.push_back(std::make_unique<Reader>());
+        return readers_.size() - 1;
+    }
+
+    size_t numReaders() const { return readers_.size(); }
+    size_t frameSize() const { return frameSize_; }
+    size_t capacity() const { return capacity_; }
+
+    // Writer side: publish one frame, waiting while the slowest reader
+    // still needs the slot it would overwrite
+    void push(const T* frame) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - cachedMinCursor_ >= capacity_) {
+            cachedMinCursor_ = minCursor();
+            if (head - cachedMinCursor_ >= capacity_ &&
+                !waitUntil(spaceSignal_, [this, head] {
+                    cachedMinCursor_ = minCursor();
+                    return head - cachedMinCursor_ < capacity_;
+                })) {
+                return;  // Exhausted while waiting
+            }
+        }
+
+        frames_.write(head, frame);
+
+        head_.store(head + 1, std::memory_order_release);
+        signal(dataSignal_);
+    }
+
+    // Publish several consecutive frames
+    void push(const T* frames, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            push(frames + i * frameSize_);
+        }
+    }
+
+    // Reader side: wait until windowFrames frames starting at the reader's
+    // cursor are available. Returns a pointer to the contiguous window, or
+    // nullptr once the buffer is exhausted without a complete window.
+    const T* waitForWindow(size_t reader, size_t windowFrames) {
+        const size_t cursor = readers_[reader]->cursor.load(std::memory_order_relaxed);
+        auto ready = [this, cursor, windowFrames] {
+            return head_.load(std::memory_order_acquire) >= cursor + windowFrames;
+        };
+        if (!ready() && !waitUntil(dataSignal_, ready) && !ready()) {
+            return nullptr;
+        }
+        return frames_.at(cursor);
+    }
+
+    // Number of frames published past the reader's cursor
+    size_t available(size_t reader) const {
+        return head_.load(std::memory_order_acquire) -
+               readers_[reader]->cursor.load(std::memory_order_relaxed);
+    }
+
+    // Release frames at the front of the reader's window
+    void advance(size_t reader, size_t frames = 1) {
+        readers_[reader]->cursor.fetch_add(frames, std::memory_order_release);
+        signal(spaceSignal_);
+    }
+
+    void setExhausted(bool exhausted) {
+        exhausted_.store(exhausted, std::memory_order_release);
+        signal(dataSignal_);
+        signal(spaceSignal_);
+    }
+
+    bool isExhausted() const {
+        return exhausted_.load(std::memory_order_acquire);
+    }
+
+    // Frames held for the slowest reader
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - minCursor();
+    }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr int SPIN_ITERATIONS = 256;
+
+    struct Reader {
+        alignas(CACHE_LINE) std::atomic<size_t> cursor{0};
+    };
+
+    const size_t frameSize_;
+    const size_t capacity_;
+    const WaitPolicy waitPolicy_;
+    MirroredRing<T> frames_;
+    std::vector<std::unique_ptr<Reader>> readers_;
+
+    alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+    size_t cachedMinCursor_ = 0;
+
+    alignas(CACHE_LINE) std::atomic<uint32_t> dataSignal_{0};
+    alignas(CACHE_LINE) std::atomic<uint32_t> spaceSignal_{0};
+    std::atomic<bool> exhausted_{false};
+
+    size_t minCursor() const {
+        if (readers_.empty()) {
+            return head_.load(std::memory_order_relaxed);
+        }
+        size_t result = std::numeric_limits<size_t>::max();
+        for (const auto& reader : readers_) {
+            result = std::min(result, reader->cursor.load(std::memory_order_acquire));
+        }
+        return result;
+    }
+
+    void signal(std::atomic<uint32_t>& counter) {
+        counter.fetch_add(1, std::memory_order_release);
+        if (waitPolicy_ == WaitPolicy::BLOCKING) {
+            counter.notify_all();
+        }
+    }
+
+    template<typename Predicate>
+    bool waitUntil(std::atomic<uint32_t>& counter, Predicate ready) {
+        int spins = 0;
+        while (true) {
+            uint32_t seen = counter.load(std::memory_order_acquire);
+            if (ready()) {
+                return true;
+            }
+            if (exhausted_.load(std::memory_order_acquire)) {
+                return false;
+            }
+
+            if (waitPolicy_ == WaitPolicy::BLOCKING) {
+                counter.wait(seen, std::memory_order_acquire);
+            } else if (++spins < SPIN_ITERATIONS) {
+                cpuRelax();
+            } else {
+                spins = 0;
+                std::this_thread::yield();
+            }
+        }
+    }
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_BROADCAST_RING_BUFFER_H
@@ -0,0 +1,132 @@
+#ifndef OPENWAKEWORD_DETECTION_COLLECTOR_H
+#define OPENWAKEWORD_DETECTION_COLLECTOR_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/audio_processor.h"
+#include "core/mpsc_queue.h"
+#include "core/types.h"
+#include "utils/config.h"
+#include "utils/metrics.h"
+
+namespace openwakeword {
+
+// Compact record posted by a detector thread
+struct DetectionEvent {
+    enum class Type : uint8_t {
+        SCORE,      // Debug/verbose trace of one prediction
+        DETECTION   // Trigger level reached
+    };
+
+    Type type = Type::SCORE;
+    uint32_t detector = 0;   // Id from DetectionCollector::addDetector
+    float score = 0.0f;
+    uint64_t window = 0;     // Windows the detector had scored before this one
+    FeatureBuffer features;  // Detections only: the scored window, for postprocessors
+};
+
+// Takes detection output off the inference threads. Detectors post events
+// into a lock-free queue; one collector thread applies the postprocessors,
+// then formats and writes detections (or hands them to a callback) and
+// debug scores, taking the output mutex once per batch of events.
+class DetectionCollector {
+public:
+    DetectionCollector(std::mutex& outputMutex, OutputMode outputMode, bool showTimestamp,
+                       size_t capacity = 1024);
+    ~DetectionCollector();
+
+    DetectionCollector(const DetectionCollector&) = delete;
+    DetectionCollector& operator=(const DetectionCollector&) = delete;
+
+    // Setup, before start(): returns the id a detector posts with. A
+    // detector whose triggers are only candidates (deferRefractory) passes
+    // its refractory steps; accepted detections then start the refractory
+    // period here, in windows, and candidates inside it are dropped before
+    // any postprocessor sees them.
+    uint32_t addDetector(const std::string& name, int refractorySteps = 0);
+
+    // Applied in order to every detection, each to all detections of a batch
+    // at once; a postprocessor rejects one by clearing Detection::accepted.
+    // Not owned.
+    void setPostprocessors(const std::vector<std::unique_ptr<Postprocessor>>* postprocessors) {
+        postprocessors_ = postprocessors;
+    }
+
+    // Whether detections need their window features, which only
+    // postprocessors (custom verifiers among them) read
+    bool wantsFeatures() const { return postprocessors_ && !postprocessors_->empty(); }
+
+    // Deliver detections here instead of stdout
+    void setCallback(DetectionCallback callback) { callback_ = std::move(callback); }
+
+    // Time detections from their audio to their output
+    void setMetrics(Metrics* metrics) { metrics_ = metrics; }
+
+    void start();
+
+    // Deliver everything posted so far, then stop the thread
+    void stop();
+
+    // Any thread, lock-free. Score events are dropped when the queue is
+    // full; detections wait for space.
+    void post(DetectionEvent&& event);
+
+    // Score events dropped because the collector fell behind
+    uint64_t getDroppedScores() const { return droppedScores_.load(std::memory_order_relaxed); }
+
+private:
+    std::mutex& outputMutex_;
+    OutputMode outputMode_;
+    bool showTimestamp_;
+
+    MpscQueue<DetectionEvent> queue_;
+    std::vector<std::string> names_;
+
+    // Per detector: deferred refractory steps, and the first window after
+    // the last accepted detection's refractory period
+    std::vector<int> refractorySteps_;
+    std::vector<uint64_t> refractoryEnd_;
+    const std::vector<std::unique_ptr<Postprocessor>>* postprocessors_ = nullptr;
+    DetectionCallback callback_;
+    Metrics* metrics_ = nullptr;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint32_t> signal_{0};  // Bumped on every post
+    std::atomic<uint64_t> droppedScores_{0};
+
+    struct Output {
+        DetectionEvent::Type type;
+        uint32_t detector;
+        Detection detection;
+        FeatureBuffer features;
+    };
+    std::vector<Output> pending_;  // Batch being delivered, reused
+
+    // Detections of the batch one postprocessor applies to, reused
+    std::vector<Detection*> batchDetections_;
+    std::vector<const FeatureBuffer*> batchFeatures_;
+
+    // Rounds of the batch through the postprocessors, reused: indices into
+    // pending_ in this round, which are settled, and per detector whether
+    // it has a candidate in this round
+    std::vector<size_t> round_;
+    std::vector<uint8_t> settled_;
+    std::vector<uint8_t> inRound_;
+
+    void run();
+
+    // Run the postprocessors on the accepted detections of round_
+    void postprocess();
+
+    // Deliver a batch of queued events; returns false if there were none
+    bool drain();
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_DETECTION_COLLECTOR_H
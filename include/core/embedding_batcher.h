@@ -0,0 +1,89 @@
+#ifndef OPENWAKEWORD_EMBEDDING_BATCHER_H
+#define OPENWAKEWORD_EMBEDDING_BATCHER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "core/model_wrapper.h"
+#include "core/types.h"
+
+namespace openwakeword {
+
+// Dynamic batcher in front of the embedding model. Callers submit mel windows
+// from any thread and block until their embeddings are written. A dedicated
+// thread gathers pending windows across callers and runs one batched
+// inference once maxBatchSize windows are queued, maxWait has passed since
+// the oldest pending submission, or every producer is waiting.
+class EmbeddingBatcher {
+public:
+    EmbeddingBatcher(EmbeddingModel& model, size_t maxBatchSize,
+                     std::chrono::microseconds maxWait, size_t producers);
+    ~EmbeddingBatcher();
+
+    // Start/stop the batching thread
+    void start();
+    void stop();
+
+    // Compute embeddings for count mel windows (EMBEDDING_WINDOW_SIZE x
+    // NUM_MELS floats each). output receives count x EMBEDDING_FEATURES
+    // floats. The windows must stay valid until the call returns.
+    void submit(const AudioFloat* const* windows, size_t count, AudioFloat* output);
+
+    // Batches run and windows processed so far
+    size_t getBatchCount() const { return batchCount_; }
+    size_t getWindowCount() const { return windowCount_; }
+
+private:
+    struct Request {
+        const AudioFloat* const* windows;
+        size_t count;
+        AudioFloat* output;
+        size_t taken = 0;      // Windows handed to a batch
+        size_t completed = 0;  // Windows whose embeddings are written
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    // A window in the batch being run, and where its result goes
+    struct Slot {
+        Request* request;
+        size_t index;
+    };
+
+    EmbeddingModel& model_;
+    size_t maxBatchSize_;
+    std::chrono::microseconds maxWait_;
+    size_t producers_;
+
+    std::mutex mutex_;
+    std::condition_variable pendingCv_;
+    std::condition_variable doneCv_;
+    std::deque<Request*> pending_;
+    size_t pendingWindows_ = 0;
+    bool running_ = false;
+    std::thread thread_;
+
+    // Batch buffers, only touched by the batching thread
+    std::vector<const AudioFloat*> batchWindows_;
+    std::vector<Slot> batchSlots_;
+    std::vector<AudioFloat> batchInput_;
+    FeatureBuffer batchOutput_;
+
+    std::atomic<size_t> batchCount_{0};
+    std::atomic<size_t> windowCount_{0};
+
+    void batchLoop();
+
+    // Check if the next batch should run now; caller holds mutex_
+    bool batchReady(std::chrono::steady_clock::time_point now) const;
+
+    // Run inference on the given windows directly when not batching
+    void runDirect(const AudioFloat* const* windows, size_t count, AudioFloat* output);
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_EMBEDDING_BATCHER_H
@@ -0,0 +1,95 @@
+#ifndef OPENWAKEWORD_EMBEDDING_CACHE_H
+#define OPENWAKEWORD_EMBEDDING_CACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include "core/types.h"
+#include "utils/config.h"
+#include "utils/mapped_file.h"
+
+namespace openwakeword {
+
+// Source audio and settings a cache entry was computed from. An entry is
+// replayed only if its key matches exactly.
+struct EmbeddingCacheKey {
+    uint64_t sourceSize = 0;
+    int64_t sourceModified = 0;
+    uint64_t embeddingModelSize = 0;
+    int64_t embeddingModelModified = 0;
+    uint64_t melModelSize = 0;       // Mel model, when it computes the mels
+    int64_t melModelModified = 0;
+    uint32_t frameSize = 0;      // Samples per detection frame index
+    uint32_t melFrontend = 0;    // MelFrontendType
+    uint32_t streamingMel = 0;
+    int32_t inputChannel = -1;   // Selected input channel; -1 if downmixed
+
+    bool operator==(const EmbeddingCacheKey&) const = default;
+
+    // Key of source scored with config; returns false if the source or a
+    // model it depends on is missing
+    static bool make(const std::filesystem::path& source, size_t frameSize,
+                     const Config& config, EmbeddingCacheKey& key);
+};
+
+// On-disk cache of every speech embedding of one audio file, so a corpus can
+// be rescored against new wake word models or thresholds without the mel and
+// embedding stages. One file per source, named after a hash of its path,
+// holding a fixed header followed by the EMBEDDING_FEATURES floats of each
+// embedding in order (host byte order). Embedding k covers mel frames
+// [k * EMBEDDING_STEP_SIZE, k * EMBEDDING_STEP_SIZE + EMBEDDING_WINDOW_SIZE).
+// Returns the cache file for source inside cacheDir.
+std::filesystem::path embeddingCachePath(const std::filesystem::path& cacheDir,
+                                         const std::filesystem::path& source);
+
+// Memory-mapped cache entry; embeddings are read in place
+class EmbeddingCacheReader {
+public:
+    // Map path; returns false if it is missing, truncated or its key differs
+    bool open(const std::filesystem::path& path, const EmbeddingCacheKey& key);
+
+    // Number of embeddings
+    size_t size() const { return embeddings_.size() / EMBEDDING_FEATURES; }
+
+    // Embedding at frame offset index, EMBEDDING_FEATURES floats
+    const AudioFloat* embedding(size_t index) const {
+        return embeddings_.data() + index * EMBEDDING_FEATURES;
+    }
+
+    // Mel frames per detection frame index and source samples scored
+    size_t framesPerRow() const { return framesPerRow_; }
+    size_t sourceSamples() const { return sourceSamples_; }
+
+private:
+    MappedFile mapping_;
+    std::span<const AudioFloat> embeddings_;
+    size_t framesPerRow_ = 0;
+    size_t sourceSamples_ = 0;
+};
+
+// Writes a cache entry alongside scoring. The entry appears under its final
+// name only on commit(), so interrupted runs never leave partial entries.
+class EmbeddingCacheWriter {
+public:
+    ~EmbeddingCacheWriter();
+
+    bool open(const std::filesystem::path& path, const EmbeddingCacheKey& key);
+    void append(const AudioFloat* embeddings, size_t count);
+
+    // Finish the entry; returns false if anything failed to write
+    bool commit(size_t framesPerRow, size_t sourceSamples);
+
+private:
+    std::filesystem::path path_;
+    std::filesystem::path tempPath_;
+    std::ofstream file_;
+    EmbeddingCacheKey key_;
+    uint64_t count_ = 0;
+
+    void discard();
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_EMBEDDING_CACHE_H
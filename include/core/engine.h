@@ -0,0 +1,183 @@
+#ifndef OPENWAKEWORD_ENGINE_H
+#define OPENWAKEWORD_ENGINE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/embedding_batcher.h"
+#include "core/model_wrapper.h"
+#include "core/ort_environment.h"
+#include "core/sliding_window.h"
+#include "core/spsc_ring_buffer.h"
+#include "core/types.h"
+#include "processors/audio_converter.h"
+#include "processors/wake_word_detector.h"
+#include "utils/config.h"
+
+namespace openwakeword {
+
+class Engine;
+
+// Per-stream state for the multi-stream engine. Everything a stream carries
+// between steps lives here; the models themselves are shared by all streams.
+// In mic array mode the stream opened for an input is channel 0 and owns one
+// stream per further channel; all of them take the same interleaved audio,
+// each keeping only its own channel.
+class StreamContext {
+public:
+    // channel selects one channel of interleaved input (mic array mode)
+    StreamContext(size_t id, const std::string& name, const Config& config, int channel = -1);
+
+    size_t getId() const { return id_; }
+    const std::string& getName() const { return name_; }
+
+    // Check if the stream was closed and all of its audio processed
+    bool isFinished() const { return finished_.load(std::memory_order_acquire); }
+
+private:
+    friend class Engine;
+
+    size_t id_;
+    std::string name_;
+
+    // Input format conversion, run by the producer thread when the input is
+    // not 16 kHz mono
+    std::unique_ptr<AudioConverter> converter_;
+
+    // Audio from the producer thread, converted to float
+    SpscRingBuffer<AudioFloat> input_;
+
+    // STFT context carried between groups with config.streamingMel
+    std::vector<AudioFloat> melContext_;
+
+    // Mel residue and embedding history between steps
+    SlidingWindow<AudioFloat> mels_;
+    SlidingWindow<AudioFloat> features_;
+
+    // Activation counters, one per wake word model; for a mic array, those
+    // of channel 0 take the fused scores
+    std::vector<ActivationTracker> activations_;
+
+    // Channels 1 and up of a mic array, scheduled with this stream
+    std::vector<std::shared_ptr<StreamContext>> channels_;
+
+    // Scheduling state; a claimed stream is being processed by one worker
+    std::atomic<bool> claimed_{false};
+    std::atomic<bool> closed_{false};
+    std::atomic<bool> finished_{false};
+};
+
+// Multi-tenant wake word engine: one set of read-only sessions serves many
+// concurrent audio streams. A worker pool picks up every stream with a full
+// frame of audio and runs each stage (mel, embedding, every wake word model)
+// as one batched inference call across those streams; ONNX mels, whose dB
+// floor spans the batch, are one call per stream. Embedding windows from
+// all workers are further merged by a shared EmbeddingBatcher. The channels
+// of a mic array are always claimed together, so they share those calls,
+// and their scores are fused (see ChannelFusion) before triggering.
+class Engine {
+public:
+    explicit Engine(const Config& config);
+    ~Engine();
+
+    // Load all models
+    bool initialize();
+
+    // Start/stop the worker pool
+    void start();
+    void stop();
+
+    // Register a new stream, or a mic array of config.inputChannels streams
+    std::shared_ptr<StreamContext> openStream(const std::string& name);
+
+    // Feed audio in the configured input format to a stream; must be called
+    // from a single thread per stream
+    void pushAudio(StreamContext& stream, const AudioSample* samples, size_t sampleCount);
+
+    // Non-blocking variant for event loops: pushes what fits and returns
+    // the number of samples taken
+    size_t tryPushAudio(StreamContext& stream, const AudioSample* samples, size_t sampleCount);
+
+    // Input samples a stream (every channel of a mic array) can take
+    // without waiting
+    size_t pushSpace(const StreamContext& stream) const;
+
+    // Mark the end of a stream's audio; it is dropped once fully processed
+    void closeStream(StreamContext& stream);
+
+    // Block until every opened stream is closed and processed
+    void waitForStreams();
+
+    bool isRunning() const { return running_; }
+
+private:
+    // Reusable per-worker buffers so steady-state batches do not reallocate
+    struct WorkerScratch {
+        std::vector<std::shared_ptr<StreamContext>> streams;
+        std::vector<AudioFloat> melInput;
+        std::vector<size_t> melRows;
+        MelBuffer melOutput;
+        std::vector<const AudioFloat*> windows;
+        std::vector<size_t> windowCounts;
+        std::vector<AudioFloat> batchInput;
+        FeatureBuffer embeddings;
+        std::vector<float> scores;  // Per model, then per window
+        std::vector<size_t> channelWindows;  // First window of each channel of a stream
+    };
+
+    Config config_;
+    std::shared_ptr<OrtEnvironment> ortEnvironment_;
+    Ort::Env& env_;
+    Ort::SessionOptions sessionOptions_;
+
+    // Per-model execution providers; sessionOptions_ is the CPU fallback
+    ModelSessionOptions melOptions_;
+    ModelSessionOptions embeddingOptions_;
+    std::vector<ModelSessionOptions> wakeWordOptions_;
+
+    // Shared sessions
+    std::unique_ptr<MelFrontend> melFrontend_;
+    std::unique_ptr<EmbeddingModel> embeddingModel_;
+    std::vector<std::unique_ptr<WakeWordModel>> wakeWordModels_;
+    std::vector<std::string> wakeWordNames_;
+    
+    // Batches embedding windows across all workers
+    std::unique_ptr<EmbeddingBatcher> embeddingBatcher_;
+
+    // Streams and scheduling
+    std::mutex streamsMutex_;
+    std::condition_variable workCv_;
+    std::condition_variable finishedCv_;
+    std::vector<std::shared_ptr<StreamContext>> streams_;
+    size_t nextStreamId_ = 0;
+
+    std::vector<std::thread> workers_;
+    std::vector<WorkerScratch> scratch_;
+    std::mutex outputMutex_;
+    std::atomic<bool> running_{false};
+
+    void workerLoop(size_t workerIndex);
+
+    // Claim up to maxBatchSize ready streams; caller holds streamsMutex_
+    void claimReadyStreams(std::vector<std::shared_ptr<StreamContext>>& batch);
+
+    // Push converted audio to one stream's ring, waiting or not
+    void pushChannel(StreamContext& stream, std::span<const AudioSample> samples);
+    size_t tryPushChannel(StreamContext& stream, std::span<const AudioSample> samples);
+
+    // Run one batched step over the claimed streams
+    void processBatch(WorkerScratch& scratch);
+    void runStreamingMelStage(WorkerScratch& scratch);
+    void runEmbeddingStage(WorkerScratch& scratch);
+    void runWakeWordStage(WorkerScratch& scratch);
+
+    void notifyWorkers();
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_ENGINE_H
@@ -0,0 +1,129 @@
+#ifndef OPENWAKEWORD_MEL_FRONTEND_H
+#define OPENWAKEWORD_MEL_FRONTEND_H
+
+#include <complex>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+#include <onnxruntime_cxx_api.h>
+#include "core/types.h"
+
+namespace openwakeword {
+
+struct Config;
+
+// Mel spectrogram computation, implemented by the melspectrogram.onnx model
+// and by the native frontend. Output is rescaled for the embedding model.
+class MelFrontend {
+public:
+    virtual ~MelFrontend() = default;
+
+    // Prepare for repeated calls with frameSize samples
+    virtual bool prepare(size_t frameSize) = 0;
+
+    // Compute mel spectrogram from count contiguous samples. The result is
+    // valid until the next call; not thread-safe.
+    virtual std::span<const AudioFloat> computeMelSpectrogram(const AudioFloat* samples,
+                                                              size_t count) = 0;
+
+    // Thread-safe batched computation over batch rows of count contiguous
+    // samples. Writes mels row after row to out and returns the number of mel
+    // frames per row.
+    virtual size_t computeMelSpectrogramBatch(const AudioFloat* samples, size_t batch,
+                                              size_t count, MelBuffer& out) = 0;
+
+    virtual const char* getFrontendName() const = 0;
+};
+
+// Native C++ replacement for melspectrogram.onnx: 512-point STFT with a
+// 400-sample periodic Hann window (zero-padded to 512), hop of 160 samples,
+// no padding, power spectrum, 32-band Slaney mel filterbank (60-3800 Hz),
+// 10*log10 clipped at 1e-10, floored 80 dB below the maximum. Unlike the
+// ONNX graph, whose floor is taken over the whole batch tensor, each batch
+// row is floored on its own, exactly as if it were computed alone.
+class NativeMelFrontend : public MelFrontend {
+public:
+    NativeMelFrontend();
+
+    bool prepare(size_t frameSize) override;
+    std::span<const AudioFloat> computeMelSpectrogram(const AudioFloat* samples,
+                                                      size_t count) override;
+    size_t computeMelSpectrogramBatch(const AudioFloat* samples, size_t batch,
+                                      size_t count, MelBuffer& out) override;
+    const char* getFrontendName() const override { return "native"; }
+
+    // Number of mel frames produced for count samples
+    static size_t numFrames(size_t count);
+
+    static constexpr size_t FFT_SIZE = MEL_WINDOW_SAMPLES;
+    static constexpr size_t WINDOW_LENGTH = 400;
+    static constexpr size_t NUM_BINS = FFT_SIZE / 2 + 1;
+
+private:
+    // Nonzero span of one triangular mel filter
+    struct MelFilter {
+        size_t firstBin;
+        std::vector<double> weights;
+    };
+
+    std::vector<double> window_;
+    std::vector<MelFilter> filters_;
+
+    // Half-size complex FFT tables
+    std::vector<std::complex<double>> twiddles_;
+    std::vector<std::complex<double>> splitTwiddles_;
+    std::vector<size_t> bitReverse_;
+
+    MelBuffer melOutput_;
+
+    // Mels of one row in dB, before the floor; returns the row maximum
+    float computeRow(const AudioFloat* samples, size_t frames, AudioFloat* out) const;
+
+    // Power spectrum of one windowed frame
+    void powerSpectrum(const AudioFloat* frame, double* power) const;
+};
+
+// Streaming mel computation that keeps the STFT context across calls, so
+// input of any chunk size yields exactly one mel frame per 10 ms hop with no
+// frames lost at chunk boundaries. Mels are emitted in groups of
+// EMBEDDING_STEP_SIZE hops (80 ms, one embedding step); each group is one
+// frontend call, so the dB floor spans one group regardless of chunking.
+class MelStreamer {
+public:
+    static constexpr size_t CONTEXT_SAMPLES = MEL_WINDOW_SAMPLES - MEL_HOP_SAMPLES;
+    static constexpr size_t GROUP_SAMPLES = EMBEDDING_STEP_SIZE * MEL_HOP_SAMPLES;
+    static constexpr size_t INPUT_SAMPLES = CONTEXT_SAMPLES + GROUP_SAMPLES;
+
+    explicit MelStreamer(MelFrontend& frontend);
+
+    // Feed count samples. Mels of every completed group replace the contents
+    // of out; returns the number of mel frames written.
+    size_t process(const AudioFloat* samples, size_t count, MelBuffer& out);
+
+    // Forget buffered audio; the next group starts from silent context
+    void reset();
+
+private:
+    MelFrontend& frontend_;
+    std::vector<AudioFloat> window_;  // Context followed by the group being filled
+    size_t fill_ = CONTEXT_SAMPLES;
+};
+
+// Create the frontend selected by config.melFrontend. With config.verifyMel,
+// a native frontend is first compared against the ONNX model and rejected if
+// any output differs by more than config.melTolerance. Returns nullptr on
+// failure. cpuFallback is used as in ModelWrapper::loadModel.
+std::unique_ptr<MelFrontend> createMelFrontend(const Config& config, Ort::Env& env,
+                                               const Ort::SessionOptions& options,
+                                               const Ort::SessionOptions* cpuFallback = nullptr);
+
+// Compare a frontend against the ONNX model on a deterministic test signal.
+// Returns false if the maximum absolute difference exceeds tolerance.
+bool verifyMelFrontend(MelFrontend& frontend, const std::filesystem::path& referenceModel,
+                       Ort::Env& env, const Ort::SessionOptions& options,
+                       float tolerance, float& maxError);
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_MEL_FRONTEND_H
@@ -0,0 +1,74 @@
+#ifndef OPENWAKEWORD_MODEL_LOADER_H
+#define OPENWAKEWORD_MODEL_LOADER_H
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <onnxruntime_cxx_api.h>
+#include "utils/config.h"
+
+namespace openwakeword {
+
+// On-disk cache of models after ONNX Runtime graph optimization, so later
+// runs skip the optimizer. Entries are keyed by a hash of the model bytes,
+// the ORT version and the optimization level; any change to one of them
+// yields a new entry. Level ALL is saved at EXTENDED, and its layout passes
+// for the host CPU run at load, so a cache can be shared between hosts. The
+// cache is process-wide like the ORT environment.
+class OptimizedModelCache {
+public:
+    // Use directory for cached models at level; an empty path disables the cache
+    static void configure(const std::filesystem::path& directory, GraphOptimization level);
+    static bool isEnabled();
+
+    // Create a session for modelPath. With the cache enabled the optimized
+    // copy is loaded when present, otherwise it is written while the
+    // session is created. Sessions on hardware execution providers bypass
+    // the cache, as their optimized graphs only run on that provider.
+    // Throws Ort::Exception like the Ort::Session constructor.
+    static std::shared_ptr<Ort::Session> createSession(const std::filesystem::path& modelPath,
+                                                       Ort::Env& env,
+                                                       const Ort::SessionOptions& options,
+                                                       bool hardware = false);
+
+    // Cache entry for modelPath, or an empty path if the cache is disabled
+    // or the model cannot be read
+    static std::filesystem::path entryPath(const std::filesystem::path& modelPath);
+};
+
+// Process-wide registry handing out one session per model file, so every
+// pipeline, engine and wrapper that loads the same file shares its weights.
+// Shared sessions are created from a memory mapping of the file: ORT-format
+// (.ort) models run straight from the mapped bytes, whose pages the OS
+// shares between processes, while ONNX models are parsed from the mapping.
+// Prepacked weights go to one container shared by all sessions. A session
+// keeps the options of the caller that created it, and is released when the
+// last wrapper using it is destroyed.
+class ModelRegistry {
+public:
+    // Enable or disable sharing for sessions created from now on
+    static void configure(bool shareModels);
+    static bool isSharing();
+
+    // The shared session for modelPath, created on first use, or a private
+    // session when sharing is disabled. CPU and hardware provider sessions
+    // (see createSession) are shared separately. Throws Ort::Exception like
+    // the Ort::Session constructor.
+    static std::shared_ptr<Ort::Session> acquire(const std::filesystem::path& modelPath,
+                                                 Ort::Env& env,
+                                                 const Ort::SessionOptions& options,
+                                                 bool hardware = false);
+
+    // Sessions currently shared
+    static size_t size();
+};
+
+// Run load tasks on up to maxThreads threads (0 for one per CPU, 1 runs them
+// in order on the caller). Every task runs even after one fails, so all
+// errors are reported; returns false if any task did.
+bool runLoadTasks(const std::vector<std::function<bool()>>& tasks, size_t maxThreads);
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_MODEL_LOADER_H
@@ -3,10 +3,12 @@
 
 #include <filesystem>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 #include <onnxruntime_cxx_api.h>
 #include "types.h"
+#include "core/mel_frontend.h"
 
 namespace openwakeword {
 
@@ -16,10 +18,12 @@ public:
     ModelWrapper(const std::string& modelName, ModelType type);
     virtual ~ModelWrapper() = default;
     
-    // Load model from file
+    // Load model from file. options with hardware execution providers come
+    // with cpuFallback, which is used if the session cannot be created on them.
     bool loadModel(const std::filesystem::path& modelPath, 
                    Ort::Env& env,
-                   const Ort::SessionOptions& options);
+                   const Ort::SessionOptions& options,
+                   const Ort::SessionOptions* cpuFallback = nullptr);
     
     // Get model information
     const std::string& getName() const { return modelName_; }
@@ -30,16 +34,45 @@ public:
     std::vector<int64_t> getInputShape(size_t index = 0) const;
     std::vector<int64_t> getOutputShape(size_t index = 0) const;
     
+    // Check if persistent input/output tensors are bound
+    bool isBound() const { return ioBinding_ != nullptr; }
+    
+    // Check if the first input accepts any batch size
+    bool hasDynamicBatch() const;
+    
+    // FP16 graphs: float inputs and outputs are converted at the session
+    // boundary, so callers use the same float API for every precision
+    bool isHalfPrecision() const { return halfPrecision_; }
+    
 protected:
     // Run inference
     std::vector<Ort::Value> runInference(const std::vector<Ort::Value>& inputs);
     
+    // Bind persistent float input/output tensors through Ort::IoBinding so
+    // that runBound() performs no heap allocation. Output shapes are resolved
+    // by one warm-up run. A bound model must only be run from one thread.
+    bool bindTensors(const std::vector<std::vector<int64_t>>& inputShapes);
+    
+    // Run inference on the bound tensors
+    void runBound();
+    
+    struct BoundTensor {
+        std::vector<int64_t> shape;
+        std::vector<AudioFloat> data;
+        std::vector<uint16_t> half;  // Bound in place of data for FP16 tensors
+    };
+    
+    static size_t elementCount(const std::vector<int64_t>& shape);
+    
+    // Tensor over tensor's buffer in the graph's element type
+    Ort::Value createBoundValue(BoundTensor& tensor, ONNXTensorElementDataType type);
+    
     // Model metadata
     std::string modelName_;
     ModelType modelType_;
     
-    // ONNX Runtime objects
-    std::unique_ptr<Ort::Session> session_;
+    // ONNX Runtime objects; the session may be shared through ModelRegistry
+    std::shared_ptr<Ort::Session> session_;
     Ort::AllocatorWithDefaultOptions allocator_;
     Ort::MemoryInfo memoryInfo_;
     
@@ -48,18 +81,47 @@ protected:
     std::vector<Ort::AllocatedStringPtr> outputNames_;
     std::vector<const char*> inputNamePtrs_;
     std::vector<const char*> outputNamePtrs_;
+    
+    // Element types declared by the graph
+    std::vector<ONNXTensorElementDataType> inputTypes_;
+    std::vector<ONNXTensorElementDataType> outputTypes_;
+    bool halfPrecision_ = false;
+    
+    // Persistent tensors for the IoBinding path
+    std::vector<BoundTensor> boundInputs_;
+    std::vector<BoundTensor> boundOutputs_;
+    std::vector<Ort::Value> boundValues_;
+    std::unique_ptr<Ort::IoBinding> ioBinding_;
+    Ort::RunOptions runOptions_;
 };
 
 // Specialized model wrapper for mel spectrogram computation
-class MelSpectrogramModel : public ModelWrapper {
+class MelSpectrogramModel : public ModelWrapper, public MelFrontend {
 public:
     MelSpectrogramModel();
     
     // Compute mel spectrogram from audio samples
     MelBuffer computeMelSpectrogram(const AudioBuffer& samples);
     
+    // Compute mel spectrogram from count contiguous samples. The result is
+    // valid until the next call.
+    std::span<const AudioFloat> computeMelSpectrogram(const AudioFloat* samples, size_t count) override;
+    
+    // Bind persistent tensors for a fixed frame size
+    bool bindIo(size_t frameSize);
+    bool prepare(size_t frameSize) override { return bindIo(frameSize); }
+    
+    // Thread-safe batched inference over batch rows of count contiguous
+    // samples. Writes rescaled mels (row after row) to out and returns the
+    // number of mel frames per row. Note that the graph's 80 dB floor is
+    // taken over the whole batch.
+    size_t computeMelSpectrogramBatch(const AudioFloat* samples, size_t batch,
+                                      size_t count, MelBuffer& out) override;
+    
+    const char* getFrontendName() const override { return "onnx"; }
+    
 private:
-    size_t frameSize_ = 4 * CHUNK_SAMPLES;
+    MelBuffer melOutput_;
 };
 
 // Specialized model wrapper for speech embedding
@@ -69,6 +131,21 @@ public:
     
     // Extract embeddings from mel spectrograms
     FeatureBuffer extractEmbeddings(const MelBuffer& mels);
+    
+    // Extract embeddings from EMBEDDING_WINDOW_SIZE x NUM_MELS contiguous
+    // floats. The result is valid until the next call.
+    std::span<const AudioFloat> extractEmbeddings(const AudioFloat* mels);
+    
+    // Bind persistent tensors for one embedding window
+    bool bindIo();
+    
+    // Thread-safe batched inference, windows[i] points to one mel window.
+    // scratch receives the gathered batch input and is reused across calls.
+    void extractEmbeddingsBatch(const AudioFloat* const* windows, size_t batch,
+                                std::vector<AudioFloat>& scratch, FeatureBuffer& out);
+    
+private:
+    FeatureBuffer embOutput_;
 };
 
 // Specialized model wrapper for wake word detection
@@ -79,6 +156,23 @@ public:
     // Predict wake word probability from features
     float predict(const FeatureBuffer& features);
     
+    // Predict from WAKEWORD_FEATURES x EMBEDDING_FEATURES contiguous floats
+    float predict(const AudioFloat* features);
+    
+    // Merged graphs expose one score output per wake word; a single Run
+    // fills scores[i] for every output
+    void predictAll(const AudioFloat* features, float* scores);
+    size_t getNumScores() const { return outputNamePtrs_.size(); }
+    std::string getScoreName(size_t index) const { return outputNamePtrs_.at(index); }
+    
+    // Bind persistent tensors for one feature window
+    bool bindIo();
+    
+    // Thread-safe batched prediction of the first score output, one score per
+    // window. Models with a fixed batch size of 1 run once per window.
+    void predictBatch(const AudioFloat* const* windows, size_t batch,
+                      std::vector<AudioFloat>& scratch, float* scores);
+    
     // Get wake word this model detects
     const std::string& getWakeWord() const { return wakeWord_; }
     
@@ -86,19 +180,50 @@ private:
     std::string wakeWord_;
 };
 
-// VAD model wrapper
+// Per-speaker verifier for one wake word, as in the Python openWakeWord: a
+// logistic model over the flattened WAKEWORD_FEATURES x EMBEDDING_FEATURES
+// window, exported from scikit-learn to ONNX with the zipmap disabled. The
+// input may be [N, 1536] or [N, 16, 96]; the last column of the first float
+// output is taken as the probability of the positive class.
+class CustomVerifierModel : public ModelWrapper {
+public:
+    CustomVerifierModel(const std::string& wakeWord);
+    
+    // Score batch windows, windows[i] pointing to one feature window.
+    // scratch receives the gathered batch input and is reused across calls.
+    void verifyBatch(const AudioFloat* const* windows, size_t batch,
+                     std::vector<AudioFloat>& scratch, float* probabilities);
+};
+
+// Silero VAD model wrapper. Both the v4 (h/c LSTM state) and v5 (single
+// state tensor, 64 samples of prepended context) exports are supported;
+// the version is detected from the input names.
 class VADModel : public ModelWrapper {
 public:
     VADModel();
     
-    // Predict voice activity probability
+    // Samples scored per call
+    static constexpr size_t FRAME_SAMPLES = 512;
+    
+    // Detect the model version and reset the state; call after loadModel()
+    bool prepare();
+    
+    // Predict voice activity probability for FRAME_SAMPLES samples scaled
+    // to [-1, 1]; the recurrent state carries over to the next call
     float predictVoiceActivity(const AudioBuffer& samples);
     
     // Reset internal state (for RNN-based models)
     void resetState();
     
+    bool isV5() const { return v5_; }
+    
 private:
+    static constexpr size_t STATE_SIZE = 2 * 128;       // v4 h and c, or v5 state
+    static constexpr size_t V5_CONTEXT_SAMPLES = 64;
+    
+    bool v5_ = false;
     std::vector<float> internalState_;
+    std::vector<float> input_;  // v5: context followed by the frame
 };
 
 } // namespace openwakeword
@@ -0,0 +1,92 @@
+#ifndef OPENWAKEWORD_MPSC_QUEUE_H
+#define OPENWAKEWORD_MPSC_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace openwakeword {
+
+// Bounded lock-free multi-producer/single-consumer queue of movable items.
+// Each slot carries a sequence number telling producers and the consumer
+// whose turn it is, so a push is one CAS on the shared head and a pop
+// touches no shared counter at all. Storage is allocated once.
+template<typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(size_t capacity)
+        : capacity_(roundUpPowerOfTwo(std::max<size_t>(capacity, 2))),
+          mask_(capacity_ - 1),
+          slots_(std::make_unique<Slot[]>(capacity_)) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Producer side, any thread: returns false if the queue is full
+    bool tryPush(T&& value) {
+        size_t position = head_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[position & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+            if (difference == 0) {
+                if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;  // The consumer has not freed this slot yet
+            } else {
+                position = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer side, one thread: returns false if the queue is empty
+    bool tryPop(T& value) {
+        Slot& slot = slots_[tail_ & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+            return false;
+        }
+        value = std::move(slot.value);
+        slot.sequence.store(tail_ + capacity_, std::memory_order_release);
+        tail_++;
+        return true;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(CACHE_LINE) std::atomic<size_t> head_{0};  // Shared by producers
+    alignas(CACHE_LINE) size_t tail_ = 0;              // Consumer-owned
+
+    static size_t roundUpPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_MPSC_QUEUE_H
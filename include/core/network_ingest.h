@@ -0,0 +1,106 @@
+#ifndef OPENWAKEWORD_NETWORK_INGEST_H
+#define OPENWAKEWORD_NETWORK_INGEST_H
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+#include "core/engine.h"
+#include "processors/audio_reader.h"
+#include "utils/config.h"
+
+namespace openwakeword {
+
+// Event loop feeding network audio into the multi-stream engine, so many
+// senders need neither a pipe nor a relay process each. Every connection to
+// the Unix socket (raw PCM) and every source on the UDP port (RTP/L16 per
+// sender and SSRC, or raw PCM per sender) becomes one engine stream. One
+// thread waits on all sockets (epoll on Linux, poll elsewhere) and receives
+// into a buffer it owns, which is converted straight into the stream's ring.
+// A connection whose stream is full stops being read, so the sender is held
+// back by the socket; UDP audio that does not fit is dropped, and lost RTP
+// packets are replaced by silence to keep stream time. At most
+// config.maxNetworkStreams streams are open at once: further connections
+// are closed on accept and datagrams from further sources are dropped.
+class NetworkIngest {
+public:
+    NetworkIngest(Engine& engine, const Config& config);
+    ~NetworkIngest();
+
+    NetworkIngest(const NetworkIngest&) = delete;
+    NetworkIngest& operator=(const NetworkIngest&) = delete;
+
+    // Bind the configured listeners; returns false if one cannot be bound
+    bool open();
+
+    // Serve until stop() or the engine stops; streams still open are
+    // closed on return
+    void run();
+    void stop() { running_ = false; }
+
+    // UDP samples dropped for a full stream, and silence inserted for lost
+    // RTP packets
+    size_t getDroppedSamples() const { return droppedSamples_; }
+    size_t getConcealedSamples() const { return concealedSamples_; }
+    
+    // Connections and datagrams refused at the stream limit
+    size_t getRefusedSources() const { return refusedSources_; }
+
+private:
+    class EventPoller;
+
+    struct Connection {
+        std::unique_ptr<SocketAudioReader> reader;
+        std::shared_ptr<StreamContext> stream;
+        bool paused = false;  // Not polled until the stream has space again
+    };
+
+    struct Source {
+        std::shared_ptr<StreamContext> stream;
+        uint16_t nextSequence = 0;
+        std::chrono::steady_clock::time_point lastPacket;
+    };
+
+    Engine& engine_;
+    Config config_;
+
+    int listenSocket_ = -1;
+    std::unique_ptr<DatagramAudioReader> datagrams_;
+    std::unique_ptr<EventPoller> poller_;
+
+    std::map<int, Connection> connections_;
+    std::map<DatagramSource, Source> sources_;
+    size_t pausedConnections_ = 0;
+    size_t nextConnection_ = 0;
+
+    // Receive buffer, large enough for any datagram
+    std::vector<AudioSample> buffer_;
+    std::vector<AudioSample> silence_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> droppedSamples_{0};
+    std::atomic<size_t> concealedSamples_{0};
+    std::atomic<size_t> refusedSources_{0};
+    bool refusedLogged_ = false;
+
+    bool openUnixSocket();
+    bool openUdpSocket();
+
+    void acceptConnections();
+    void readConnection(std::map<int, Connection>::iterator connection);
+    void closeConnection(std::map<int, Connection>::iterator connection);
+    void resumeConnections();
+
+    void readDatagrams();
+    void pushDatagramAudio(StreamContext& stream, const AudioSample* samples, size_t count);
+    void expireSources();
+
+    size_t openStreams() const { return connections_.size() + sources_.size(); }
+
+    void closeAll();
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_NETWORK_INGEST_H
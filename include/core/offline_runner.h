@@ -0,0 +1,104 @@
+#ifndef OPENWAKEWORD_OFFLINE_RUNNER_H
+#define OPENWAKEWORD_OFFLINE_RUNNER_H
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "core/embedding_batcher.h"
+#include "core/embedding_cache.h"
+#include "core/model_wrapper.h"
+#include "core/ort_environment.h"
+#include "core/types.h"
+#include "processors/wake_word_detector.h"
+#include "utils/config.h"
+
+namespace openwakeword {
+
+// Offline batch scoring of WAV or raw PCM files, read through memory maps.
+// Files are spread across a worker pool and read as fast as the models allow,
+// not paced to real time. Within a file, every embedding and wake word
+// window of a block of audio runs as one batched call. Detections match the
+// streaming pipeline exactly and are reported with the sample offset at
+// which the pipeline would fire.
+class OfflineRunner {
+public:
+    explicit OfflineRunner(const Config& config);
+    ~OfflineRunner();
+
+    // Load all models
+    bool initialize();
+
+    // Expand config.offlineInputs (files and directories, searched
+    // recursively for .wav, .pcm and .raw) and config.offlineFileList into
+    // files; false if the file list cannot be read
+    static bool collectInputs(const Config& config, std::vector<std::filesystem::path>& files);
+
+    // Process all files; returns the number of files that failed
+    size_t run(const std::vector<std::filesystem::path>& files);
+
+    // Stop after the files currently in progress
+    void stop() { stopRequested_ = true; }
+
+private:
+    // Per-worker buffers reused from file to file
+    struct WorkerScratch {
+        std::vector<AudioFloat> audio;
+        std::vector<AudioSample> converted;  // 16 kHz mono audio of files in other formats
+        std::vector<AudioFloat> melInput;
+        MelBuffer melOutput;
+        std::vector<const AudioFloat*> windows;
+        std::vector<AudioFloat> batchInput;
+        FeatureBuffer embeddings;
+        std::vector<float> scores;
+    };
+
+    Config config_;
+    std::shared_ptr<OrtEnvironment> ortEnvironment_;
+    Ort::Env& env_;
+    Ort::SessionOptions sessionOptions_;
+
+    // Per-model execution providers; sessionOptions_ is the CPU fallback
+    ModelSessionOptions melOptions_;
+    ModelSessionOptions embeddingOptions_;
+    std::vector<ModelSessionOptions> wakeWordOptions_;
+
+    // Shared sessions
+    std::unique_ptr<MelFrontend> melFrontend_;
+    std::unique_ptr<EmbeddingModel> embeddingModel_;
+    std::vector<std::unique_ptr<WakeWordModel>> wakeWordModels_;
+    std::vector<std::string> wakeWordNames_;
+    std::unique_ptr<EmbeddingBatcher> embeddingBatcher_;
+
+    std::mutex outputMutex_;
+    std::atomic<bool> stopRequested_{false};
+
+    // Score one file; detections hold the triggering audio frame index.
+    // Returns false if the file could not be read.
+    bool processFile(const std::filesystem::path& file, WorkerScratch& scratch,
+                     std::vector<Detection>& detections, size_t& samplesProcessed);
+
+    // Score a file from its cached embeddings
+    void replayFile(const EmbeddingCacheReader& cache, WorkerScratch& scratch,
+                    std::vector<Detection>& detections);
+
+    // Run every wake word model over the complete windows of count
+    // contiguous embeddings, the first of which has index firstEmbedding.
+    // Returns the number of windows scored.
+    size_t scoreEmbeddings(const AudioFloat* embeddings, size_t count, size_t firstEmbedding,
+                           size_t framesPerRow, std::vector<ActivationTracker>& activations,
+                           WorkerScratch& scratch, std::vector<Detection>& detections);
+
+    // Audio samples per detection frame index: one step, or one 80 ms group
+    // with config.streamingMel
+    size_t detectionFrameSize() const;
+
+    void printDetections(const std::filesystem::path& file,
+                         const std::vector<Detection>& detections);
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_OFFLINE_RUNNER_H
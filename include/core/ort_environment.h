@@ -0,0 +1,55 @@
+#ifndef OPENWAKEWORD_ORT_ENVIRONMENT_H
+#define OPENWAKEWORD_ORT_ENVIRONMENT_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <onnxruntime_cxx_api.h>
+#include "utils/config.h"
+
+namespace openwakeword {
+
+// Session options for one model. With hardware execution providers the
+// session falls back to the plain CPU options if none of them can run it.
+struct ModelSessionOptions {
+    Ort::SessionOptions options;
+    bool hardware = false;  // Providers besides the CPU were added
+};
+
+// Process-wide ONNX Runtime environment, shared by every pipeline, engine
+// and offline runner in the process (ORT supports only one). With
+// config.globalThreadPool the environment owns global intra-op and inter-op
+// thread pools that every session runs on, so several pipelines do not each
+// spawn their own. The first caller's thread settings size those pools; the
+// latest caller's config.modelCacheDir and config.shareModels configure
+// model loading (see model_loader.h).
+class OrtEnvironment {
+public:
+    // The shared environment, created on first use
+    static std::shared_ptr<OrtEnvironment> acquire(const Config& config);
+
+    Ort::Env& env() { return env_; }
+    bool hasGlobalThreadPools() const { return globalThreadPools_; }
+
+    // Session options for config: per-session thread counts or the global
+    // pools, graph optimization level and execution mode
+    Ort::SessionOptions createSessionOptions(const Config& config) const;
+    
+    // Session options for model on providers (see Config::melProviders),
+    // in order of preference. Providers this ONNX Runtime build lacks are
+    // skipped with a warning; the CPU provider takes the remaining nodes.
+    ModelSessionOptions createSessionOptions(const Config& config,
+                                             const std::vector<std::string>& providers,
+                                             const std::string& model) const;
+
+    // Use acquire()
+    OrtEnvironment(const Config& config, bool globalThreadPools);
+
+private:
+    bool globalThreadPools_;
+    Ort::Env env_;
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_ORT_ENVIRONMENT_H
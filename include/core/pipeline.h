@@ -4,20 +4,28 @@
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <thread>
 #include <vector>
 #include "core/audio_processor.h"
 #include "core/types.h"
-#include "core/thread_safe_buffer.h"
+#include "core/broadcast_ring_buffer.h"
+#include "core/detection_collector.h"
+#include "core/ort_environment.h"
+#include "core/spsc_ring_buffer.h"
+#include "preprocessors/preprocessor_chain.h"
+#include "processors/audio_converter.h"
+#include "processors/detector_group.h"
 #include "processors/mel_spectrogram.h"
 #include "processors/speech_embedding.h"
 #include "processors/wake_word_detector.h"
 #include "utils/config.h"
+#include "utils/metrics.h"
+#include "utils/metrics_exporter.h"
 
 namespace openwakeword {
 
 // Forward declarations
-class Preprocessor;
 class Postprocessor;
 
 // Audio processing pipeline manager
@@ -35,44 +43,78 @@ public:
     // Stop processing threads
     void stop();
     
-    // Process audio input
-    void processAudio(const AudioSample* samples, size_t sampleCount);
+    // Process audio input in the configured input format; samples are
+    // resampled and downmixed if needed, then converted straight into the
+    // audio ring
+    void processAudio(std::span<const AudioSample> samples);
+    void processAudio(const AudioSample* samples, size_t sampleCount) {
+        processAudio(std::span<const AudioSample>(samples, sampleCount));
+    }
     
-    // Add preprocessor to pipeline
+    // Add preprocessor to pipeline; preprocessors run in the order added on
+    // the thread calling processAudio()
     void addPreprocessor(std::unique_ptr<Preprocessor> preprocessor);
     
-    // Add postprocessor to pipeline  
+    // Add postprocessor to pipeline; postprocessors run on the detection
+    // collector thread, in the order added. Call before start().
     void addPostprocessor(std::unique_ptr<Postprocessor> postprocessor);
     
+    // Report detections through callback instead of stdout; call before
+    // start(). The callback runs on the detection collector thread.
+    void setDetectionCallback(DetectionCallback callback);
+    
     // Check if pipeline is running
     bool isRunning() const { return running_; }
     
     // Wait until pipeline is ready
     void waitUntilReady();
     
+    // Live statistics; safe to read from any thread
+    const Metrics& getMetrics() const { return metrics_; }
+    
 private:
     Config config_;
-    Ort::Env env_;
+    std::shared_ptr<OrtEnvironment> ortEnvironment_;
+    Ort::Env& env_;
     Ort::SessionOptions sessionOptions_;
     
+    // Per-model execution providers; sessionOptions_ is the CPU fallback
+    ModelSessionOptions melOptions_;
+    ModelSessionOptions embeddingOptions_;
+    std::vector<ModelSessionOptions> detectorOptions_;
+    
     // Processing stages
     std::unique_ptr<MelSpectrogramProcessor> melProcessor_;
     std::unique_ptr<SpeechEmbeddingProcessor> embeddingProcessor_;
     std::vector<std::unique_ptr<WakeWordDetector>> detectors_;
+    std::unique_ptr<DetectorGroup> detectorGroup_;
+    
+    // Input conversion to 16 kHz mono, when the input is not already
+    std::unique_ptr<AudioConverter> inputConverter_;
     
     // Preprocessors and postprocessors
-    std::vector<std::unique_ptr<Preprocessor>> preprocessors_;
+    PreprocessorChain preprocessors_;
     std::vector<std::unique_ptr<Postprocessor>> postprocessors_;
     
+    std::unique_ptr<DetectionCollector> collector_;
+    DetectionCallback detectionCallback_;
+    
+    // Instrumentation
+    Metrics metrics_;
+    std::unique_ptr<MetricsExporter> metricsExporter_;
+    uint64_t samplesPushed_ = 0;
+    
     // Buffers for inter-processor communication
-    std::shared_ptr<ThreadSafeBuffer<AudioFloat>> audioBuffer_;
-    std::shared_ptr<ThreadSafeBuffer<AudioFloat>> melBuffer_;
-    std::vector<std::shared_ptr<ThreadSafeBuffer<AudioFloat>>> featureBuffers_;
+    std::shared_ptr<SpscRingBuffer<AudioFloat>> audioBuffer_;
+    std::shared_ptr<SpscRingBuffer<AudioFloat>> melBuffer_;
+    std::shared_ptr<BroadcastRingBuffer<AudioFloat>> featureBuffer_;
+    std::vector<size_t> featureReaders_;
     
     // Processing threads
     std::thread melThread_;
     std::thread embeddingThread_;
     std::vector<std::thread> detectorThreads_;
+    std::thread detectorGroupThread_;
     
     // Synchronization
     std::mutex outputMutex_;
@@ -85,6 +127,12 @@ private:
     // Helper methods
     void runAudioInput();
     void incrementReady();
+    
+    // Pin the calling stage thread to cpus (if any), warning on failure
+    void pinThread(const std::string& stage, const std::vector<int>& cpus);
+    
+    // Raise the calling stage thread to config_.realtimePriority, if set
+    void prioritizeThread(const std::string& stage);
 };
 
 } // namespace openwakeword
@@ -0,0 +1,87 @@
+#ifndef OPENWAKEWORD_SLIDING_WINDOW_H
+#define OPENWAKEWORD_SLIDING_WINDOW_H
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace openwakeword {
+
+// Mirrored frame storage: frame n lives in slot (n % capacity) and again in
+// slot (n % capacity) + capacity, so any run of up to capacity consecutive
+// frames is contiguous in memory and can be wrapped by a tensor directly.
+template<typename T>
+class MirroredRing {
+public:
+    MirroredRing(size_t frameSize, size_t capacityFrames)
+        : frameSize_(frameSize),
+          capacity_(std::max<size_t>(capacityFrames, 1)),
+          storage_(2 * capacity_ * frameSize_) {}
+
+    // Store frame number frameIndex (overwrites frameIndex - capacity)
+    void write(size_t frameIndex, const T* frame) {
+        size_t slot = frameIndex % capacity_;
+        std::copy(frame, frame + frameSize_, storage_.begin() + slot * frameSize_);
+        std::copy(frame, frame + frameSize_, storage_.begin() + (slot + capacity_) * frameSize_);
+    }
+
+    // Pointer to frame frameIndex followed by up to capacity - 1 later frames
+    const T* at(size_t frameIndex) const {
+        return storage_.data() + (frameIndex % capacity_) * frameSize_;
+    }
+
+    size_t frameSize() const { return frameSize_; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    size_t frameSize_;
+    size_t capacity_;
+    std::vector<T> storage_;
+};
+
+// Single-threaded FIFO of fixed-size frames with a contiguous view of the
+// oldest frames, for sliding model windows without copies or memmoves
+template<typename T>
+class SlidingWindow {
+public:
+    SlidingWindow(size_t frameSize, size_t capacityFrames)
+        : ring_(frameSize, capacityFrames) {}
+
+    // Append whole frames; throws if the window would overflow
+    void append(const T* frames, size_t count) {
+        if (size() + count > ring_.capacity()) {
+            throw std::length_error("SlidingWindow capacity exceeded");
+        }
+        for (size_t i = 0; i < count; ++i) {
+            ring_.write(end_++, frames + i * ring_.frameSize());
+        }
+    }
+
+    // Contiguous view of the oldest size() frames
+    const T* data() const { return ring_.at(begin_); }
+
+    // Drop frames from the front
+    void consume(size_t count) {
+        begin_ += std::min(count, size());
+    }
+
+    void clear() { begin_ = end_; }
+
+    size_t size() const { return end_ - begin_; }
+    size_t space() const { return ring_.capacity() - size(); }
+    size_t capacity() const { return ring_.capacity(); }
+    size_t frameSize() const { return ring_.frameSize(); }
+
+    // Total frames appended since construction
+    size_t framesWritten() const { return end_; }
+
+private:
+    MirroredRing<T> ring_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_SLIDING_WINDOW_H
@@ -0,0 +1,257 @@
+#ifndef OPENWAKEWORD_SPSC_RING_BUFFER_H
+#define OPENWAKEWORD_SPSC_RING_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "core/types.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace openwakeword {
+
+// Hint to the CPU that we are busy-waiting
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__GNUC__) && (defined(__aarch64__) || defined(__arm__))
+    asm volatile("yield");
+#endif
+}
+
+// Lock-free single-producer/single-consumer ring buffer for inter-processor
+// communication. Storage is allocated once; a full ring applies backpressure
+// to the producer instead of growing.
+template<typename T>
+class SpscRingBuffer {
+public:
+    explicit SpscRingBuffer(size_t capacity, WaitPolicy waitPolicy = WaitPolicy::BLOCKING)
+        : capacity_(roundUpPowerOfTwo(std::max<size_t>(capacity, 2))),
+          mask_(capacity_ - 1),
+          waitPolicy_(waitPolicy),
+          buffer_(capacity_) {}
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Producer side: blocks while the ring is full
+    void push(const std::vector<T>& data) {
+        push(data.data(), data.size());
+    }
+
+    void push(const T* data, size_t count) {
+        while (count > 0) {
+            size_t written = tryPush(data, count);
+            if (written == 0) {
+                if (!waitForSpace()) {
+                    return;  // Exhausted while waiting, drop remaining data
+                }
+                continue;
+            }
+            data += written;
+            count -= written;
+        }
+    }
+
+    // Push as much as currently fits without waiting, returns count written
+    size_t tryPush(const T* data, size_t count) {
+        return tryPushConverted(data, count, [](const T* in, T* out, size_t n) {
+            std::copy(in, in + n, out);
+        });
+    }
+
+    // Push values of another type, converting them straight into the ring's
+    // storage so no intermediate buffer is needed. convert(in, out, n) is a
+    // bulk kernel called once per contiguous region. Blocks while full.
+    template<typename U, typename Convert>
+    void pushConverted(const U* data, size_t count, Convert convert) {
+        while (count > 0) {
+            size_t written = tryPushConverted(data, count, convert);
+            if (written == 0) {
+                if (!waitForSpace()) {
+                    return;  // Exhausted while waiting, drop remaining data
+                }
+                continue;
+            }
+            data += written;
+            count -= written;
+        }
+    }
+
+    template<typename U, typename Convert>
+    size_t tryPushConverted(const U* data, size_t count, Convert convert) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        size_t free = capacity_ - (head - cachedTail_);
+        if (free < count) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            free = capacity_ - (head - cachedTail_);
+        }
+
+        size_t n = std::min(free, count);
+        if (n == 0) {
+            return 0;
+        }
+
+        size_t start = head & mask_;
+        size_t first = std::min(n, capacity_ - start);
+        convert(data, buffer_.data() + start, first);
+        if (n > first) {
+            convert(data + first, buffer_.data(), n - first);
+        }
+
+        head_.store(head + n, std::memory_order_release);
+        signal(dataSignal_);
+        return n;
+    }
+
+    // Consumer side: blocks until data is available or the buffer is exhausted.
+    // Returns the number of elements copied into dest (0 once exhausted).
+    size_t pull(T* dest, size_t maxCount) {
+        if (maxCount == 0) {
+            return 0;
+        }
+
+        while (true) {
+            size_t n = tryPull(dest, maxCount);
+            if (n > 0) {
+                return n;
+            }
+            if (!waitForData()) {
+                // Exhausted: drain whatever the producer published last
+                return tryPull(dest, maxCount);
+            }
+        }
+    }
+
+    // Compatibility with ThreadSafeBuffer (allocates the returned vector)
+    std::vector<T> pull(size_t maxCount = 0) {
+        if (maxCount == 0) {
+            maxCount = capacity_;
+        }
+        std::vector<T> result(maxCount);
+        result.resize(pull(result.data(), maxCount));
+        return result;
+    }
+
+    // Pull whatever is currently available without waiting
+    size_t tryPull(T* dest, size_t maxCount) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t available = cachedHead_ - tail;
+        if (available < maxCount) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            available = cachedHead_ - tail;
+        }
+
+        size_t n = std::min(available, maxCount);
+        if (n == 0) {
+            return 0;
+        }
+
+        size_t start = tail & mask_;
+        size_t first = std::min(n, capacity_ - start);
+        std::copy(buffer_.begin() + start, buffer_.begin() + start + first, dest);
+        std::copy(buffer_.begin(), buffer_.begin() + (n - first), dest + first);
+
+        tail_.store(tail + n, std::memory_order_release);
+        signal(spaceSignal_);
+        return n;
+    }
+
+    void setExhausted(bool exhausted) {
+        exhausted_.store(exhausted, std::memory_order_release);
+        signal(dataSignal_);
+        signal(spaceSignal_);
+    }
+
+    bool isExhausted() const {
+        return exhausted_.load(std::memory_order_acquire) && size() == 0;
+    }
+
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr int SPIN_ITERATIONS = 256;
+
+    const size_t capacity_;
+    const size_t mask_;
+    const WaitPolicy waitPolicy_;
+    std::vector<T> buffer_;
+
+    // Producer-owned
+    alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
+
+    // Consumer-owned
+    alignas(CACHE_LINE) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+
+    // Wake-up counters, bumped after every publish so waiters never miss one
+    alignas(CACHE_LINE) std::atomic<uint32_t> dataSignal_{0};
+    alignas(CACHE_LINE) std::atomic<uint32_t> spaceSignal_{0};
+    std::atomic<bool> exhausted_{false};
+
+    static size_t roundUpPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    void signal(std::atomic<uint32_t>& counter) {
+        counter.fetch_add(1, std::memory_order_release);
+        if (waitPolicy_ == WaitPolicy::BLOCKING) {
+            counter.notify_one();
+        }
+    }
+
+    // Returns false if the buffer was exhausted instead
+    bool waitForData() {
+        return waitUntil(dataSignal_, [this] {
+            return head_.load(std::memory_order_acquire) != tail_.load(std::memory_order_relaxed);
+        });
+    }
+
+    bool waitForSpace() {
+        return waitUntil(spaceSignal_, [this] {
+            return head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_acquire) < capacity_;
+        });
+    }
+
+    template<typename Predicate>
+    bool waitUntil(std::atomic<uint32_t>& counter, Predicate ready) {
+        int spins = 0;
+        while (true) {
+            uint32_t seen = counter.load(std::memory_order_acquire);
+            if (ready()) {
+                return true;
+            }
+            if (exhausted_.load(std::memory_order_acquire)) {
+                return false;
+            }
+
+            if (waitPolicy_ == WaitPolicy::BLOCKING) {
+                counter.wait(seen, std::memory_order_acquire);
+            } else if (++spins < SPIN_ITERATIONS) {
+                cpuRelax();
+            } else {
+                spins = 0;
+                std::this_thread::yield();
+            }
+        }
+    }
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_SPSC_RING_BUFFER_H
@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -12,6 +13,8 @@ namespace openwakeword {
 constexpr size_t SAMPLE_RATE = 16000;
 constexpr size_t CHUNK_SAMPLES = 1280;  // 80 ms
 constexpr size_t NUM_MELS = 32;
+constexpr size_t MEL_HOP_SAMPLES = 160;       // 10 ms
+constexpr size_t MEL_WINDOW_SAMPLES = 512;    // 32 ms STFT window
 constexpr size_t EMBEDDING_WINDOW_SIZE = 76;  // 775 ms
 constexpr size_t EMBEDDING_STEP_SIZE = 8;     // 80 ms
 constexpr size_t EMBEDDING_FEATURES = 96;
@@ -29,11 +32,15 @@ struct Detection {
     std::string modelName;
     float score;
     size_t frameIndex;
+    bool accepted = true;  // Cleared by a postprocessor to reject the detection
     
     Detection(const std::string& name, float s, size_t idx) 
         : modelName(name), score(s), frameIndex(idx) {}
 };
 
+// Receives detections in place of the stdout output
+using DetectionCallback = std::function<void(const Detection&)>;
+
 // Model types
 enum class ModelType {
     MELSPECTROGRAM,
@@ -43,6 +50,32 @@ enum class ModelType {
     CUSTOM_VERIFIER
 };
 
+// How a consumer or producer waits on an inter-processor buffer
+enum class WaitPolicy {
+    BLOCKING,   // Sleep until signalled (lowest CPU use)
+    SPINNING    // Busy-wait with CPU relax hints (lowest wake-up latency)
+};
+
+// What the real-time pipeline gives up when a stage misses its deadline
+enum class OverloadPolicy {
+    BLOCK,          // Nothing: backpressure slows the input down
+    DROP_AUDIO,     // Skip the oldest audio before it is embedded
+    SKIP_STEPS,     // Skip wake word steps until the detectors catch up
+    REDUCE_MODELS   // Skip steps of all but the first wake words only
+};
+
+// How the channels of a mic array are combined before triggering
+enum class ChannelFusion {
+    MAX,           // Each wake word takes its highest channel score
+    BEST_CHANNEL   // All wake words take the channel scoring highest overall
+};
+
+// Mel spectrogram implementation
+enum class MelFrontendType {
+    ONNX,       // melspectrogram.onnx through ONNX Runtime
+    NATIVE      // Built-in C++ STFT and mel filterbank
+};
+
 // Audio frame for processing
 struct AudioFrame {
     std::vector<AudioSample> samples;
@@ -0,0 +1,42 @@
+#ifndef OPENWAKEWORD_VOICE_ACTIVITY_GATE_H
+#define OPENWAKEWORD_VOICE_ACTIVITY_GATE_H
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace openwakeword {
+
+// Voice activity shared between the VAD, which runs on the audio input
+// thread, and the later stages it gates. Positions are audio sample counts
+// since the start of the stream. Later stages lag the input, so by the time
+// they ask about a position the VAD has already scored it.
+class VoiceActivityGate {
+public:
+    explicit VoiceActivityGate(uint64_t hangoverSamples) : hangover_(hangoverSamples) {}
+
+    // Record the VAD decision for the audio ending at position end
+    void update(uint64_t end, bool speech) {
+        if (speech) {
+            lastSpeechEnd_.store(end, std::memory_order_release);
+        }
+    }
+
+    // Check if speech was detected no more than the hangover before position
+    bool isOpen(uint64_t position) const {
+        uint64_t last = lastSpeechEnd_.load(std::memory_order_acquire);
+        return last != NO_SPEECH && last + hangover_ >= position;
+    }
+
+    void reset() { lastSpeechEnd_.store(NO_SPEECH, std::memory_order_release); }
+
+private:
+    static constexpr uint64_t NO_SPEECH = std::numeric_limits<uint64_t>::max();
+
+    uint64_t hangover_;
+    std::atomic<uint64_t> lastSpeechEnd_{NO_SPEECH};
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_VOICE_ACTIVITY_GATE_H
@@ -0,0 +1,51 @@
+#ifndef OPENWAKEWORD_CUSTOM_VERIFIER_H
+#define OPENWAKEWORD_CUSTOM_VERIFIER_H
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include "core/audio_processor.h"
+#include "core/model_wrapper.h"
+#include "core/types.h"
+
+namespace openwakeword {
+
+// Custom verifier postprocessor for one wake word. Its detector triggers at
+// a low candidate threshold, so the verifier only scores rare candidates, on
+// the detection collector thread; a candidate is accepted if the verifier
+// scores its feature window at or above threshold, and its score becomes the
+// verifier probability.
+class CustomVerifier : public Postprocessor {
+public:
+    CustomVerifier(const std::string& wakeWord, float threshold);
+
+    // Load the verifier model
+    bool initialize(const std::filesystem::path& modelPath,
+                    Ort::Env& env,
+                    const Ort::SessionOptions& options);
+
+    // Postprocessor interface
+    Detection process(const Detection& detection, const FeatureBuffer& features) override;
+    void processBatch(std::span<Detection* const> detections,
+                      std::span<const FeatureBuffer* const> features) override;
+    bool shouldProcess(const Detection& detection) const override {
+        return detection.modelName == wakeWord_;
+    }
+    const std::string& getName() const override { return name_; }
+
+private:
+    std::string wakeWord_;
+    std::string name_;
+    float threshold_;
+    std::unique_ptr<CustomVerifierModel> model_;
+
+    // Reused across batches
+    std::vector<const AudioFloat*> windows_;
+    std::vector<AudioFloat> scratch_;
+    std::vector<float> probabilities_;
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_CUSTOM_VERIFIER_H
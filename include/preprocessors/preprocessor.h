@@ -18,6 +18,14 @@ public:
     // Process raw samples
     virtual void process(AudioSample* samples, size_t count) = 0;
     
+    // Native frame size; PreprocessorChain only passes whole frames. 0 means
+    // any number of samples.
+    virtual size_t getFrameSize() const { return 0; }
+    
+    // False for analysers (such as VAD) that leave the audio untouched, so
+    // the chain can forward it without waiting for a whole frame
+    virtual bool modifiesAudio() const { return true; }
+    
     // Check if preprocessor is enabled
     virtual bool isEnabled() const { return enabled_; }
     virtual void setEnabled(bool enabled) { enabled_ = enabled; }
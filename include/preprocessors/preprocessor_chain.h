@@ -0,0 +1,54 @@
+#ifndef OPENWAKEWORD_PREPROCESSOR_CHAIN_H
+#define OPENWAKEWORD_PREPROCESSOR_CHAIN_H
+
+#include <memory>
+#include <span>
+#include <vector>
+#include "preprocessors/preprocessor.h"
+#include "core/types.h"
+
+namespace openwakeword {
+
+// Runs preprocessors in order on the audio input thread. Input of any size is
+// reframed to each preprocessor's native frame size through a carry buffer,
+// so every call sees whole frames and no sample is padded or dropped. Each
+// stage that modifies audio delays it by less than one of its frames;
+// analysers see whole frames but their audio is forwarded at once. Buffers
+// only grow to the largest input seen, so steady-state calls do not allocate.
+class PreprocessorChain {
+public:
+    void add(std::unique_ptr<Preprocessor> preprocessor);
+
+    bool empty() const { return stages_.empty(); }
+
+    // Run the chain; the result is valid until the next call and may be
+    // shorter or longer than the input by up to the chain latency
+    std::span<const AudioSample> process(std::span<const AudioSample> input);
+
+    // Worst-case samples held back by stages that modify audio
+    size_t getLatencySamples() const;
+
+    // Drop carried samples
+    void reset();
+
+private:
+    struct Stage {
+        std::unique_ptr<Preprocessor> preprocessor;
+        size_t frameSize = 0;
+        std::vector<AudioSample> carry;   // Partial frame, frameSize capacity
+        size_t carryFill = 0;
+        std::vector<AudioSample> output;  // Whole processed frames
+    };
+
+    std::vector<Stage> stages_;
+
+    // Feed input to an analyser, whole frames at a time
+    static void analyse(Stage& stage, std::span<const AudioSample> input);
+
+    // Process input in whole frames; returns the processed frames
+    static std::span<const AudioSample> transform(Stage& stage, std::span<const AudioSample> input);
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_PREPROCESSOR_CHAIN_H
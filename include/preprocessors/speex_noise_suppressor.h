@@ -21,9 +21,12 @@ public:
     // Process audio frame
     void process(AudioFrame& frame) override;
     
-    // Process raw samples
+    // Process raw samples in place; count must be a multiple of the frame
+    // size (PreprocessorChain reframes arbitrary input)
     void process(AudioSample* samples, size_t count) override;
     
+    size_t getFrameSize() const override { return static_cast<size_t>(frameSize_); }
+    
     // Set noise suppression level (-30 to -0 dB)
     void setSuppressionLevel(int level);
     
@@ -40,7 +43,6 @@ private:
     SpeexPreprocessState* state_ = nullptr;
     int frameSize_;
     int sampleRate_;
-    std::vector<AudioSample> processBuffer_;
     
     // Speex availability flag
     static bool checkAvailability();
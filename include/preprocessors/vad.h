@@ -6,11 +6,14 @@
 #include <vector>
 #include "preprocessors/preprocessor.h"
 #include "core/model_wrapper.h"
+#include "core/voice_activity_gate.h"
 #include "core/types.h"
 
 namespace openwakeword {
 
-// Voice Activity Detection preprocessor
+// Voice Activity Detection preprocessor. Audio passes through unchanged; it
+// is scored in VADModel::FRAME_SAMPLES frames and each decision is published
+// to the gate, if one is set.
 class VADPreprocessor : public Preprocessor {
 public:
     VADPreprocessor(float threshold = 0.5f);
@@ -26,6 +29,9 @@ public:
     // Process raw samples
     void process(AudioSample* samples, size_t count) override;
     
+    size_t getFrameSize() const override { return VADModel::FRAME_SAMPLES; }
+    bool modifiesAudio() const override { return false; }
+    
     // Get/set VAD threshold
     float getThreshold() const { return threshold_; }
     void setThreshold(float threshold) { threshold_ = threshold; }
@@ -36,15 +42,19 @@ public:
     // Check if voice is currently detected
     bool isVoiceDetected() const { return lastScore_ > threshold_; }
     
+    // Publish decisions to gate
+    void setGate(std::shared_ptr<VoiceActivityGate> gate) { gate_ = std::move(gate); }
+    
+    // Forget buffered audio and the model state
+    void reset();
+    
 private:
     std::unique_ptr<VADModel> model_;
+    std::shared_ptr<VoiceActivityGate> gate_;
     float threshold_;
     float lastScore_ = 0.0f;
-    std::vector<AudioFloat> audioBuffer_;
-    
-    // Silero VAD specific parameters
-    static constexpr size_t VAD_FRAME_SIZE = 512;  // Silero VAD frame size
-    static constexpr size_t VAD_SAMPLE_RATE = 16000;
+    std::vector<AudioFloat> audioBuffer_;  // Samples of the frame being filled
+    uint64_t samplesSeen_ = 0;
 };
 
 } // namespace openwakeword
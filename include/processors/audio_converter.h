@@ -0,0 +1,81 @@
+#ifndef OPENWAKEWORD_AUDIO_CONVERTER_H
+#define OPENWAKEWORD_AUDIO_CONVERTER_H
+
+#include <span>
+#include <vector>
+#include "core/types.h"
+
+namespace openwakeword {
+
+// Streaming input converter to the 16 kHz mono audio the models expect.
+// Interleaved 16-bit frames are first downmixed (channels averaged) or
+// reduced to one selected channel, then resampled by a polyphase
+// Kaiser-windowed sinc filter; every output sample is one dot product over
+// one filter phase. Filter history and split frames are carried between
+// calls, so audio may arrive in chunks of any size. Buffers are allocated
+// for maxInputSamples per call up front; larger calls grow them once.
+class AudioConverter {
+public:
+    // channel selects one input channel; -1 (or one out of range) averages
+    // all of them
+    AudioConverter(size_t inputRate, size_t channels, int channel = -1,
+                   size_t maxInputSamples = 8192);
+
+    // Rates from 8 to 192 kHz whose ratio to 16 kHz needs at most
+    // MAX_PHASES filter phases (8, 11.025, 22.05, 32, 44.1, 48, 96 kHz...)
+    static bool isSupportedRate(size_t inputRate);
+
+    // Convert interleaved samples; the view stays valid until the next call
+    std::span<const AudioSample> process(std::span<const AudioSample> samples);
+
+    // Input samples that yield at most outputSamples output samples
+    size_t inputForOutput(size_t outputSamples) const;
+
+    // Check if input is already 16 kHz mono and passes through unchanged
+    bool isPassthrough() const { return channels_ == 1 && !resampling_; }
+
+    size_t getInputRate() const { return inputRate_; }
+    size_t getChannels() const { return channels_; }
+
+    // Drop filter history and any split frame, e.g. between files
+    void reset();
+
+    static constexpr size_t MAX_PHASES = 640;
+    static constexpr size_t MAX_CHANNELS = 8;
+
+private:
+    // Filter half length in zero crossings of the lower of the two rates'
+    // Nyquist frequencies, and Kaiser window shape (about 80 dB stopband)
+    static constexpr size_t ZERO_CROSSINGS = 12;
+    static constexpr double KAISER_BETA = 8.0;
+
+    size_t inputRate_;
+    size_t channels_;
+    int channel_;
+    bool resampling_;
+
+    // Output rate / input rate = upFactor_ / downFactor_
+    size_t upFactor_ = 1;
+    size_t downFactor_ = 1;
+    size_t tapsPerPhase_ = 1;
+    std::vector<float> phases_;  // upFactor_ phases of tapsPerPhase_ taps, time-reversed
+
+    // Mono input: tapsPerPhase_ - 1 samples of history, then new samples
+    std::vector<float> history_;
+    size_t historySize_ = 0;
+    size_t nextInput_ = 0;  // Newest input sample of the next output
+    size_t nextPhase_ = 0;
+
+    // Samples of a frame split between calls
+    std::vector<AudioSample> partialFrame_;
+
+    std::vector<AudioSample> output_;
+
+    void designFilter();
+    void downmix(const AudioSample* frames, size_t frameCount, float* out) const;
+    size_t resample(AudioSample* out);
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_AUDIO_CONVERTER_H
@@ -1,10 +1,15 @@
 #ifndef OPENWAKEWORD_AUDIO_READER_H
 #define OPENWAKEWORD_AUDIO_READER_H
 
+#include <compare>
+#include <cstdint>
 #include <cstdio>
 #include <memory>
+#include <span>
+#include <string>
 #include <vector>
 #include "core/types.h"
+#include "utils/mapped_file.h"
 
 namespace openwakeword {
 
@@ -36,25 +41,161 @@ private:
     bool eof_ = false;
 };
 
-// WAV file audio reader (for future batch processing)
+// WAV file audio reader for 16-bit PCM files (used by offline batch mode)
 class WavFileReader : public AudioReader {
 public:
     explicit WavFileReader(const std::string& filename);
     ~WavFileReader();
     
+    WavFileReader(const WavFileReader&) = delete;
+    WavFileReader& operator=(const WavFileReader&) = delete;
+    
+    // Read interleaved samples (samples counts values, not frames)
     size_t read(AudioSample* buffer, size_t samples) override;
     bool hasMore() const override;
     size_t getSampleRate() const override { return sampleRate_; }
     
+    // Check if the file opened and has a supported header
+    bool isOpen() const { return headerParsed_; }
+    
+    size_t getChannels() const { return channels_; }
+    
+    // Total samples per channel in the data chunk
+    size_t getTotalSamples() const { return totalSamples_; }
+    
 private:
     FILE* file_ = nullptr;
     size_t sampleRate_ = SAMPLE_RATE;
+    size_t channels_ = 1;
+    size_t totalSamples_ = 0;
     size_t remainingSamples_ = 0;
     bool headerParsed_ = false;
     
     bool parseHeader();
 };
 
+// Memory-mapped reader for 16-bit PCM WAV files or headerless 16 kHz mono
+// PCM. A file without a RIFF header is read as PCM only if it is named .raw
+// or .pcm or raw is set, so a mislabeled file is an error rather than noise.
+// Samples are exposed in place through next(), so offline scoring reads
+// large corpora without copying them.
+class MappedAudioReader : public AudioReader {
+public:
+    explicit MappedAudioReader(const std::string& filename, bool raw = false);
+    ~MappedAudioReader();
+    
+    MappedAudioReader(const MappedAudioReader&) = delete;
+    MappedAudioReader& operator=(const MappedAudioReader&) = delete;
+    
+    // Copying read, for the AudioReader interface
+    size_t read(AudioSample* buffer, size_t samples) override;
+    bool hasMore() const override { return position_ < samples_.size(); }
+    size_t getSampleRate() const override { return sampleRate_; }
+    
+    // Zero-copy read: the next (up to) maxSamples interleaved samples. The
+    // view stays valid for the lifetime of the reader.
+    std::span<const AudioSample> next(size_t maxSamples);
+    
+    // All samples of the file
+    std::span<const AudioSample> samples() const { return samples_; }
+    
+    // Check if the file mapped and has a supported header
+    bool isOpen() const { return open_; }
+    
+    size_t getChannels() const { return channels_; }
+    
+    // Total samples per channel
+    size_t getTotalSamples() const { return samples_.size() / channels_; }
+    
+private:
+    MappedFile mapping_;
+    std::span<const AudioSample> samples_;
+    std::vector<AudioSample> unaligned_;  // Copy used if the data chunk is misaligned
+    size_t position_ = 0;
+    size_t sampleRate_ = SAMPLE_RATE;
+    size_t channels_ = 1;
+    bool open_ = false;
+    
+    bool parseHeader(bool raw);
+};
+
+// Reader for a connected stream socket (Unix domain or TCP) carrying raw
+// 16 kHz mono little-endian PCM. Data is received straight into the caller's
+// buffer; a sample split between two segments is carried to the next read.
+// Owns the descriptor. On a non-blocking socket read() returns 0 while no
+// data is pending, without ending the stream.
+class SocketAudioReader : public AudioReader {
+public:
+    explicit SocketAudioReader(int fd) : fd_(fd) {}
+    ~SocketAudioReader();
+    
+    SocketAudioReader(const SocketAudioReader&) = delete;
+    SocketAudioReader& operator=(const SocketAudioReader&) = delete;
+    
+    size_t read(AudioSample* buffer, size_t samples) override;
+    bool hasMore() const override { return !eof_; }
+    
+    int getDescriptor() const { return fd_; }
+    
+private:
+    int fd_;
+    bool eof_ = false;
+    bool hasPartial_ = false;
+    uint8_t partial_ = 0;
+};
+
+// Sender of a datagram: IPv4 address and port (host byte order) plus the
+// RTP synchronization source (0 for raw PCM)
+struct DatagramSource {
+    uint32_t address = 0;
+    uint16_t port = 0;
+    uint32_t ssrc = 0;
+    
+    auto operator<=>(const DatagramSource&) const = default;
+    
+    std::string toString() const;
+};
+
+// Reader for a bound UDP socket receiving RTP/L16 (RFC 3551, 16 kHz mono,
+// network byte order) or raw little-endian PCM datagrams. Each read()
+// receives one datagram: the fixed RTP header is scattered into the reader
+// while the payload lands straight in the caller's buffer, where it is
+// converted to host order in place. The buffer should hold the largest
+// expected payload; longer datagrams are truncated. Datagrams that are not
+// valid RTP are skipped (read returns 0). Owns the descriptor.
+class DatagramAudioReader : public AudioReader {
+public:
+    DatagramAudioReader(int fd, bool rtp) : fd_(fd), rtp_(rtp) {}
+    ~DatagramAudioReader();
+    
+    DatagramAudioReader(const DatagramAudioReader&) = delete;
+    DatagramAudioReader& operator=(const DatagramAudioReader&) = delete;
+    
+    size_t read(AudioSample* buffer, size_t samples) override;
+    bool hasMore() const override { return !failed_; }
+    
+    // Sender and RTP sequence number of the last datagram read
+    const DatagramSource& getSource() const { return source_; }
+    uint16_t getSequence() const { return sequence_; }
+    bool isRtp() const { return rtp_; }
+    
+    // Check if the last read found no datagram waiting
+    bool wouldBlock() const { return wouldBlock_; }
+    
+    int getDescriptor() const { return fd_; }
+    
+private:
+    static constexpr size_t RTP_HEADER_SIZE = 12;
+    
+    int fd_;
+    bool rtp_;
+    bool failed_ = false;
+    bool wouldBlock_ = false;
+    uint8_t header_[RTP_HEADER_SIZE] = {};
+    DatagramSource source_;
+    uint16_t sequence_ = 0;
+};
+
 } // namespace openwakeword
 
 #endif // OPENWAKEWORD_AUDIO_READER_H
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef OPENWAKEWORD_CASCADE_STAGE_H
+#define OPENWAKEWORD_CASCADE_STAGE_H
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include "core/model_wrapper.h"
+#include "core/types.h"
+
+namespace openwakeword {
+
+// First stage of the detector cascade: a cheap check run once per feature
+// window that decides whether the full wake word models need to run. With a
+// model, the window is scored by that small wake word model; otherwise the
+// newest embedding is compared with a slowly updated background embedding
+// and the stage opens when speech moves it away from the background.
+class CascadeStage {
+public:
+    // threshold is the model score, or the cosine distance from the
+    // background, at which the stage opens
+    explicit CascadeStage(float threshold) : threshold_(threshold) {}
+
+    // Load the first-stage model; without one the distance check is used
+    bool initialize(const std::filesystem::path& modelPath, Ort::Env& env,
+                    const Ort::SessionOptions& options);
+
+    // Check whether a WAKEWORD_FEATURES x EMBEDDING_FEATURES window may
+    // contain a wake word
+    bool isOpen(const AudioFloat* window);
+
+    void reset() { background_.clear(); }
+
+    bool hasModel() const { return model_ != nullptr; }
+
+private:
+    // Background embedding time constant, in windows (80 ms each)
+    static constexpr float BACKGROUND_WINDOWS = 32.0f;
+
+    float threshold_;
+    std::unique_ptr<WakeWordModel> model_;
+    std::vector<float> background_;
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_CASCADE_STAGE_H
@@ -0,0 +1,74 @@
+#ifndef OPENWAKEWORD_DETECTOR_GROUP_H
+#define OPENWAKEWORD_DETECTOR_GROUP_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "core/broadcast_ring_buffer.h"
+#include "core/model_wrapper.h"
+#include "core/types.h"
+#include "processors/cascade_stage.h"
+#include "processors/wake_word_detector.h"
+#include "utils/config.h"
+#include "utils/metrics.h"
+
+namespace openwakeword {
+
+// Runs many wake word detectors from a single thread. Each step reads the
+// shared 16x96 feature window once and runs every distinct model on it in one
+// pass; detectors backed by the same merged multi-output model share a
+// single inference call.
+//
+// With a cascade, a cheap first stage checks every window and each model
+// runs only while the first stage is open, or while that model's own recent
+// scores are near its threshold; the rest of the time its detectors skip
+// the window without inference. Detectors with an overload limit (see
+// WakeWordDetector::setOverloadLimit) skip their model likewise while the
+// group has fallen that many windows behind.
+class DetectorGroup {
+public:
+    // Add a detector (not owned); detectors sharing a model are batched
+    void addDetector(WakeWordDetector* detector);
+    
+    // Gate the models behind first; a model keeps running for holdSteps
+    // windows after first opens or after it scores at least margin times
+    // the threshold of one of its detectors
+    void setCascade(std::unique_ptr<CascadeStage> first, float margin, size_t holdSteps);
+    
+    // Record per-model inference times, every detector's detections and the
+    // group's step deadlines; call after adding the detectors
+    void setMetrics(Metrics& metrics);
+    
+    // Number of inference calls made per step
+    size_t numModels() const { return slots_.size(); }
+    
+    // Thread entry point
+    void run(std::shared_ptr<BroadcastRingBuffer<AudioFloat>> input,
+             size_t readerId,
+             std::mutex& outputMutex,
+             OutputMode outputMode,
+             bool showTimestamp);
+    
+private:
+    struct ModelSlot {
+        std::shared_ptr<WakeWordModel> model;
+        std::vector<WakeWordDetector*> detectors;
+        std::vector<float> scores;
+        LatencyHistogram* inferenceTime = nullptr;
+        size_t hold = 0;  // Cascade: windows left to run the model on
+        size_t maxBacklog = 0;  // Overload: smallest limit of its detectors, 0 if one has none
+    };
+    
+    std::vector<ModelSlot> slots_;
+    Metrics* metrics_ = nullptr;
+    uint64_t steps_ = 0;
+    
+    std::unique_ptr<CascadeStage> cascade_;
+    float cascadeMargin_ = 0.0f;
+    size_t cascadeHold_ = 0;
+    LatencyHistogram* cascadeTime_ = nullptr;
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_DETECTOR_GROUP_H
@@ -5,10 +5,12 @@
 #include <memory>
 #include <vector>
 #include "core/audio_processor.h"
+#include "core/mel_frontend.h"
 #include "core/model_wrapper.h"
 #include "core/types.h"
-#include "core/thread_safe_buffer.h"
+#include "core/spsc_ring_buffer.h"
 #include "utils/config.h"
+#include "utils/metrics.h"
 
 namespace openwakeword {
 
@@ -20,27 +22,46 @@ public:
     // Set model path
     void setModelPath(const std::filesystem::path& path) { modelPath_ = path; }
     
+    // CPU options to load with if options' execution providers fail
+    void setFallbackOptions(const Ort::SessionOptions* cpuFallback) { cpuFallback_ = cpuFallback; }
+    
     // Set frame size
     void setFrameSize(size_t frameSize) { frameSize_ = frameSize; }
     
+    // Use an already created frontend instead of loading the model
+    void setFrontend(std::unique_ptr<MelFrontend> frontend) { frontend_ = std::move(frontend); }
+    
+    // Keep STFT context across frames and emit mels every 80 ms, however
+    // the input is chunked
+    void setStreaming(bool streaming) { streaming_ = streaming; }
+    
+    // Record the time of every frontend call
+    void setMetrics(LatencyHistogram* inferenceTime) { inferenceTime_ = inferenceTime; }
+    
     // AudioProcessor interface
     bool initialize() override;
     bool process() override;
     void reset() override;
     
     // Thread entry point
-    void run(std::shared_ptr<ThreadSafeBuffer<AudioFloat>> input,
-             std::shared_ptr<ThreadSafeBuffer<AudioFloat>> output,
+    void run(std::shared_ptr<SpscRingBuffer<AudioFloat>> input,
+             std::shared_ptr<SpscRingBuffer<AudioFloat>> output,
              OutputMode outputMode);
     
 private:
     Ort::Env& env_;
     const Ort::SessionOptions& options_;
+    const Ort::SessionOptions* cpuFallback_ = nullptr;
     std::filesystem::path modelPath_;
     size_t frameSize_ = 4 * CHUNK_SAMPLES;
     
-    std::unique_ptr<MelSpectrogramModel> model_;
-    std::vector<AudioFloat> todoSamples_;
+    std::unique_ptr<MelFrontend> frontend_;
+    bool streaming_ = false;
+    LatencyHistogram* inferenceTime_ = nullptr;
+    std::unique_ptr<MelStreamer> streamer_;
+    MelBuffer streamedMels_;
+    std::vector<AudioFloat> frameSamples_;  // Filled in place, one frame at a time
+    size_t frameFill_ = 0;
 };
 
 } // namespace openwakeword
@@ -7,8 +7,12 @@
 #include "core/audio_processor.h"
 #include "core/model_wrapper.h"
 #include "core/types.h"
-#include "core/thread_safe_buffer.h"
+#include "core/broadcast_ring_buffer.h"
+#include "core/sliding_window.h"
+#include "core/spsc_ring_buffer.h"
+#include "core/voice_activity_gate.h"
 #include "utils/config.h"
+#include "utils/metrics.h"
 
 namespace openwakeword {
 
@@ -21,24 +25,85 @@ public:
     // Set model path
     void setModelPath(const std::filesystem::path& path) { modelPath_ = path; }
     
+    // CPU options to load with if options' execution providers fail
+    void setFallbackOptions(const Ort::SessionOptions* cpuFallback) { cpuFallback_ = cpuFallback; }
+    
+    // Audio samples per mel frame, mapping windows back to audio positions
+    void setSamplesPerMel(double samplesPerMel) { samplesPerMel_ = samplesPerMel; }
+    
+    // Skip windows while gate is closed
+    void setGate(std::shared_ptr<VoiceActivityGate> gate) { gate_ = std::move(gate); }
+    
+    // Record inference times, and the audio position of every embedding
+    void setMetrics(LatencyHistogram* inferenceTime, AudioClock* clock) {
+        inferenceTime_ = inferenceTime;
+        clock_ = clock;
+    }
+    
+    // Drop-audio overload policy: while more than maxBacklogFrames mel
+    // frames wait to be embedded, skip the oldest windows without inference
+    // (0 never skips). Skips are counted in metrics unless null.
+    void setOverloadLimit(size_t maxBacklogFrames, Metrics* metrics) {
+        maxBacklogFrames_ = maxBacklogFrames;
+        overloadMetrics_ = metrics;
+    }
+    
+    // Embedding windows computed, skipped by the gate and skipped under overload
+    uint64_t getComputedWindows() const { return computedWindows_; }
+    uint64_t getSkippedWindows() const { return skippedWindows_; }
+    uint64_t getOverloadSkippedWindows() const { return overloadSkippedWindows_; }
+    
     // AudioProcessor interface
     bool initialize() override;
     bool process() override;
     void reset() override;
     
     // Thread entry point
-    void run(std::shared_ptr<ThreadSafeBuffer<AudioFloat>> input,
-             std::vector<std::shared_ptr<ThreadSafeBuffer<AudioFloat>>> outputs,
+    void run(std::shared_ptr<SpscRingBuffer<AudioFloat>> input,
+             std::shared_ptr<BroadcastRingBuffer<AudioFloat>> output,
              OutputMode outputMode);
     
 private:
     Ort::Env& env_;
     const Ort::SessionOptions& options_;
+    const Ort::SessionOptions* cpuFallback_ = nullptr;
     std::filesystem::path modelPath_;
     size_t numWakeWords_;
     
     std::unique_ptr<EmbeddingModel> model_;
-    std::vector<AudioFloat> todoMels_;
+    SlidingWindow<AudioFloat> todoMels_;  // Mel frames, contiguous window view
+    std::vector<AudioFloat> pullBuffer_;
+    
+    // Gating; up to WAKEWORD_FEATURES - 1 skipped windows are held back so
+    // they can be computed when speech starts
+    std::shared_ptr<VoiceActivityGate> gate_;
+    double samplesPerMel_ = MEL_HOP_SAMPLES;
+    size_t heldWindows_ = 0;
+    uint64_t consumedMels_ = 0;
+    uint64_t computedWindows_ = 0;
+    uint64_t skippedWindows_ = 0;
+    
+    // Overload shedding
+    size_t maxBacklogFrames_ = 0;
+    uint64_t overloadSkippedWindows_ = 0;
+    Metrics* overloadMetrics_ = nullptr;
+    
+    LatencyHistogram* inferenceTime_ = nullptr;
+    AudioClock* clock_ = nullptr;
+    
+    // Audio position at which the window at mel frame offset is complete
+    uint64_t windowEnd(size_t offset) const {
+        auto frames = consumedMels_ + offset + EMBEDDING_WINDOW_SIZE;
+        return static_cast<uint64_t>(static_cast<double>(frames) * samplesPerMel_);
+    }
+    
+    void consumeMels(size_t frames) {
+        todoMels_.consume(frames);
+        consumedMels_ += frames;
+    }
+    
+    // Compute and publish the embedding of the window at mel frame offset
+    void publishWindow(size_t offset, BroadcastRingBuffer<AudioFloat>& output);
 };
 
 } // namespace openwakeword
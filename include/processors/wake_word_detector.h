@@ -12,102 +12,140 @@
 #include "core/audio_processor.h"
 #include "core/model_wrapper.h"
 #include "core/types.h"
-#include "core/thread_safe_buffer.h"
+#include "core/broadcast_ring_buffer.h"
+#include "core/detection_collector.h"
 #include "utils/config.h"
+#include "utils/metrics.h"
 
 namespace openwakeword {
 
 // Configuration for wake word detection
 struct WakeWordConfig {
+    std::string name;  // Wake word name: the model's stem as given, before precision variants
     std::filesystem::path modelPath;
     float threshold = 0.5f;
     int triggerLevel = 4;    // Number of consecutive activations needed
     int refractorySteps = 20; // Steps to wait after activation
     bool debug = false;
+    std::vector<std::string> providers;  // Execution providers by preference; empty for CPU
+    std::filesystem::path verifierModelPath;  // Custom verifier confirming detections, if any
+    bool deferRefractory = false;  // Triggers are candidates; the collector starts refractory on accept
 };
 
+// Trigger-level and refractory tracking shared by every detection path
+class ActivationTracker {
+public:
+    explicit ActivationTracker(const WakeWordConfig& config)
+        : threshold_(config.threshold), triggerLevel_(config.triggerLevel),
+          refractorySteps_(config.refractorySteps), deferRefractory_(config.deferRefractory) {}
+    
+    // Feed one prediction; returns true when a detection triggers. With
+    // deferRefractory, every further activation while at the trigger level
+    // is another candidate, and no refractory period is entered.
+    bool update(float probability);
+    
+    void reset() { activationCount_ = 0; }
+    
+private:
+    float threshold_;
+    int triggerLevel_;
+    int refractorySteps_;
+    bool deferRefractory_;
+    int activationCount_ = 0;
+};
+
+// Print a detection to stdout in the selected output mode. The caller must
+// hold the output mutex and flush stdout. A non-empty source (e.g. a stream
+// name) is included.
+void printDetection(const std::string& wakeWord, float probability,
+                    OutputMode outputMode, bool showTimestamp,
+                    const std::string& source = "");
+
 // Wake word detector processor
 class WakeWordDetector : public AudioProcessor {
 public:
     WakeWordDetector(const std::string& wakeWord, const WakeWordConfig& config,
                      Ort::Env& env, const Ort::SessionOptions& options);
     
+    // Detector driven by one score output of an already loaded (merged) model
+    WakeWordDetector(const std::string& wakeWord, const WakeWordConfig& config,
+                     std::shared_ptr<WakeWordModel> model, size_t scoreIndex,
+                     Ort::Env& env, const Ort::SessionOptions& options);
+    
     // AudioProcessor interface
     bool initialize() override;
     bool process() override;
     void reset() override;
     
-    // Thread entry point
-    template<typename BufferType>
-    void run(std::shared_ptr<BufferType> input,
+    // Thread entry point: reads 16-embedding windows in place from the
+    // shared embedding ring using this detector's reader cursor
+    void run(std::shared_ptr<BroadcastRingBuffer<AudioFloat>> input,
+             size_t readerId,
              std::mutex& outputMutex,
              OutputMode outputMode,
              bool showTimestamp);
     
+    // Process a single prediction of the window features (which are passed
+    // on to postprocessors with a detection)
+    void processPrediction(float probability, std::mutex& outputMutex,
+                          OutputMode outputMode, bool showTimestamp,
+                          const AudioFloat* features = nullptr);
+    
+    // Account for a window the model was not run on (see DetectorGroup's
+    // cascade), as a score of zero: activations decay and the refractory
+    // period counts down, with nothing posted
+    void skipPrediction();
+    
+    // Skip-steps and reduce-models overload policies: while more than
+    // maxBacklog windows behind, skip windows without inference (0 never
+    // skips). A detector group applies this per model.
+    void setOverloadLimit(size_t maxBacklog) { maxBacklog_ = maxBacklog; }
+    size_t getOverloadLimit() const { return maxBacklog_; }
+    
+    // CPU options to load with if options' execution providers fail
+    void setFallbackOptions(const Ort::SessionOptions* cpuFallback) { cpuFallback_ = cpuFallback; }
+    
     // Get configuration
     const WakeWordConfig& getConfig() const { return config_; }
     
+    // Record detections, and the inference time of run() unless null
+    void setMetrics(Metrics* metrics, LatencyHistogram* inferenceTime) {
+        metrics_ = metrics;
+        inferenceTime_ = inferenceTime;
+    }
+    
+    // Post scores and detections to a collector instead of printing them
+    void setCollector(DetectionCollector* collector, uint32_t id) {
+        collector_ = collector;
+        collectorId_ = id;
+    }
+    
+    // Get the model and which of its score outputs this detector uses
+    std::shared_ptr<WakeWordModel> getModel() const { return model_; }
+    size_t getScoreIndex() const { return scoreIndex_; }
+    
 private:
     std::string wakeWord_;
     WakeWordConfig config_;
     Ort::Env& env_;
     const Ort::SessionOptions& options_;
+    const Ort::SessionOptions* cpuFallback_ = nullptr;
     
-    std::unique_ptr<WakeWordModel> model_;
-    std::vector<AudioFloat> todoFeatures_;
+    std::shared_ptr<WakeWordModel> model_;
+    size_t scoreIndex_ = 0;
     
     // Activation tracking
-    int activationCount_ = 0;
+    ActivationTracker activation_;
     
-    // Process a single prediction
-    void processPrediction(float probability, std::mutex& outputMutex,
-                          OutputMode outputMode, bool showTimestamp);
-};
-
-// Template implementation
-template<typename BufferType>
-void WakeWordDetector::run(std::shared_ptr<BufferType> input,
-                          std::mutex& outputMutex,
-                          OutputMode outputMode,
-                          bool showTimestamp) {
-    if (!initialized_) {
-        if (outputMode != OutputMode::QUIET) {
-            std::cerr << "[ERROR] WakeWordDetector not initialized: " << wakeWord_ << std::endl;
-        }
-        return;
-    }
+    DetectionCollector* collector_ = nullptr;
+    uint32_t collectorId_ = 0;
     
-    while (true) {
-        // Get features from input buffer
-        auto features = input->pull();
-        if (input->isExhausted() && features.empty()) {
-            break;
-        }
-        
-        // Accumulate features
-        todoFeatures_.insert(todoFeatures_.end(), features.begin(), features.end());
-        
-        // Process when we have enough features
-        size_t numBufferedFeatures = todoFeatures_.size() / EMBEDDING_FEATURES;
-        while (numBufferedFeatures >= WAKEWORD_FEATURES) {
-            // Extract features for one prediction
-            FeatureBuffer windowFeatures(todoFeatures_.begin(),
-                                       todoFeatures_.begin() + (WAKEWORD_FEATURES * EMBEDDING_FEATURES));
-            
-            // Run wake word detection
-            float probability = model_->predict(windowFeatures);
-            
-            // Process the prediction
-            processPrediction(probability, outputMutex, outputMode, showTimestamp);
-            
-            // Remove one embedding worth of features
-            todoFeatures_.erase(todoFeatures_.begin(),
-                               todoFeatures_.begin() + EMBEDDING_FEATURES);
-            
-            numBufferedFeatures = todoFeatures_.size() / EMBEDDING_FEATURES;
-        }
-    }
-}
+    Metrics* metrics_ = nullptr;
+    LatencyHistogram* inferenceTime_ = nullptr;
+    uint64_t windowsScored_ = 0;
+    
+    size_t maxBacklog_ = 0;
+};
 
 } // namespace openwakeword
 
@@ -3,6 +3,7 @@
 
 #include <filesystem>
 #include <string>
+#include <utility>
 #include <vector>
 #include <onnxruntime_cxx_api.h>
 #include "core/types.h"
@@ -25,6 +26,24 @@ enum class OutputMode {
     JSON
 };
 
+// ONNX Runtime graph optimization levels
+enum class GraphOptimization {
+    DISABLED,
+    BASIC,
+    EXTENDED,
+    ALL
+};
+
+// Numeric precision of the embedding and wake word models. Variants live
+// next to the FP32 file as <stem>_int8.onnx and <stem>_fp16.onnx; AUTO picks
+// INT8 when present, then FP16 on CPUs with native half arithmetic.
+enum class ModelPrecision {
+    FP32,
+    INT8,
+    FP16,
+    AUTO
+};
+
 // Parse result to distinguish between errors and informational exits
 enum class ParseResult {
     SUCCESS,        // Continue running
@@ -38,11 +57,44 @@ struct Config {
     std::filesystem::path melModelPath = "models/melspectrogram.onnx";
     std::filesystem::path embModelPath = "models/embedding_model.onnx";
     std::vector<std::filesystem::path> wakeWordModelPaths;
+    ModelPrecision modelPrecision = ModelPrecision::FP32;  // Applied once parsing completes
+    
+    // Mel spectrogram frontend; verifyMel checks the native one against the model
+    MelFrontendType melFrontend = MelFrontendType::ONNX;
+    bool verifyMel = false;
+    float melTolerance = 1e-3f;  // Maximum difference in rescaled mel units
+    bool streamingMel = false;   // Keep STFT context and emit mels every 80 ms
+    
+    // Input format (see AudioConverter): other rates are resampled and
+    // several channels downmixed, or one selected, to 16 kHz mono. WAV
+    // files in offline mode carry their own rate and channel count.
+    size_t inputSampleRate = SAMPLE_RATE;
+    size_t inputChannels = 1;
+    int inputChannel = -1;            // Channel to use; -1 averages all of them
+    
+    // Interleaved input samples carrying samples16k samples at 16 kHz
+    size_t inputSamplesFor(size_t samples16k) const {
+        return samples16k * inputSampleRate / SAMPLE_RATE * inputChannels;
+    }
+    bool convertsInput() const { return inputSampleRate != SAMPLE_RATE || inputChannels != 1; }
     
     // Processing parameters
     size_t frameSize = 4 * CHUNK_SAMPLES;
     size_t stepFrames = 4;
     
+    // Inter-stage buffering
+    size_t bufferMilliseconds = 2000;  // Audio held by each stage buffer
+    WaitPolicy bufferWaitPolicy = WaitPolicy::BLOCKING;
+    
+    // Real-time mode: wake word steps are timed against deadlineMs from the
+    // arrival of their audio, and overloadPolicy says what to give up when
+    // the pipeline falls that far behind
+    bool realTime = false;
+    size_t deadlineMs = 200;
+    OverloadPolicy overloadPolicy = OverloadPolicy::BLOCK;
+    size_t overloadModels = 1;        // Reduce-models: wake words kept running, in order
+    int realtimePriority = 0;         // SCHED_FIFO priority of the stage threads; 0 leaves them normal
+    
     // Detection parameters (default for all models)
     float threshold = 0.5f;
     int triggerLevel = 4;
@@ -51,11 +103,53 @@ struct Config {
     // Per-model configurations
     std::vector<WakeWordConfig> wakeWordConfigs;
     
+    // Run all detectors from one thread, sharing each step's feature window
+    bool groupDetectors = false;
+    
+    // Cascade (implies groupDetectors): a cheap first stage checks every
+    // window and the wake word models run only near a detection
+    bool cascade = false;
+    std::filesystem::path cascadeModelPath;  // First-stage model; empty for an embedding distance check
+    float cascadeThreshold = 0.1f;    // First-stage score or distance that wakes the models
+    float cascadeMargin = 0.5f;       // Models keep running above this fraction of their threshold
+    size_t cascadeHoldSteps = 8;      // Windows models run for after being woken
+    
+    // Multi-stream server mode: raw 16 kHz PCM inputs served by one engine
+    std::vector<std::string> streamInputs;
+    
+    // Network inputs for multi-stream mode (see NetworkIngest): every
+    // connection to the Unix socket and every RTP source on the UDP port is
+    // a stream of its own
+    std::filesystem::path listenUnixPath;
+    std::string listenUdp;            // [HOST:]PORT; loopback unless HOST is given
+    bool udpRaw = false;              // Datagrams are raw PCM instead of RTP/L16
+    size_t streamTimeoutMs = 5000;    // UDP sources silent this long are closed
+    size_t maxNetworkStreams = 64;    // Further connections and sources are refused
+    size_t workerThreads = 1;
+    size_t maxBatchSize = 16;
+    
+    // Mic array mode: each input's inputChannels channels are detected on
+    // separately, batched together, and their scores fused per window
+    bool micArray = false;
+    ChannelFusion channelFusion = ChannelFusion::MAX;
+    
+    // Dynamic batching of embedding windows across streams
+    size_t embeddingBatchSize = 32;
+    size_t batchWaitMicros = 1000;  // Longest a pending window waits for a fuller batch
+    
+    // Offline batch mode: WAV files or directories processed as fast as possible
+    std::vector<std::filesystem::path> offlineInputs;
+    std::filesystem::path offlineFileList;  // Text file with one WAV path per line
+    bool offlineRaw = false;          // Files without a RIFF header are PCM whatever their name
+    std::filesystem::path embeddingCacheDir;  // Embeddings written once, replayed on rescoring
+    
     // Feature flags
     bool debug = false;
     bool enableVAD = false;
     float vadThreshold = 0.5f;
     std::filesystem::path vadModelPath = "models/silero_vad.onnx";
+    bool vadGate = false;             // Skip embedding/wake word inference without speech
+    size_t vadHangoverMs = 2000;      // Gate stays open this long after speech
     
     bool enableNoiseSuppression = false;
     
@@ -64,13 +158,40 @@ struct Config {
     bool showTimestamp = false;
     bool jsonOutput = false;
     
-    // Advanced options
+    // Monitoring
+    int metricsPort = 0;              // Prometheus endpoint; 0 disables
+    std::string metricsHost = "127.0.0.1";  // Address the endpoint binds (IPv4)
+    size_t statsIntervalSeconds = 0;  // Periodic JSON stats on stderr; 0 disables
+    
+    // Custom verifiers (see CustomVerifier): wake words with one trigger at
+    // customVerifierThreshold and are confirmed by the verifier against
+    // their own threshold
     bool enableCustomVerifiers = false;
     float customVerifierThreshold = 0.1f;
+    std::vector<std::pair<std::string, std::filesystem::path>> customVerifierModels;
     
     // ONNX Runtime configuration
     int intraOpNumThreads = 1;
     int interOpNumThreads = 1;
+    bool globalThreadPool = false;    // Sessions share process-wide pools of the above sizes
+    GraphOptimization graphOptimization = GraphOptimization::ALL;
+    bool parallelExecution = false;   // Run independent graph nodes on the inter-op pool
+    std::filesystem::path modelCacheDir;  // Optimized models saved here and reused at startup
+    size_t loadThreads = 0;           // Models loaded in parallel; 0 for one per CPU
+    bool shareModels = false;         // One memory-mapped session per model file per process
+    
+    // Execution providers per model, in order of preference ("cuda", "cuda:1",
+    // "xnnpack", "coreml", "nnapi", "cpu"); the CPU runs whatever they cannot.
+    // modelProviders override wakeWordProviders for the named wake words.
+    std::vector<std::string> melProviders;
+    std::vector<std::string> embeddingProviders;
+    std::vector<std::string> wakeWordProviders;
+    std::vector<std::pair<std::string, std::vector<std::string>>> modelProviders;
+    
+    // CPUs the pipeline's stage threads are pinned to; empty leaves them unpinned
+    std::vector<int> melCpus;
+    std::vector<int> embeddingCpus;
+    std::vector<int> detectorCpus;    // Detector threads are spread across these
     
     // Parse command line arguments
     ParseResult parseArgs(int argc, char* argv[]);
@@ -93,9 +214,16 @@ struct Config {
     // Save configuration to file
     bool saveToFile(const std::filesystem::path& configPath) const;
     
+    // Path of the precision variant of model (model itself for FP32)
+    static std::filesystem::path modelVariant(const std::filesystem::path& model,
+                                              ModelPrecision precision);
+    
 private:
     // Helper to ensure argument exists
     static bool ensureArg(int argc, char* argv[], int& index);
+    
+    // Point the embedding and wake word model paths at their modelPrecision variants
+    void selectModelVariants();
 };
 
 } // namespace openwakeword
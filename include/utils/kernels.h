@@ -0,0 +1,44 @@
+#ifndef OPENWAKEWORD_KERNELS_H
+#define OPENWAKEWORD_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace openwakeword {
+namespace kernels {
+
+// Vectorized elementwise kernels. The best implementation for the running
+// CPU (AVX2 or SSE2 on x86, NEON on ARM, scalar otherwise) is picked once at
+// first use. Results are bit-identical to the scalar loops they replace.
+// Output buffers must be preallocated; in and out may alias exactly.
+
+// out[i] = float(in[i]), no normalization
+void convertInt16ToFloat(const int16_t* in, float* out, size_t count);
+
+// out[i] = in[i] / divisor + offset
+void divideAdd(const float* in, float* out, size_t count, float divisor, float offset);
+
+// out[i] = in[i] * scale + offset (multiply and add are rounded separately)
+void multiplyAdd(const float* in, float* out, size_t count, float scale, float offset);
+
+// sum of a[i] * b[i]. Products are accumulated in eight interleaved lanes
+// (lane i % 8) that are then added pairwise, with the tail after the last
+// full group of eight added in order, so every kernel set rounds alike
+float dotProduct(const float* a, const float* b, size_t count);
+
+// IEEE 754 half precision conversion, stored as raw uint16_t bits; floats
+// are rounded to nearest even, overflowing to infinity
+void floatToHalf(const float* in, uint16_t* out, size_t count);
+void halfToFloat(const uint16_t* in, float* out, size_t count);
+
+// True when the CPU computes in half precision natively (ARMv8.2 FP16), so
+// FP16 models run faster rather than through conversions
+bool hasNativeHalfArithmetic();
+
+// Name of the selected instruction set, e.g. "avx2"
+const char* activeKernelSet();
+
+} // namespace kernels
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_KERNELS_H
@@ -0,0 +1,43 @@
+#ifndef OPENWAKEWORD_MAPPED_FILE_H
+#define OPENWAKEWORD_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace openwakeword {
+
+// Read-only memory mapping of a whole file (mmap, or a file mapping on
+// Windows). Empty files cannot be mapped.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map filename; sequential hints that it is read front to back once.
+    // Returns false if the file could not be opened or mapped.
+    bool open(const std::string& filename, bool sequential = false);
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    std::span<const uint8_t> bytes() const { return {data_, size_}; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_MAPPED_FILE_H
@@ -0,0 +1,209 @@
+#ifndef OPENWAKEWORD_METRICS_H
+#define OPENWAKEWORD_METRICS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace openwakeword {
+
+// Lock-free latency histogram with fixed buckets from 50 us to 1 s. Recording
+// is a few relaxed atomic increments, cheap enough for every inference call.
+class LatencyHistogram {
+public:
+    static constexpr size_t NUM_BOUNDS = 14;
+
+    // Bucket upper bounds, in seconds
+    static constexpr std::array<double, NUM_BOUNDS> BOUNDS = {
+        50e-6, 100e-6, 250e-6, 500e-6, 1e-3, 2.5e-3, 5e-3,
+        10e-3, 25e-3, 50e-3, 100e-3, 250e-3, 500e-3, 1.0};
+
+    struct Snapshot {
+        std::array<uint64_t, NUM_BOUNDS + 1> buckets{};  // Last bucket is +Inf
+        uint64_t count = 0;
+        double sum = 0.0;  // Seconds
+
+        double mean() const { return count > 0 ? sum / static_cast<double>(count) : 0.0; }
+
+        // Upper bound of the bucket holding quantile q (0-1)
+        double quantile(double q) const;
+    };
+
+    void record(std::chrono::nanoseconds elapsed);
+    Snapshot snapshot() const;
+
+private:
+    std::array<std::atomic<uint64_t>, NUM_BOUNDS + 1> buckets_{};
+    std::atomic<uint64_t> sumNanos_{0};
+};
+
+// Records the lifetime of the scope into a histogram; a null histogram
+// disables timing
+class ScopedTimer {
+public:
+    explicit ScopedTimer(LatencyHistogram* histogram)
+        : histogram_(histogram),
+          start_(histogram ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}) {}
+
+    ~ScopedTimer() {
+        if (histogram_) {
+            histogram_->record(std::chrono::steady_clock::now() - start_);
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    LatencyHistogram* histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Maps audio positions back to the time their samples arrived, so a
+// detection can be timed from the audio that completed it. Positions are
+// sample counts since the start of the stream; embedding sequence numbers
+// count embeddings published, gated ones excluded.
+class AudioClock {
+public:
+    // Audio up to endPosition has arrived now
+    void markAudio(uint64_t endPosition);
+
+    // Embedding sequence covers audio up to position
+    void markEmbedding(uint64_t sequence, uint64_t position);
+
+    // Arrival time of the audio completing embedding sequence; false if it
+    // is too old to be known
+    bool embeddingArrival(uint64_t sequence, std::chrono::steady_clock::time_point& time) const;
+
+private:
+    static constexpr size_t HISTORY = 1024;
+
+    struct AudioMark {
+        uint64_t endPosition = 0;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    struct EmbeddingMark {
+        uint64_t sequence = UINT64_MAX;
+        uint64_t position = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::array<AudioMark, HISTORY> audio_{};
+    uint64_t audioMarks_ = 0;
+    std::array<EmbeddingMark, HISTORY> embeddings_{};
+};
+
+// Pipeline statistics: per-stage inference time, queue depths, end-to-end
+// audio-to-detection latency and the real-time factor. Stages and gauges are
+// registered during setup; recording is thread-safe and lock-free apart
+// from the AudioClock and steps shared by several detector threads.
+class Metrics {
+public:
+    struct StageSummary {
+        std::string stage;
+        std::string model;
+        LatencyHistogram::Snapshot latency;
+    };
+
+    Metrics();
+
+    // Inference time histogram of a stage (mel, embedding, wake_word); model
+    // distinguishes wake word models. Not thread-safe: register during setup.
+    LatencyHistogram* addStage(const std::string& stage, const std::string& model = "");
+
+    // Sampled on export, e.g. a ring buffer's size
+    void addGauge(const std::string& queue, std::function<double()> read);
+
+    // Audio entering the pipeline
+    void addAudio(size_t samples) { audioSamples_.fetch_add(samples, std::memory_order_relaxed); }
+
+    // A detection fired for the window ending with embedding sequence
+    void recordDetection(uint64_t sequence);
+
+    // Real-time mode: steps finishing later than deadline after their audio
+    // arrived count as misses. Set during setup; zero disables step timing.
+    void setDeadline(std::chrono::nanoseconds deadline) { deadline_ = deadline; }
+    bool hasDeadline() const { return deadline_.count() > 0; }
+
+    // Detector threads that each finish every step (one per wake word
+    // without a detector group); a step is timed once, when the last of
+    // them is done with it. Set during setup.
+    void setStepReporters(size_t reporters) { stepReporters_ = std::max<size_t>(reporters, 1); }
+    
+    // A detector thread is done with the window ending with embedding
+    // sequence; scored is false if it skipped the window
+    void recordStep(uint64_t sequence, bool scored = true);
+
+    // Embedding or wake word windows skipped by the overload policy
+    void recordOverloadSkips(uint64_t windows) {
+        overloadSkips_.fetch_add(windows, std::memory_order_relaxed);
+    }
+
+    LatencyHistogram::Snapshot stepLatency() const { return stepLatency_.snapshot(); }
+    uint64_t deadlineMisses() const { return deadlineMisses_.load(std::memory_order_relaxed); }
+    uint64_t overloadSkips() const { return overloadSkips_.load(std::memory_order_relaxed); }
+
+    AudioClock& clock() { return clock_; }
+
+    // Inference time of every registered stage, in registration order
+    std::vector<StageSummary> stageSummaries() const;
+    LatencyHistogram::Snapshot detectionLatency() const { return detectionLatency_.snapshot(); }
+
+    // Inference seconds per second of audio, over all stages
+    double realTimeFactor() const;
+    double audioSeconds() const;
+
+    // Prometheus text exposition format
+    std::string toPrometheus() const;
+
+    // One JSON object summarising every statistic
+    std::string toJson() const;
+
+private:
+    struct Stage {
+        std::string stage;
+        std::string model;
+        LatencyHistogram histogram;
+    };
+
+    struct Gauge {
+        std::string queue;
+        std::function<double()> read;
+    };
+
+    std::deque<Stage> stages_;  // Stable addresses
+    std::vector<Gauge> gauges_;
+    LatencyHistogram detectionLatency_;
+    LatencyHistogram stepLatency_;
+    AudioClock clock_;
+    std::chrono::nanoseconds deadline_{0};
+    
+    // Reporters done with each recent step, with several reporters
+    static constexpr size_t STEP_HISTORY = 1024;
+    struct StepMark {
+        uint64_t sequence = UINT64_MAX;
+        size_t reported = 0;
+        bool scored = false;
+    };
+    size_t stepReporters_ = 1;
+    std::mutex stepMutex_;
+    std::array<StepMark, STEP_HISTORY> steps_{};
+    
+    std::atomic<uint64_t> audioSamples_{0};
+    std::atomic<uint64_t> detections_{0};
+    std::atomic<uint64_t> deadlineMisses_{0};
+    std::atomic<uint64_t> overloadSkips_{0};
+    std::chrono::steady_clock::time_point startTime_;
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_METRICS_H
@@ -0,0 +1,49 @@
+#ifndef OPENWAKEWORD_METRICS_EXPORTER_H
+#define OPENWAKEWORD_METRICS_EXPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "utils/metrics.h"
+
+namespace openwakeword {
+
+// Publishes Metrics from a background thread: a Prometheus text endpoint
+// answering any HTTP request on a TCP port, and/or a periodic JSON line on
+// stderr.
+class MetricsExporter {
+public:
+    // The endpoint binds host (IPv4, loopback by default); port 0 disables
+    // it. A zero interval disables the JSON lines. stderr writes take logMutex.
+    MetricsExporter(const Metrics& metrics, const std::string& host, uint16_t port,
+                    std::chrono::seconds interval, std::mutex& logMutex);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // Bind the endpoint and start the thread; returns false if the host is
+    // invalid or the port cannot be bound
+    bool start();
+    void stop();
+
+private:
+    const Metrics& metrics_;
+    std::string host_;
+    uint16_t port_;
+    std::chrono::seconds interval_;
+    std::mutex& logMutex_;
+
+    int listenSocket_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    void exportLoop();
+    void serveClient(int client);
+};
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_METRICS_EXPORTER_H
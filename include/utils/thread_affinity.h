@@ -0,0 +1,28 @@
+#ifndef OPENWAKEWORD_THREAD_AFFINITY_H
+#define OPENWAKEWORD_THREAD_AFFINITY_H
+
+#include <string>
+#include <vector>
+
+namespace openwakeword {
+
+// Restrict the calling thread to the given CPUs (0-based). An empty list
+// leaves the thread unpinned. Returns false if the platform does not support
+// pinning (macOS) or rejects the set.
+bool pinCurrentThread(const std::vector<int>& cpus);
+
+// Run the calling thread under SCHED_FIFO at priority (1-99); on Windows
+// at time-critical priority. Returns false if the platform refuses, which
+// it usually does without the privilege (CAP_SYS_NICE or an rtprio limit).
+bool setRealtimePriority(int priority);
+
+// Parse a CPU list such as "0,2,4-7"; returns false on malformed input and
+// on ids the affinity mask cannot hold or beyond the online CPU count
+bool parseCpuList(const std::string& text, std::vector<int>& cpus);
+
+// Format as accepted by parseCpuList
+std::string formatCpuList(const std::vector<int>& cpus);
+
+} // namespace openwakeword
+
+#endif // OPENWAKEWORD_THREAD_AFFINITY_H
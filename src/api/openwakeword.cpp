@@ -0,0 +1,91 @@
+#include "api/openwakeword.h"
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "core/pipeline.h"
+#include "utils/config.h"
+
+using namespace openwakeword;
+
+struct oww_detector {
+    std::unique_ptr<Pipeline> pipeline;
+    oww_detection_callback callback = nullptr;
+    void* userData = nullptr;
+};
+
+extern "C" {
+
+const char* oww_version(void) {
+    return VERSION;
+}
+
+oww_detector* oww_create(int argc, const char* const* argv,
+                         oww_detection_callback callback, void* userData) {
+    if (argc < 0 || (argc > 0 && argv == nullptr)) {
+        return nullptr;
+    }
+
+    try {
+        // The parser expects a program name first
+        std::vector<std::string> storage = {"openwakeword"};
+        for (int i = 0; i < argc; ++i) {
+            storage.emplace_back(argv[i] ? argv[i] : "");
+        }
+        std::vector<char*> args;
+        for (auto& arg : storage) {
+            args.push_back(arg.data());
+        }
+
+        // Embedded use is quiet unless logging is asked for
+        Config config;
+        config.outputMode = OutputMode::QUIET;
+        if (config.parseArgs(static_cast<int>(args.size()), args.data()) != ParseResult::SUCCESS) {
+            return nullptr;
+        }
+
+        auto detector = std::make_unique<oww_detector>();
+        detector->callback = callback;
+        detector->userData = userData;
+        detector->pipeline = std::make_unique<Pipeline>(config);
+
+        oww_detector* handle = detector.get();
+        detector->pipeline->setDetectionCallback([handle](const Detection& detection) {
+            if (handle->callback) {
+                oww_detection result{detection.modelName.c_str(), detection.score,
+                                     static_cast<uint64_t>(detection.frameIndex)};
+                handle->callback(&result, handle->userData);
+            }
+        });
+
+        if (!detector->pipeline->initialize()) {
+            return nullptr;
+        }
+        detector->pipeline->start();
+        detector->pipeline->waitUntilReady();
+        return detector.release();
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Failed to create detector: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+int oww_push_samples(oww_detector* detector, const int16_t* samples, size_t count) {
+    if (detector == nullptr || (samples == nullptr && count > 0) ||
+        !detector->pipeline->isRunning()) {
+        return -1;
+    }
+    detector->pipeline->processAudio(samples, count);
+    return 0;
+}
+
+void oww_destroy(oww_detector* detector) {
+    if (detector == nullptr) {
+        return;
+    }
+    detector->pipeline->stop();
+    delete detector;
+}
+
+} // extern "C"
@@ -0,0 +1,195 @@
+#include "core/detection_collector.h"
+#include <algorithm>
+#include <iostream>
+#include "processors/wake_word_detector.h"
+
+namespace openwakeword {
+
+namespace {
+
+// Events handled per output lock, so a flood of scores cannot hold it long
+constexpr size_t MAX_BATCH = 256;
+
+} // namespace
+
+DetectionCollector::DetectionCollector(std::mutex& outputMutex, OutputMode outputMode,
+                                       bool showTimestamp, size_t capacity)
+    : outputMutex_(outputMutex), outputMode_(outputMode), showTimestamp_(showTimestamp),
+      queue_(capacity) {
+    pending_.reserve(MAX_BATCH);
+}
+
+DetectionCollector::~DetectionCollector() {
+    stop();
+}
+
+uint32_t DetectionCollector::addDetector(const std::string& name, int refractorySteps) {
+    names_.push_back(name);
+    refractorySteps_.push_back(refractorySteps);
+    refractoryEnd_.push_back(0);
+    inRound_.push_back(0);
+    return static_cast<uint32_t>(names_.size() - 1);
+}
+
+void DetectionCollector::start() {
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(&DetectionCollector::run, this);
+}
+
+void DetectionCollector::stop() {
+    if (!running_) {
+        return;
+    }
+    running_.store(false, std::memory_order_release);
+    signal_.fetch_add(1, std::memory_order_release);
+    signal_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void DetectionCollector::post(DetectionEvent&& event) {
+    if (event.type == DetectionEvent::Type::SCORE) {
+        if (!queue_.tryPush(std::move(event))) {
+            droppedScores_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    } else {
+        // Detections are never lost; the queue only fills if output stalls
+        while (!queue_.tryPush(std::move(event))) {
+            std::this_thread::yield();
+        }
+    }
+
+    signal_.fetch_add(1, std::memory_order_release);
+    signal_.notify_one();
+}
+
+void DetectionCollector::run() {
+    while (true) {
+        uint32_t observed = signal_.load(std::memory_order_acquire);
+        if (drain()) {
+            continue;
+        }
+        if (!running_.load(std::memory_order_acquire)) {
+            // Producers have stopped; deliver what they left behind
+            while (drain()) {
+            }
+            break;
+        }
+        signal_.wait(observed, std::memory_order_acquire);
+    }
+}
+
+void DetectionCollector::postprocess() {
+    if (!postprocessors_) {
+        return;
+    }
+    // Each postprocessor on every detection of the round still accepted
+    for (const auto& postprocessor : *postprocessors_) {
+        batchDetections_.clear();
+        batchFeatures_.clear();
+        for (size_t k : round_) {
+            auto& output = pending_[k];
+            if (output.type == DetectionEvent::Type::DETECTION && output.detection.accepted &&
+                postprocessor->shouldProcess(output.detection)) {
+                batchDetections_.push_back(&output.detection);
+                batchFeatures_.push_back(&output.features);
+            }
+        }
+        if (!batchDetections_.empty()) {
+            postprocessor->processBatch(batchDetections_, batchFeatures_);
+        }
+    }
+}
+
+bool DetectionCollector::drain() {
+    DetectionEvent event;
+    while (pending_.size() < MAX_BATCH && queue_.tryPop(event)) {
+        pending_.push_back({event.type, event.detector,
+                            Detection(names_[event.detector], event.score, event.window),
+                            std::move(event.features)});
+    }
+    if (pending_.empty()) {
+        return false;
+    }
+
+    // Postprocessors run before taking the output lock, in rounds. Deferred
+    // refractory periods start from accepted detections only, so a rejected
+    // candidate cannot suppress the real detection after it; a round takes
+    // at most one candidate per such detector, in window order, and drops
+    // the ones an earlier acceptance put inside its refractory period
+    // without postprocessing them.
+    settled_.assign(pending_.size(), 0);
+    while (true) {
+        round_.clear();
+        std::fill(inRound_.begin(), inRound_.end(), 0);
+        for (size_t k = 0; k < pending_.size(); ++k) {
+            if (settled_[k]) {
+                continue;
+            }
+            auto& output = pending_[k];
+            if (output.type == DetectionEvent::Type::DETECTION && output.detection.accepted &&
+                refractorySteps_[output.detector] > 0) {
+                if (output.detection.frameIndex < refractoryEnd_[output.detector]) {
+                    output.detection.accepted = false;
+                } else if (inRound_[output.detector]) {
+                    continue;  // Waits for the detector's earlier candidate
+                } else {
+                    inRound_[output.detector] = 1;
+                }
+            }
+            settled_[k] = 1;
+            round_.push_back(k);
+        }
+        if (round_.empty()) {
+            break;
+        }
+        postprocess();
+        for (size_t k : round_) {
+            const auto& output = pending_[k];
+            int steps = refractorySteps_[output.detector];
+            if (output.type == DetectionEvent::Type::DETECTION && output.detection.accepted && steps > 0) {
+                refractoryEnd_[output.detector] = output.detection.frameIndex + 1 + static_cast<uint64_t>(steps);
+            }
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(outputMutex_);
+        bool wroteStdout = false;
+        for (const auto& output : pending_) {
+            const Detection& detection = output.detection;
+            if (output.type == DetectionEvent::Type::SCORE) {
+                std::cerr << detection.modelName << " " << detection.score << '\n';
+            } else if (detection.accepted) {
+                if (callback_) {
+                    callback_(detection);
+                } else {
+                    printDetection(detection.modelName, detection.score, outputMode_, showTimestamp_);
+                    wroteStdout = true;
+                }
+            }
+        }
+        if (wroteStdout) {
+            std::cout.flush();
+        }
+    }
+
+    if (metrics_) {
+        for (const auto& output : pending_) {
+            if (output.type == DetectionEvent::Type::DETECTION && output.detection.accepted) {
+                // Timed from the audio completing the window's last embedding
+                metrics_->recordDetection(output.detection.frameIndex + WAKEWORD_FEATURES - 1);
+            }
+        }
+    }
+
+    pending_.clear();
+    return true;
+}
+
+} // namespace openwakeword
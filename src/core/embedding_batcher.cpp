@@ -0,0 +1,141 @@
+#include "core/embedding_batcher.h"
+#include <algorithm>
+
+namespace openwakeword {
+
+EmbeddingBatcher::EmbeddingBatcher(EmbeddingModel& model, size_t maxBatchSize,
+                                   std::chrono::microseconds maxWait, size_t producers)
+    : model_(model), maxBatchSize_(std::max<size_t>(maxBatchSize, 1)),
+      maxWait_(maxWait), producers_(std::max<size_t>(producers, 1)) {
+    batchWindows_.reserve(maxBatchSize_);
+    batchSlots_.reserve(maxBatchSize_);
+}
+
+EmbeddingBatcher::~EmbeddingBatcher() {
+    stop();
+}
+
+void EmbeddingBatcher::start() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(&EmbeddingBatcher::batchLoop, this);
+}
+
+void EmbeddingBatcher::stop() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    pendingCv_.notify_all();
+
+    // The batching thread drains pending requests before it exits
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void EmbeddingBatcher::submit(const AudioFloat* const* windows, size_t count, AudioFloat* output) {
+    if (count == 0) {
+        return;
+    }
+
+    Request request{windows, count, output, 0, 0, std::chrono::steady_clock::now()};
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!running_) {
+        lock.unlock();
+        runDirect(windows, count, output);
+        return;
+    }
+
+    pending_.push_back(&request);
+    pendingWindows_ += count;
+    pendingCv_.notify_one();
+
+    doneCv_.wait(lock, [&request] { return request.completed == request.count; });
+}
+
+bool EmbeddingBatcher::batchReady(std::chrono::steady_clock::time_point now) const {
+    if (pending_.empty()) {
+        return false;
+    }
+    // Full batch, or no other producer left that could add to it
+    if (pendingWindows_ >= maxBatchSize_ || pending_.size() >= producers_) {
+        return true;
+    }
+    return now >= pending_.front()->submitted + maxWait_;
+}
+
+void EmbeddingBatcher::batchLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        pendingCv_.wait(lock, [this] { return !pending_.empty() || !running_; });
+        if (pending_.empty()) {
+            break;
+        }
+
+        // Hold the batch open until it fills or the oldest request's deadline
+        if (running_) {
+            auto deadline = pending_.front()->submitted + maxWait_;
+            pendingCv_.wait_until(lock, deadline, [this] {
+                return !running_ || batchReady(std::chrono::steady_clock::now());
+            });
+        }
+
+        // Take up to maxBatchSize windows, oldest request first
+        batchWindows_.clear();
+        batchSlots_.clear();
+        for (Request* request : pending_) {
+            while (request->taken < request->count && batchWindows_.size() < maxBatchSize_) {
+                batchWindows_.push_back(request->windows[request->taken]);
+                batchSlots_.push_back({request, request->taken});
+                ++request->taken;
+            }
+            if (batchWindows_.size() == maxBatchSize_) {
+                break;
+            }
+        }
+        pendingWindows_ -= batchWindows_.size();
+        while (!pending_.empty() && pending_.front()->taken == pending_.front()->count) {
+            pending_.pop_front();
+        }
+
+        // Run without the lock so producers can queue the next batch
+        lock.unlock();
+        model_.extractEmbeddingsBatch(batchWindows_.data(), batchWindows_.size(),
+                                      batchInput_, batchOutput_);
+
+        const AudioFloat* embedding = batchOutput_.data();
+        for (const auto& slot : batchSlots_) {
+            std::copy(embedding, embedding + EMBEDDING_FEATURES,
+                      slot.request->output + slot.index * EMBEDDING_FEATURES);
+            embedding += EMBEDDING_FEATURES;
+        }
+        batchCount_.fetch_add(1, std::memory_order_relaxed);
+        windowCount_.fetch_add(batchWindows_.size(), std::memory_order_relaxed);
+        lock.lock();
+
+        for (const auto& slot : batchSlots_) {
+            ++slot.request->completed;
+        }
+        doneCv_.notify_all();
+    }
+}
+
+void EmbeddingBatcher::runDirect(const AudioFloat* const* windows, size_t count, AudioFloat* output) {
+    std::vector<AudioFloat> scratch;
+    FeatureBuffer embeddings;
+    for (size_t offset = 0; offset < count; offset += maxBatchSize_) {
+        size_t batch = std::min(maxBatchSize_, count - offset);
+        model_.extractEmbeddingsBatch(windows + offset, batch, scratch, embeddings);
+        std::copy(embeddings.begin(), embeddings.end(), output + offset * EMBEDDING_FEATURES);
+    }
+}
+
+} // namespace openwakeword
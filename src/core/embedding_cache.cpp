@@ -0,0 +1,188 @@
+#include "core/embedding_cache.h"
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace openwakeword {
+
+namespace {
+
+constexpr char CACHE_MAGIC[8] = {'O', 'W', 'W', 'E', 'M', 'B', 'C', '\0'};
+constexpr uint32_t CACHE_VERSION = 2;
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t features;
+    EmbeddingCacheKey key;
+    uint32_t framesPerRow;
+    uint64_t sourceSamples;
+    uint64_t count;
+};
+
+// Stable across runs and platforms, unlike std::hash
+uint64_t fnv1a(const std::string& text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+bool fileIdentity(const std::filesystem::path& path, uint64_t& size, int64_t& modified) {
+    std::error_code ec;
+    size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+    auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+    modified = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+} // namespace
+
+bool EmbeddingCacheKey::make(const std::filesystem::path& source, size_t frameSize,
+                             const Config& config, EmbeddingCacheKey& key) {
+    key = EmbeddingCacheKey{};
+    if (!fileIdentity(source, key.sourceSize, key.sourceModified) ||
+        !fileIdentity(config.embModelPath, key.embeddingModelSize, key.embeddingModelModified)) {
+        return false;
+    }
+    if (config.melFrontend == MelFrontendType::ONNX &&
+        !fileIdentity(config.melModelPath, key.melModelSize, key.melModelModified)) {
+        return false;
+    }
+    key.frameSize = static_cast<uint32_t>(frameSize);
+    key.melFrontend = static_cast<uint32_t>(config.melFrontend);
+    key.streamingMel = config.streamingMel ? 1 : 0;
+    key.inputChannel = config.inputChannel;
+    return true;
+}
+
+std::filesystem::path embeddingCachePath(const std::filesystem::path& cacheDir,
+                                         const std::filesystem::path& source) {
+    std::error_code ec;
+    auto absolute = std::filesystem::weakly_canonical(source, ec);
+    if (ec) {
+        absolute = std::filesystem::absolute(source);
+    }
+
+    std::ostringstream name;
+    name << source.stem().string() << "-" << std::hex << std::setw(16) << std::setfill('0')
+         << fnv1a(absolute.generic_string()) << ".emb";
+    return cacheDir / name.str();
+}
+
+bool EmbeddingCacheReader::open(const std::filesystem::path& path, const EmbeddingCacheKey& key) {
+    embeddings_ = {};
+    if (!mapping_.open(path.string(), true)) {
+        return false;
+    }
+
+    CacheHeader header;
+    if (mapping_.size() < sizeof(header)) {
+        mapping_.close();
+        return false;
+    }
+    std::memcpy(&header, mapping_.data(), sizeof(header));
+
+    size_t floats = header.count * EMBEDDING_FEATURES;
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != CACHE_VERSION || header.features != EMBEDDING_FEATURES ||
+        header.key != key ||
+        mapping_.size() != sizeof(header) + floats * sizeof(AudioFloat)) {
+        mapping_.close();
+        return false;
+    }
+
+    // The mapping is page-aligned and the header a multiple of the float size
+    embeddings_ = std::span<const AudioFloat>(
+        reinterpret_cast<const AudioFloat*>(mapping_.data() + sizeof(header)), floats);
+    framesPerRow_ = header.framesPerRow;
+    sourceSamples_ = header.sourceSamples;
+    return true;
+}
+
+EmbeddingCacheWriter::~EmbeddingCacheWriter() {
+    discard();
+}
+
+bool EmbeddingCacheWriter::open(const std::filesystem::path& path, const EmbeddingCacheKey& key) {
+    discard();
+
+    // Unique temporary name, in case two workers write the same entry
+    static std::atomic<uint64_t> sequence{0};
+    path_ = path;
+    tempPath_ = path;
+    tempPath_ += ".tmp" + std::to_string(sequence++);
+    key_ = key;
+    count_ = 0;
+
+    file_.open(tempPath_, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+        return false;
+    }
+
+    // Placeholder header, rewritten by commit()
+    CacheHeader header{};
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return static_cast<bool>(file_);
+}
+
+void EmbeddingCacheWriter::append(const AudioFloat* embeddings, size_t count) {
+    if (file_.is_open()) {
+        file_.write(reinterpret_cast<const char*>(embeddings),
+                    static_cast<std::streamsize>(count * EMBEDDING_FEATURES * sizeof(AudioFloat)));
+        count_ += count;
+    }
+}
+
+bool EmbeddingCacheWriter::commit(size_t framesPerRow, size_t sourceSamples) {
+    if (!file_.is_open()) {
+        return false;
+    }
+
+    CacheHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.features = EMBEDDING_FEATURES;
+    header.key = key_;
+    header.framesPerRow = static_cast<uint32_t>(framesPerRow);
+    header.sourceSamples = sourceSamples;
+    header.count = count_;
+
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_.close();
+    if (file_.fail()) {
+        discard();
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath_, path_, ec);
+    if (ec) {
+        discard();
+        return false;
+    }
+    tempPath_.clear();
+    return true;
+}
+
+void EmbeddingCacheWriter::discard() {
+    if (file_.is_open()) {
+        file_.close();
+    }
+    if (!tempPath_.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(tempPath_, ec);
+        tempPath_.clear();
+    }
+}
+
+} // namespace openwakeword
@@ -0,0 +1,524 @@
+#include "core/engine.h"
+#include "core/model_loader.h"
+#include "utils/kernels.h"
+#include <algorithm>
+#include <iostream>
+
+namespace openwakeword {
+
+StreamContext::StreamContext(size_t id, const std::string& name, const Config& config, int channel)
+    : id_(id), name_(name),
+      input_(std::max(SAMPLE_RATE * config.bufferMilliseconds / 1000, 2 * config.frameSize),
+             config.bufferWaitPolicy),
+      mels_(NUM_MELS, EMBEDDING_WINDOW_SIZE + config.frameSize / MEL_HOP_SAMPLES),
+      features_(EMBEDDING_FEATURES,
+                WAKEWORD_FEATURES + config.frameSize / (MEL_HOP_SAMPLES * EMBEDDING_STEP_SIZE) + 1) {
+    if (config.streamingMel) {
+        melContext_.assign(MelStreamer::CONTEXT_SAMPLES, 0.0f);
+    }
+    for (const auto& wwConfig : config.wakeWordConfigs) {
+        activations_.emplace_back(wwConfig);
+    }
+    if (channel >= 0 || config.convertsInput()) {
+        converter_ = std::make_unique<AudioConverter>(config.inputSampleRate, config.inputChannels,
+                                                      channel >= 0 ? channel : config.inputChannel,
+                                                      config.inputSamplesFor(config.frameSize));
+    }
+}
+
+Engine::Engine(const Config& config)
+    : config_(config),
+      ortEnvironment_(OrtEnvironment::acquire(config_)),
+      env_(ortEnvironment_->env()),
+      sessionOptions_(ortEnvironment_->createSessionOptions(config_)),
+      melOptions_(ortEnvironment_->createSessionOptions(config_, config_.melProviders, "mel")),
+      embeddingOptions_(ortEnvironment_->createSessionOptions(config_, config_.embeddingProviders,
+                                                              "embedding")) {
+    for (const auto& wwConfig : config_.wakeWordConfigs) {
+        wakeWordOptions_.push_back(ortEnvironment_->createSessionOptions(
+            config_, wwConfig.providers, wwConfig.name));
+    }
+}
+
+Engine::~Engine() {
+    stop();
+}
+
+bool Engine::initialize() {
+    // Sessions are created in parallel; they dominate startup
+    embeddingModel_ = std::make_unique<EmbeddingModel>();
+    for (const auto& wwConfig : config_.wakeWordConfigs) {
+        wakeWordNames_.push_back(wwConfig.name);
+        wakeWordModels_.push_back(std::make_unique<WakeWordModel>(wakeWordNames_.back()));
+    }
+
+    std::vector<std::function<bool()>> loads;
+    loads.push_back([this]() {
+        melFrontend_ = createMelFrontend(config_, env_, melOptions_.options,
+                                         melOptions_.hardware ? &sessionOptions_ : nullptr);
+        return melFrontend_ != nullptr;
+    });
+    loads.push_back([this]() {
+        if (!embeddingModel_->loadModel(config_.embModelPath, env_, embeddingOptions_.options,
+                                        embeddingOptions_.hardware ? &sessionOptions_ : nullptr)) {
+            std::cerr << "[ERROR] Failed to load speech embedding model" << std::endl;
+            return false;
+        }
+        return true;
+    });
+    for (size_t i = 0; i < wakeWordModels_.size(); ++i) {
+        loads.push_back([this, i]() {
+            const auto& options = wakeWordOptions_[i];
+            if (!wakeWordModels_[i]->loadModel(config_.wakeWordConfigs[i].modelPath, env_,
+                                               options.options,
+                                               options.hardware ? &sessionOptions_ : nullptr)) {
+                std::cerr << "[ERROR] Failed to load wake word model: " << wakeWordNames_[i]
+                          << std::endl;
+                return false;
+            }
+            return true;
+        });
+    }
+    if (!runLoadTasks(loads, config_.loadThreads)) {
+        return false;
+    }
+
+    embeddingBatcher_ = std::make_unique<EmbeddingBatcher>(
+        *embeddingModel_, config_.embeddingBatchSize,
+        std::chrono::microseconds(config_.batchWaitMicros), config_.workerThreads);
+
+    for (size_t i = 0; i < wakeWordModels_.size(); ++i) {
+        if (config_.outputMode == OutputMode::VERBOSE) {
+            std::cerr << "[LOG] Loaded wake word model: " << wakeWordNames_[i]
+                      << (wakeWordModels_[i]->hasDynamicBatch() ? " (batched)" : " (batch size 1)")
+                      << std::endl;
+        }
+    }
+
+    if (config_.outputMode == OutputMode::VERBOSE || config_.outputMode == OutputMode::NORMAL) {
+        std::cerr << "[LOG] Loaded shared models for " << wakeWordModels_.size()
+                  << " wake word(s)" << std::endl;
+    }
+    return true;
+}
+
+void Engine::start() {
+    std::unique_lock<std::mutex> lock(streamsMutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+
+    embeddingBatcher_->start();
+
+    size_t numWorkers = std::max<size_t>(config_.workerThreads, 1);
+    scratch_.assign(numWorkers, WorkerScratch());
+    for (size_t i = 0; i < numWorkers; ++i) {
+        scratch_[i].streams.reserve(config_.maxBatchSize);
+        workers_.emplace_back(&Engine::workerLoop, this, i);
+    }
+}
+
+void Engine::stop() {
+    {
+        std::unique_lock<std::mutex> lock(streamsMutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        for (auto& stream : streams_) {
+            stream->input_.setExhausted(true);
+        }
+    }
+    workCv_.notify_all();
+    finishedCv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+    embeddingBatcher_->stop();
+
+    if (config_.outputMode == OutputMode::VERBOSE && embeddingBatcher_->getBatchCount() > 0) {
+        std::cerr << "[LOG] Embedding batches: " << embeddingBatcher_->getBatchCount()
+                  << ", average size "
+                  << static_cast<double>(embeddingBatcher_->getWindowCount()) /
+                     embeddingBatcher_->getBatchCount() << std::endl;
+    }
+}
+
+std::shared_ptr<StreamContext> Engine::openStream(const std::string& name) {
+    std::unique_lock<std::mutex> lock(streamsMutex_);
+    auto stream = std::make_shared<StreamContext>(nextStreamId_++, name, config_,
+                                                  config_.micArray ? 0 : -1);
+    if (config_.micArray) {
+        // Further channels are owned by channel 0 and never listed on their own
+        for (size_t c = 1; c < config_.inputChannels; ++c) {
+            stream->channels_.push_back(std::make_shared<StreamContext>(
+                nextStreamId_++, name + "/ch" + std::to_string(c), config_, static_cast<int>(c)));
+        }
+    }
+    streams_.push_back(stream);
+    return stream;
+}
+
+void Engine::pushAudio(StreamContext& stream, const AudioSample* samples, size_t sampleCount) {
+    std::span<const AudioSample> input(samples, sampleCount);
+
+    // Channel 0 last, so the array is complete once its frame is ready
+    for (auto& channel : stream.channels_) {
+        pushChannel(*channel, input);
+    }
+    pushChannel(stream, input);
+
+    if (stream.input_.size() >= config_.frameSize) {
+        notifyWorkers();
+    }
+}
+
+size_t Engine::tryPushAudio(StreamContext& stream, const AudioSample* samples, size_t sampleCount) {
+    std::span<const AudioSample> input(samples, sampleCount);
+
+    for (auto& channel : stream.channels_) {
+        tryPushChannel(*channel, input);
+    }
+    size_t pushed = tryPushChannel(stream, input);
+
+    if (stream.input_.size() >= config_.frameSize) {
+        notifyWorkers();
+    }
+    return pushed;
+}
+
+size_t Engine::pushSpace(const StreamContext& stream) const {
+    auto space = [](const StreamContext& channel) {
+        size_t free = channel.input_.capacity() - channel.input_.size();
+        return channel.converter_ ? channel.converter_->inputForOutput(free) : free;
+    };
+    size_t result = space(stream);
+    for (const auto& channel : stream.channels_) {
+        result = std::min(result, space(*channel));
+    }
+    return result;
+}
+
+void Engine::pushChannel(StreamContext& stream, std::span<const AudioSample> samples) {
+    if (stream.converter_) {
+        samples = stream.converter_->process(samples);
+    }
+
+    // Converted straight into the stream's ring; waits if workers have
+    // fallen behind on this stream
+    stream.input_.pushConverted(samples.data(), samples.size(), kernels::convertInt16ToFloat);
+}
+
+size_t Engine::tryPushChannel(StreamContext& stream, std::span<const AudioSample> samples) {
+    const size_t sampleCount = samples.size();
+    if (stream.converter_) {
+        samples = stream.converter_->process(samples);
+    }
+
+    size_t pushed = stream.input_.tryPushConverted(samples.data(), samples.size(),
+                                                   kernels::convertInt16ToFloat);
+
+    // In input samples; the converter has taken all of them either way
+    return pushed == samples.size() ? sampleCount : pushed * sampleCount / samples.size();
+}
+
+void Engine::closeStream(StreamContext& stream) {
+    stream.closed_.store(true, std::memory_order_release);
+    notifyWorkers();
+}
+
+void Engine::waitForStreams() {
+    std::unique_lock<std::mutex> lock(streamsMutex_);
+    finishedCv_.wait(lock, [this] { return streams_.empty() || !running_; });
+}
+
+void Engine::notifyWorkers() {
+    // Taking the lock orders this wake-up after a worker's predicate check
+    { std::unique_lock<std::mutex> lock(streamsMutex_); }
+    workCv_.notify_one();
+}
+
+void Engine::claimReadyStreams(std::vector<std::shared_ptr<StreamContext>>& batch) {
+    // Streaming mels need only one 80 ms group
+    const size_t frameSize = config_.streamingMel ? MelStreamer::GROUP_SAMPLES : config_.frameSize;
+
+    for (auto it = streams_.begin(); it != streams_.end() && batch.size() < config_.maxBatchSize;) {
+        auto& stream = *it;
+        if (stream->claimed_.load(std::memory_order_acquire)) {
+            ++it;
+            continue;
+        }
+
+        // A mic array is claimed whole, in one batch; validation keeps it
+        // within maxBatchSize, so it always fits an empty batch
+        bool ready = stream->input_.size() >= frameSize;
+        for (const auto& channel : stream->channels_) {
+            ready = ready && channel->input_.size() >= frameSize;
+        }
+        if (ready && batch.size() + 1 + stream->channels_.size() > config_.maxBatchSize) {
+            ++it;
+            continue;
+        }
+        if (!ready && stream->closed_.load(std::memory_order_acquire)) {
+            // Closed and drained (a trailing partial frame is dropped)
+            stream->finished_.store(true, std::memory_order_release);
+            it = streams_.erase(it);
+            finishedCv_.notify_all();
+            continue;
+        }
+
+        if (ready) {
+            stream->claimed_.store(true, std::memory_order_release);
+            batch.push_back(stream);
+            batch.insert(batch.end(), stream->channels_.begin(), stream->channels_.end());
+        }
+        ++it;
+    }
+}
+
+void Engine::workerLoop(size_t workerIndex) {
+    WorkerScratch& scratch = scratch_[workerIndex];
+
+    while (true) {
+        scratch.streams.clear();
+        {
+            std::unique_lock<std::mutex> lock(streamsMutex_);
+            workCv_.wait(lock, [this, &scratch] {
+                claimReadyStreams(scratch.streams);
+                return !scratch.streams.empty() || !running_;
+            });
+            if (scratch.streams.empty()) {
+                break;
+            }
+        }
+
+        // More streams may be ready than one batch holds
+        workCv_.notify_one();
+
+        processBatch(scratch);
+
+        for (auto& stream : scratch.streams) {
+            stream->claimed_.store(false, std::memory_order_release);
+        }
+    }
+}
+
+void Engine::processBatch(WorkerScratch& scratch) {
+    const size_t frameSize = config_.frameSize;
+    const size_t batch = scratch.streams.size();
+
+    if (config_.streamingMel) {
+        runStreamingMelStage(scratch);
+        runEmbeddingStage(scratch);
+        runWakeWordStage(scratch);
+        return;
+    }
+
+    // Mel stage: one frame from every claimed stream. The native frontend
+    // floors each row on its own, so all streams share one call; the ONNX
+    // graph's dB floor spans the batch, so it runs one stream at a time to
+    // keep streams independent of each other (as the offline runner does).
+    scratch.melInput.resize(batch * frameSize);
+    for (size_t i = 0; i < batch; ++i) {
+        scratch.streams[i]->input_.tryPull(scratch.melInput.data() + i * frameSize, frameSize);
+    }
+
+    const size_t rowsPerCall = config_.melFrontend == MelFrontendType::NATIVE ? batch : 1;
+    for (size_t first = 0; first < batch; first += rowsPerCall) {
+        size_t framesPerRow = melFrontend_->computeMelSpectrogramBatch(
+            scratch.melInput.data() + first * frameSize, rowsPerCall, frameSize, scratch.melOutput);
+
+        for (size_t i = 0; i < rowsPerCall; ++i) {
+            scratch.streams[first + i]->mels_.append(
+                scratch.melOutput.data() + i * framesPerRow * NUM_MELS, framesPerRow);
+        }
+    }
+
+    runEmbeddingStage(scratch);
+    runWakeWordStage(scratch);
+}
+
+void Engine::runStreamingMelStage(WorkerScratch& scratch) {
+    constexpr size_t context = MelStreamer::CONTEXT_SAMPLES;
+    constexpr size_t group = MelStreamer::GROUP_SAMPLES;
+    constexpr size_t rowSize = MelStreamer::INPUT_SAMPLES;
+    const size_t maxGroups = std::max<size_t>(1, config_.frameSize / group);
+
+    // Every available 80 ms group (up to one step) of every stream becomes a
+    // row of its carried context followed by the group
+    scratch.melRows.clear();
+    size_t rows = 0;
+    for (auto& stream : scratch.streams) {
+        size_t groups = std::min(maxGroups, stream->input_.size() / group);
+        scratch.melInput.resize((rows + groups) * rowSize);
+        for (size_t g = 0; g < groups; ++g) {
+            AudioFloat* row = scratch.melInput.data() + (rows + g) * rowSize;
+            std::copy(stream->melContext_.begin(), stream->melContext_.end(), row);
+            stream->input_.tryPull(row + context, group);
+            std::copy(row + group, row + rowSize, stream->melContext_.begin());
+        }
+        scratch.melRows.push_back(groups);
+        rows += groups;
+    }
+
+    // All rows share one native call; ONNX rows run one at a time, since the
+    // graph's dB floor would otherwise mix streams and groups
+    if (config_.melFrontend == MelFrontendType::NATIVE) {
+        size_t framesPerRow = melFrontend_->computeMelSpectrogramBatch(
+            scratch.melInput.data(), rows, rowSize, scratch.melOutput);
+
+        const AudioFloat* mels = scratch.melOutput.data();
+        for (size_t i = 0; i < scratch.streams.size(); ++i) {
+            size_t frames = scratch.melRows[i] * framesPerRow;
+            scratch.streams[i]->mels_.append(mels, frames);
+            mels += frames * NUM_MELS;
+        }
+        return;
+    }
+
+    const AudioFloat* row = scratch.melInput.data();
+    for (size_t i = 0; i < scratch.streams.size(); ++i) {
+        for (size_t g = 0; g < scratch.melRows[i]; ++g, row += rowSize) {
+            size_t framesPerRow = melFrontend_->computeMelSpectrogramBatch(
+                row, 1, rowSize, scratch.melOutput);
+            scratch.streams[i]->mels_.append(scratch.melOutput.data(), framesPerRow);
+        }
+    }
+}
+
+void Engine::runEmbeddingStage(WorkerScratch& scratch) {
+    const size_t melStep = EMBEDDING_STEP_SIZE * NUM_MELS;
+
+    // Collect every complete mel window of every stream, in stream order
+    scratch.windows.clear();
+    scratch.windowCounts.clear();
+    for (auto& stream : scratch.streams) {
+        size_t count = 0;
+        while (stream->mels_.size() >= EMBEDDING_WINDOW_SIZE + count * EMBEDDING_STEP_SIZE) {
+            scratch.windows.push_back(stream->mels_.data() + count * melStep);
+            ++count;
+        }
+        scratch.windowCounts.push_back(count);
+    }
+
+    // Batched embedding inference, merged with other workers' windows
+    scratch.embeddings.resize(scratch.windows.size() * EMBEDDING_FEATURES);
+    embeddingBatcher_->submit(scratch.windows.data(), scratch.windows.size(),
+                              scratch.embeddings.data());
+
+    // Scatter embeddings back into each stream's history
+    const AudioFloat* embedding = scratch.embeddings.data();
+    for (size_t i = 0; i < scratch.streams.size(); ++i) {
+        auto& stream = scratch.streams[i];
+        size_t count = scratch.windowCounts[i];
+        stream->mels_.consume(count * EMBEDDING_STEP_SIZE);
+        stream->features_.append(embedding, count);
+        embedding += count * EMBEDDING_FEATURES;
+    }
+}
+
+void Engine::runWakeWordStage(WorkerScratch& scratch) {
+    // Collect every complete feature window of every stream, in stream order
+    scratch.windows.clear();
+    scratch.windowCounts.clear();
+    for (auto& stream : scratch.streams) {
+        size_t count = 0;
+        while (stream->features_.size() >= WAKEWORD_FEATURES + count) {
+            scratch.windows.push_back(stream->features_.data() + count * EMBEDDING_FEATURES);
+            ++count;
+        }
+        scratch.windowCounts.push_back(count);
+    }
+
+    // One batched call per model across all streams
+    const size_t windows = scratch.windows.size();
+    scratch.scores.resize(wakeWordModels_.size() * windows);
+    for (size_t m = 0; m < wakeWordModels_.size(); ++m) {
+        float* scores = scratch.scores.data() + m * windows;
+        for (size_t offset = 0; offset < windows; offset += config_.maxBatchSize) {
+            size_t count = std::min(config_.maxBatchSize, windows - offset);
+            wakeWordModels_[m]->predictBatch(scratch.windows.data() + offset, count,
+                                             scratch.batchInput, scores + offset);
+        }
+    }
+
+    // Apply scores to each stream's activation counters in order; the
+    // channels of a mic array follow its channel 0 and are fused into it
+    size_t window = 0;
+    for (size_t i = 0; i < scratch.streams.size();) {
+        auto& stream = scratch.streams[i];
+        const size_t channels = 1 + stream->channels_.size();
+
+        // Channels advance in lockstep, so they have the same window count
+        size_t count = scratch.windowCounts[i];
+        scratch.channelWindows.clear();
+        for (size_t c = 0; c < channels; ++c) {
+            scratch.channelWindows.push_back(window);
+            count = std::min(count, scratch.windowCounts[i + c]);
+            window += scratch.windowCounts[i + c];
+        }
+
+        auto sourceName = [&](size_t c) {
+            return channels > 1 ? stream->name_ + "/ch" + std::to_string(c) : stream->name_;
+        };
+
+        for (size_t k = 0; k < count; ++k) {
+            auto score = [&](size_t m, size_t c) {
+                return scratch.scores[m * windows + scratch.channelWindows[c] + k];
+            };
+
+            // Best channel: the highest score summed over all wake words
+            size_t selected = 0;
+            if (config_.channelFusion == ChannelFusion::BEST_CHANNEL) {
+                float bestTotal = -1.0f;
+                for (size_t c = 0; c < channels; ++c) {
+                    float total = 0.0f;
+                    for (size_t m = 0; m < wakeWordModels_.size(); ++m) {
+                        total += score(m, c);
+                    }
+                    if (total > bestTotal) {
+                        bestTotal = total;
+                        selected = c;
+                    }
+                }
+            }
+
+            for (size_t m = 0; m < wakeWordModels_.size(); ++m) {
+                size_t channel = selected;
+                if (config_.channelFusion == ChannelFusion::MAX) {
+                    for (size_t c = 1; c < channels; ++c) {
+                        if (score(m, c) > score(m, channel)) {
+                            channel = c;
+                        }
+                    }
+                }
+                float probability = score(m, channel);
+
+                if (config_.wakeWordConfigs[m].debug || config_.outputMode == OutputMode::VERBOSE) {
+                    std::unique_lock<std::mutex> lock(outputMutex_);
+                    std::cerr << sourceName(channel) << " " << wakeWordNames_[m] << " "
+                              << probability << std::endl;
+                }
+
+                if (stream->activations_[m].update(probability)) {
+                    std::unique_lock<std::mutex> lock(outputMutex_);
+                    printDetection(wakeWordNames_[m], probability, config_.outputMode,
+                                   config_.showTimestamp, sourceName(channel));
+                    std::cout.flush();
+                }
+            }
+        }
+        i += channels;
+    }
+
+    for (size_t i = 0; i < scratch.streams.size(); ++i) {
+        scratch.streams[i]->features_.consume(scratch.windowCounts[i]);
+    }
+}
+
+} // namespace openwakeword
@@ -0,0 +1,324 @@
+#include "core/mel_frontend.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numbers>
+#include "core/model_wrapper.h"
+#include "utils/config.h"
+#include "utils/kernels.h"
+
+namespace openwakeword {
+
+namespace {
+
+// Constants of melspectrogram.onnx
+constexpr double MEL_FMIN = 60.0;
+constexpr double MEL_FMAX = 3800.0;
+constexpr float POWER_CLIP = 1e-10f;
+constexpr float LN_10 = 2.3025851249694824f;
+constexpr float TOP_DB = 80.0f;
+
+// Slaney mel scale (librosa htk=False)
+double hzToMel(double hz) {
+    const double fSp = 200.0 / 3.0;
+    const double minLogHz = 1000.0;
+    const double minLogMel = minLogHz / fSp;
+    const double logStep = std::log(6.4) / 27.0;
+    if (hz >= minLogHz) {
+        return minLogMel + std::log(hz / minLogHz) / logStep;
+    }
+    return hz / fSp;
+}
+
+double melToHz(double mel) {
+    const double fSp = 200.0 / 3.0;
+    const double minLogHz = 1000.0;
+    const double minLogMel = minLogHz / fSp;
+    const double logStep = std::log(6.4) / 27.0;
+    if (mel >= minLogMel) {
+        return minLogHz * std::exp(logStep * (mel - minLogMel));
+    }
+    return fSp * mel;
+}
+
+} // namespace
+
+NativeMelFrontend::NativeMelFrontend() {
+    constexpr double pi = std::numbers::pi;
+    constexpr size_t half = FFT_SIZE / 2;
+
+    // Periodic Hann window of WINDOW_LENGTH, centred in FFT_SIZE
+    const size_t offset = (FFT_SIZE - WINDOW_LENGTH) / 2;
+    window_.assign(FFT_SIZE, 0.0);
+    for (size_t n = 0; n < WINDOW_LENGTH; ++n) {
+        window_[offset + n] = 0.5 - 0.5 * std::cos(2.0 * pi * n / WINDOW_LENGTH);
+    }
+
+    // Slaney-normalised triangular filters, stored by their nonzero bins
+    const double melMin = hzToMel(MEL_FMIN);
+    const double melMax = hzToMel(MEL_FMAX);
+    std::vector<double> points(NUM_MELS + 2);
+    for (size_t i = 0; i < points.size(); ++i) {
+        points[i] = melToHz(melMin + (melMax - melMin) * i / (NUM_MELS + 1));
+    }
+    for (size_t m = 0; m < NUM_MELS; ++m) {
+        const double lowerWidth = points[m + 1] - points[m];
+        const double upperWidth = points[m + 2] - points[m + 1];
+        const double norm = 2.0 / (points[m + 2] - points[m]);
+
+        MelFilter filter{NUM_BINS, {}};
+        for (size_t k = 0; k < NUM_BINS; ++k) {
+            const double hz = static_cast<double>(k) * SAMPLE_RATE / FFT_SIZE;
+            const double lower = (hz - points[m]) / lowerWidth;
+            const double upper = (points[m + 2] - hz) / upperWidth;
+            const double weight = std::max(0.0, std::min(lower, upper)) * norm;
+            if (weight > 0.0) {
+                if (filter.firstBin == NUM_BINS) {
+                    filter.firstBin = k;
+                }
+                filter.weights.resize(k - filter.firstBin + 1, 0.0);
+                filter.weights.back() = weight;
+            }
+        }
+        filters_.push_back(std::move(filter));
+    }
+
+    // Tables for a half-size complex FFT of the interleaved real frame
+    size_t bits = 0;
+    while ((size_t{1} << bits) < half) {
+        ++bits;
+    }
+    bitReverse_.resize(half);
+    for (size_t i = 0; i < half; ++i) {
+        size_t reversed = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        bitReverse_[i] = reversed;
+    }
+    twiddles_.resize(half / 2);
+    for (size_t j = 0; j < half / 2; ++j) {
+        twiddles_[j] = std::polar(1.0, -2.0 * pi * j / half);
+    }
+    splitTwiddles_.resize(half + 1);
+    for (size_t k = 0; k <= half; ++k) {
+        splitTwiddles_[k] = std::polar(1.0, -2.0 * pi * k / FFT_SIZE);
+    }
+}
+
+size_t NativeMelFrontend::numFrames(size_t count) {
+    if (count < FFT_SIZE) {
+        return 0;
+    }
+    return (count - FFT_SIZE) / MEL_HOP_SAMPLES + 1;
+}
+
+bool NativeMelFrontend::prepare(size_t frameSize) {
+    melOutput_.reserve(numFrames(frameSize) * NUM_MELS);
+    return true;
+}
+
+void NativeMelFrontend::powerSpectrum(const AudioFloat* frame, double* power) const {
+    constexpr size_t half = FFT_SIZE / 2;
+
+    // Pack even/odd samples as one complex sequence, in bit-reversed order
+    std::complex<double> z[half];
+    for (size_t n = 0; n < half; ++n) {
+        z[bitReverse_[n]] = {frame[2 * n] * window_[2 * n], frame[2 * n + 1] * window_[2 * n + 1]};
+    }
+
+    // Iterative radix-2 FFT
+    for (size_t size = 2; size <= half; size <<= 1) {
+        const size_t stride = half / size;
+        for (size_t start = 0; start < half; start += size) {
+            for (size_t j = 0; j < size / 2; ++j) {
+                std::complex<double> t = twiddles_[j * stride] * z[start + j + size / 2];
+                z[start + j + size / 2] = z[start + j] - t;
+                z[start + j] += t;
+            }
+        }
+    }
+
+    // Split into the spectrum of the real frame
+    for (size_t k = 0; k <= half; ++k) {
+        const std::complex<double> zk = z[k % half];
+        const std::complex<double> zc = std::conj(z[(half - k) % half]);
+        const std::complex<double> even = 0.5 * (zk + zc);
+        const std::complex<double> odd = std::complex<double>(0.0, -0.5) * (zk - zc);
+        power[k] = std::norm(even + splitTwiddles_[k] * odd);
+    }
+}
+
+float NativeMelFrontend::computeRow(const AudioFloat* samples, size_t frames, AudioFloat* out) const {
+    double power[NUM_BINS];
+    float rowMax = -std::numeric_limits<float>::infinity();
+
+    for (size_t f = 0; f < frames; ++f) {
+        powerSpectrum(samples + f * MEL_HOP_SAMPLES, power);
+
+        for (size_t m = 0; m < NUM_MELS; ++m) {
+            const auto& filter = filters_[m];
+            double energy = 0.0;
+            for (size_t i = 0; i < filter.weights.size(); ++i) {
+                energy += power[filter.firstBin + i] * filter.weights[i];
+            }
+
+            // Same float operations as the graph: Clip, Log, Mul 10, Div ln(10)
+            float clipped = std::max(static_cast<float>(energy), POWER_CLIP);
+            float db = (std::log(clipped) * 10.0f) / LN_10;
+            out[f * NUM_MELS + m] = db;
+            rowMax = std::max(rowMax, db);
+        }
+    }
+    return rowMax;
+}
+
+std::span<const AudioFloat> NativeMelFrontend::computeMelSpectrogram(const AudioFloat* samples,
+                                                                    size_t count) {
+    size_t frames = numFrames(count);
+    if (frames == 0) {
+        throw std::invalid_argument("Invalid sample buffer size");
+    }
+
+    melOutput_.resize(frames * NUM_MELS);
+    float rowMax = computeRow(samples, frames, melOutput_.data());
+
+    const float floor = rowMax - TOP_DB;
+    for (auto& value : melOutput_) {
+        value = std::max(value, floor);
+    }
+
+    // Scale mels for Google speech embedding model
+    kernels::divideAdd(melOutput_.data(), melOutput_.data(), melOutput_.size(), 10.0f, 2.0f);
+    return melOutput_;
+}
+
+size_t NativeMelFrontend::computeMelSpectrogramBatch(const AudioFloat* samples, size_t batch,
+                                                     size_t count, MelBuffer& out) {
+    size_t frames = numFrames(count);
+    const size_t rowSize = frames * NUM_MELS;
+    out.resize(batch * rowSize);
+
+    for (size_t b = 0; b < batch; ++b) {
+        AudioFloat* row = out.data() + b * rowSize;
+        float rowMax = computeRow(samples + b * count, frames, row);
+
+        const float floor = rowMax - TOP_DB;
+        for (size_t i = 0; i < rowSize; ++i) {
+            row[i] = std::max(row[i], floor);
+        }
+    }
+
+    // Scale mels for Google speech embedding model
+    kernels::divideAdd(out.data(), out.data(), out.size(), 10.0f, 2.0f);
+    return frames;
+}
+
+MelStreamer::MelStreamer(MelFrontend& frontend)
+    : frontend_(frontend), window_(INPUT_SAMPLES, 0.0f) {
+}
+
+void MelStreamer::reset() {
+    std::fill(window_.begin(), window_.end(), 0.0f);
+    fill_ = CONTEXT_SAMPLES;
+}
+
+size_t MelStreamer::process(const AudioFloat* samples, size_t count, MelBuffer& out) {
+    out.clear();
+    while (count > 0) {
+        size_t n = std::min(count, INPUT_SAMPLES - fill_);
+        std::copy(samples, samples + n, window_.begin() + fill_);
+        fill_ += n;
+        samples += n;
+        count -= n;
+
+        if (fill_ == INPUT_SAMPLES) {
+            auto mels = frontend_.computeMelSpectrogram(window_.data(), INPUT_SAMPLES);
+            out.insert(out.end(), mels.begin(), mels.end());
+
+            // The group's tail is the next group's context
+            std::copy(window_.end() - CONTEXT_SAMPLES, window_.end(), window_.begin());
+            fill_ = CONTEXT_SAMPLES;
+        }
+    }
+    return out.size() / NUM_MELS;
+}
+
+bool verifyMelFrontend(MelFrontend& frontend, const std::filesystem::path& referenceModel,
+                       Ort::Env& env, const Ort::SessionOptions& options,
+                       float tolerance, float& maxError) {
+    MelSpectrogramModel reference;
+    if (!reference.loadModel(referenceModel, env, options)) {
+        std::cerr << "[ERROR] Failed to load reference mel spectrogram model" << std::endl;
+        return false;
+    }
+
+    // Deterministic test frames: silence, quiet and loud noise, tones and a
+    // clipped square wave, at 16-bit sample scale
+    const size_t frameSize = 4 * CHUNK_SAMPLES;
+    const float amplitudes[] = {0.0f, 30.0f, 1000.0f, 12000.0f, 32767.0f};
+    std::vector<AudioFloat> frame(frameSize);
+    uint32_t seed = 12345;
+    maxError = 0.0f;
+
+    for (size_t test = 0; test < 10; ++test) {
+        const float amplitude = amplitudes[test % 5];
+        for (size_t i = 0; i < frameSize; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            float noise = static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;
+            float t = static_cast<float>(i) / SAMPLE_RATE;
+            float tone = std::sin(2.0f * std::numbers::pi_v<float> * (200.0f + 350.0f * test) * t);
+            float value = (test < 5) ? amplitude * noise : amplitude * tone;
+            if (test == 9) {
+                value = (tone >= 0.0f) ? 32767.0f : -32768.0f;
+            }
+            frame[i] = std::round(value);
+        }
+
+        auto expected = reference.computeMelSpectrogram(frame.data(), frameSize);
+        MelBuffer expectedCopy(expected.begin(), expected.end());
+        auto actual = frontend.computeMelSpectrogram(frame.data(), frameSize);
+
+        if (actual.size() != expectedCopy.size()) {
+            std::cerr << "[ERROR] Mel frontend produced " << actual.size() << " values, expected "
+                      << expectedCopy.size() << std::endl;
+            return false;
+        }
+        for (size_t i = 0; i < actual.size(); ++i) {
+            maxError = std::max(maxError, std::abs(actual[i] - expectedCopy[i]));
+        }
+    }
+
+    return maxError <= tolerance;
+}
+
+std::unique_ptr<MelFrontend> createMelFrontend(const Config& config, Ort::Env& env,
+                                               const Ort::SessionOptions& options,
+                                               const Ort::SessionOptions* cpuFallback) {
+    if (config.melFrontend == MelFrontendType::ONNX) {
+        auto model = std::make_unique<MelSpectrogramModel>();
+        if (!model->loadModel(config.melModelPath, env, options, cpuFallback)) {
+            std::cerr << "[ERROR] Failed to load mel spectrogram model" << std::endl;
+            return nullptr;
+        }
+        return model;
+    }
+
+    auto frontend = std::make_unique<NativeMelFrontend>();
+    if (config.verifyMel) {
+        float maxError = 0.0f;
+        if (!verifyMelFrontend(*frontend, config.melModelPath, env, options,
+                               config.melTolerance, maxError)) {
+            std::cerr << "[ERROR] Native mel frontend differs from " << config.melModelPath
+                      << " by " << maxError << " (tolerance " << config.melTolerance << ")" << std::endl;
+            return nullptr;
+        }
+        if (config.outputMode == OutputMode::VERBOSE || config.outputMode == OutputMode::NORMAL) {
+            std::cerr << "[LOG] Native mel frontend verified against " << config.melModelPath
+                      << " (max difference " << maxError << ")" << std::endl;
+        }
+    }
+    return frontend;
+}
+
+} // namespace openwakeword
@@ -0,0 +1,293 @@
+#include "core/model_loader.h"
+#include "utils/mapped_file.h"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <span>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+namespace openwakeword {
+
+namespace {
+
+struct LoaderSettings {
+    std::filesystem::path directory;
+    GraphOptimization level = GraphOptimization::ALL;
+    bool shareModels = false;
+};
+
+std::mutex settingsMutex;
+LoaderSettings settings;
+
+LoaderSettings currentSettings() {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    return settings;
+}
+
+const char* levelName(GraphOptimization level) {
+    switch (level) {
+        case GraphOptimization::DISABLED: return "none";
+        case GraphOptimization::BASIC: return "basic";
+        case GraphOptimization::EXTENDED: return "extended";
+        case GraphOptimization::ALL: break;
+    }
+    return "all";
+}
+
+// Level ALL adds layout transforms for this host's CPU (e.g. NCHWc), which a
+// cache shared between hosts must not carry; entries stop at EXTENDED and
+// the rest runs when the entry is loaded
+GraphOptimization savedLevel(GraphOptimization level) {
+    return level == GraphOptimization::ALL ? GraphOptimization::EXTENDED : level;
+}
+
+// Session options for loading an entry saved at savedLevel(level)
+Ort::SessionOptions entryOptions(const Ort::SessionOptions& options, GraphOptimization level) {
+    Ort::SessionOptions cached = options.Clone();
+    cached.SetGraphOptimizationLevel(level == GraphOptimization::ALL ? ORT_ENABLE_ALL : ORT_DISABLE_ALL);
+    return cached;
+}
+
+// Stable across runs and platforms, unlike std::hash
+uint64_t fnv1a(std::span<const uint8_t> bytes) {
+    uint64_t hash = 14695981039346656037ull;
+    for (uint8_t byte : bytes) {
+        hash = (hash ^ byte) * 1099511628211ull;
+    }
+    return hash;
+}
+
+std::filesystem::path entryFor(const std::filesystem::path& modelPath, const LoaderSettings& cache) {
+    MappedFile model;
+    if (cache.directory.empty() || !model.open(modelPath.string(), true)) {
+        return {};
+    }
+
+    std::ostringstream name;
+    name << modelPath.stem().string() << "-" << std::hex << std::setw(16) << std::setfill('0')
+         << fnv1a(model.bytes()) << "-ort" << Ort::GetVersionString() << "-"
+         << levelName(savedLevel(cache.level)) << ".onnx";
+    return cache.directory / name.str();
+}
+
+// Unique per process and call, so concurrent writers never share a file
+std::filesystem::path tempPathFor(const std::filesystem::path& entry) {
+    static const uint32_t processTag = std::random_device{}();
+    static std::atomic<uint32_t> sequence{0};
+    auto temp = entry;
+    temp += ".tmp" + std::to_string(processTag) + "-" + std::to_string(sequence++);
+    return temp;
+}
+
+// Never destroyed: sessions may outlive any static owner
+OrtPrepackedWeightsContainer* prepackedWeights() {
+    static auto* container = new Ort::PrepackedWeightsContainer();
+    return *container;
+}
+
+std::shared_ptr<Ort::Session> openSession(const std::filesystem::path& file, Ort::Env& env,
+                                          const Ort::SessionOptions& options, bool mapped) {
+    if (!mapped) {
+        return std::make_shared<Ort::Session>(env, file.c_str(), options);
+    }
+
+    struct MappedSession {
+        MappedFile mapping;
+        std::optional<Ort::Session> session;  // Destroyed before the mapping
+    };
+    auto holder = std::make_shared<MappedSession>();
+    if (!holder->mapping.open(file.string())) {
+        // Let ORT report the missing or unreadable file
+        return std::make_shared<Ort::Session>(env, file.c_str(), options, prepackedWeights());
+    }
+
+    // ORT-format models reference the mapped bytes instead of copying them
+    bool ortFormat = file.extension() == ".ort";
+    Ort::SessionOptions mappedOptions = options.Clone();
+    if (ortFormat) {
+        mappedOptions.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+        mappedOptions.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+    }
+    holder->session.emplace(env, holder->mapping.data(), holder->mapping.size(), mappedOptions,
+                            prepackedWeights());
+    if (!ortFormat) {
+        // Parsing copied everything out of the mapping
+        holder->mapping.close();
+    }
+    return std::shared_ptr<Ort::Session>(holder, &*holder->session);
+}
+
+// Same file while its path and modification time are unchanged
+std::string registryKey(const std::filesystem::path& modelPath) {
+    std::error_code ec;
+    auto canonical = std::filesystem::weakly_canonical(modelPath, ec);
+    if (ec) {
+        canonical = std::filesystem::absolute(modelPath);
+    }
+    auto modified = std::filesystem::last_write_time(modelPath, ec);
+    return canonical.generic_string() + "@" +
+           std::to_string(ec ? 0 : static_cast<int64_t>(modified.time_since_epoch().count()));
+}
+
+std::mutex registryMutex;
+std::unordered_map<std::string, std::weak_ptr<Ort::Session>> registry;
+
+} // namespace
+
+void OptimizedModelCache::configure(const std::filesystem::path& directory, GraphOptimization level) {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    settings.directory = directory;
+    settings.level = level;
+}
+
+bool OptimizedModelCache::isEnabled() {
+    return !currentSettings().directory.empty();
+}
+
+std::filesystem::path OptimizedModelCache::entryPath(const std::filesystem::path& modelPath) {
+    return entryFor(modelPath, currentSettings());
+}
+
+std::shared_ptr<Ort::Session> OptimizedModelCache::createSession(
+    const std::filesystem::path& modelPath, Ort::Env& env, const Ort::SessionOptions& options,
+    bool hardware) {
+    auto current = currentSettings();
+    auto entry = hardware ? std::filesystem::path() : entryFor(modelPath, current);
+    if (entry.empty()) {
+        return openSession(modelPath, env, options, current.shareModels);
+    }
+
+    std::error_code ec;
+    if (std::filesystem::exists(entry, ec)) {
+        // Already optimized; only the host-specific passes run again
+        try {
+            return openSession(entry, env, entryOptions(options, current.level), current.shareModels);
+        } catch (const Ort::Exception& e) {
+            std::cerr << "[WARNING] Discarding unusable optimized model " << entry << ": "
+                      << e.what() << std::endl;
+            std::filesystem::remove(entry, ec);
+        }
+    }
+
+    // Optimize from the original and keep the result. The file is written
+    // under a temporary name and renamed, so readers never see a partial one.
+    std::filesystem::create_directories(entry.parent_path(), ec);
+    auto temp = tempPathFor(entry);
+    std::shared_ptr<Ort::Session> session;
+    try {
+        Ort::SessionOptions saving = options.Clone();
+        saving.SetOptimizedModelFilePath(temp.c_str());
+        if (current.level == GraphOptimization::ALL) {
+            saving.SetGraphOptimizationLevel(ORT_ENABLE_EXTENDED);
+        }
+        session = openSession(modelPath, env, saving, current.shareModels);
+    } catch (const Ort::Exception& e) {
+        std::filesystem::remove(temp, ec);
+        std::cerr << "[WARNING] Could not cache optimized model " << entry << ": " << e.what()
+                  << std::endl;
+        return openSession(modelPath, env, options, current.shareModels);
+    }
+
+    std::filesystem::rename(temp, entry, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+    }
+    if (current.level != GraphOptimization::ALL) {
+        return session;
+    }
+
+    // The saving session stopped at EXTENDED; finish from the entry, or from
+    // the original if it could not be kept
+    try {
+        return ec ? openSession(modelPath, env, options, current.shareModels)
+                  : openSession(entry, env, entryOptions(options, current.level), current.shareModels);
+    } catch (const Ort::Exception& e) {
+        std::cerr << "[WARNING] Could not reload optimized model " << entry << ": " << e.what()
+                  << std::endl;
+        return session;
+    }
+}
+
+void ModelRegistry::configure(bool shareModels) {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    settings.shareModels = shareModels;
+}
+
+bool ModelRegistry::isSharing() {
+    return currentSettings().shareModels;
+}
+
+std::shared_ptr<Ort::Session> ModelRegistry::acquire(const std::filesystem::path& modelPath,
+                                                     Ort::Env& env,
+                                                     const Ort::SessionOptions& options,
+                                                     bool hardware) {
+    if (!isSharing()) {
+        return OptimizedModelCache::createSession(modelPath, env, options, hardware);
+    }
+
+    auto key = registryKey(modelPath) + (hardware ? "#hardware" : "");
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        auto it = registry.find(key);
+        if (it != registry.end()) {
+            if (auto session = it->second.lock()) {
+                return session;
+            }
+        }
+    }
+
+    // Created unlocked so that different models still load in parallel; a
+    // concurrent load of the same model keeps whichever session lands first
+    auto session = OptimizedModelCache::createSession(modelPath, env, options, hardware);
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::erase_if(registry, [](const auto& entry) { return entry.second.expired(); });
+    auto& slot = registry[key];
+    if (auto existing = slot.lock()) {
+        return existing;
+    }
+    slot = session;
+    return session;
+}
+
+size_t ModelRegistry::size() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return std::count_if(registry.begin(), registry.end(),
+                         [](const auto& entry) { return !entry.second.expired(); });
+}
+
+bool runLoadTasks(const std::vector<std::function<bool()>>& tasks, size_t maxThreads) {
+    if (maxThreads == 0) {
+        maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t numThreads = std::min(maxThreads, tasks.size());
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> ok{true};
+    auto work = [&]() {
+        for (size_t i = next++; i < tasks.size(); i = next++) {
+            if (!tasks[i]()) {
+                ok = false;
+            }
+        }
+    };
+
+    // The calling thread takes a share of the tasks too
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < numThreads; ++i) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return ok;
+}
+
+} // namespace openwakeword
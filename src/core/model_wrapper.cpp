@@ -1,6 +1,11 @@
 #include "core/model_wrapper.h"
+#include "core/model_loader.h"
+#include "utils/kernels.h"
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <numeric>
+#include <string_view>
 
 namespace openwakeword {
 
@@ -12,9 +17,19 @@ ModelWrapper::ModelWrapper(const std::string& modelName, ModelType type)
 
 bool ModelWrapper::loadModel(const std::filesystem::path& modelPath, 
                             Ort::Env& env,
-                            const Ort::SessionOptions& options) {
+                            const Ort::SessionOptions& options,
+                            const Ort::SessionOptions* cpuFallback) {
     try {
-        session_ = std::make_unique<Ort::Session>(env, modelPath.c_str(), options);
+        try {
+            session_ = ModelRegistry::acquire(modelPath, env, options, cpuFallback != nullptr);
+        } catch (const Ort::Exception& e) {
+            if (!cpuFallback) {
+                throw;
+            }
+            std::cerr << "[WARNING] " << modelName_ << ": execution providers failed (" << e.what()
+                      << "), falling back to the CPU" << std::endl;
+            session_ = ModelRegistry::acquire(modelPath, env, *cpuFallback);
+        }
         
         // Get input names
         size_t numInputs = session_->GetInputCount();
@@ -34,6 +49,33 @@ bool ModelWrapper::loadModel(const std::filesystem::path& modelPath,
             outputNamePtrs_.push_back(outputNames_.back().get());
         }
         
+        // Element types; FP16 graphs are supported when every tensor is
+        // float or half (INT8 models quantize internally and keep float I/O)
+        inputTypes_.clear();
+        outputTypes_.clear();
+        for (size_t i = 0; i < numInputs; ++i) {
+            inputTypes_.push_back(session_->GetInputTypeInfo(i).GetTensorTypeAndShapeInfo().GetElementType());
+        }
+        for (size_t i = 0; i < numOutputs; ++i) {
+            outputTypes_.push_back(session_->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetElementType());
+        }
+        auto isHalf = [](ONNXTensorElementDataType type) {
+            return type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16;
+        };
+        auto isFloatOrHalf = [&isHalf](ONNXTensorElementDataType type) {
+            return isHalf(type) || type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+        };
+        halfPrecision_ = std::any_of(inputTypes_.begin(), inputTypes_.end(), isHalf) ||
+                         std::any_of(outputTypes_.begin(), outputTypes_.end(), isHalf);
+        if (halfPrecision_ &&
+            (!std::all_of(inputTypes_.begin(), inputTypes_.end(), isFloatOrHalf) ||
+             !std::all_of(outputTypes_.begin(), outputTypes_.end(), isFloatOrHalf))) {
+            std::cerr << "[ERROR] Failed to load model " << modelPath
+                      << ": FP16 models must only have float or float16 inputs and outputs" << std::endl;
+            session_.reset();
+            return false;
+        }
+        
         return true;
     } catch (const Ort::Exception& e) {
         std::cerr << "[ERROR] Failed to load model " << modelPath << ": " << e.what() << std::endl;
@@ -66,9 +108,152 @@ std::vector<Ort::Value> ModelWrapper::runInference(const std::vector<Ort::Value>
         throw std::runtime_error("Model not loaded");
     }
     
-    return session_->Run(Ort::RunOptions{nullptr}, 
-                        inputNamePtrs_.data(), inputs.data(), inputs.size(),
-                        outputNamePtrs_.data(), outputNamePtrs_.size());
+    if (!halfPrecision_) {
+        return session_->Run(Ort::RunOptions{nullptr}, 
+                            inputNamePtrs_.data(), inputs.data(), inputs.size(),
+                            outputNamePtrs_.data(), outputNamePtrs_.size());
+    }
+    
+    // Convert float inputs the graph takes as FP16; the rest are wrapped as is
+    std::vector<std::vector<uint16_t>> halfInputs(inputs.size());
+    std::vector<Ort::Value> graphInputs;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        auto info = inputs[i].GetTensorTypeAndShapeInfo();
+        auto shape = info.GetShape();
+        size_t count = info.GetElementCount();
+        const float* data = inputs[i].GetTensorData<float>();
+        if (inputTypes_[i] == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+            halfInputs[i].resize(count);
+            kernels::floatToHalf(data, halfInputs[i].data(), count);
+            graphInputs.push_back(Ort::Value::CreateTensor(
+                memoryInfo_, halfInputs[i].data(), count * sizeof(uint16_t),
+                shape.data(), shape.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16));
+        } else {
+            graphInputs.push_back(Ort::Value::CreateTensor<float>(
+                memoryInfo_, const_cast<float*>(data), count, shape.data(), shape.size()));
+        }
+    }
+    
+    auto outputs = session_->Run(Ort::RunOptions{nullptr},
+                                 inputNamePtrs_.data(), graphInputs.data(), graphInputs.size(),
+                                 outputNamePtrs_.data(), outputNamePtrs_.size());
+    
+    // Hand FP16 outputs back as float
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        if (outputTypes_[i] != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+            continue;
+        }
+        auto info = outputs[i].GetTensorTypeAndShapeInfo();
+        auto shape = info.GetShape();
+        auto converted = Ort::Value::CreateTensor<float>(allocator_, shape.data(), shape.size());
+        kernels::halfToFloat(outputs[i].GetTensorData<uint16_t>(),
+                             converted.GetTensorMutableData<float>(), info.GetElementCount());
+        outputs[i] = std::move(converted);
+    }
+    return outputs;
+}
+
+bool ModelWrapper::hasDynamicBatch() const {
+    auto shape = getInputShape(0);
+    return !shape.empty() && shape[0] < 0;
+}
+
+size_t ModelWrapper::elementCount(const std::vector<int64_t>& shape) {
+    size_t count = 1;
+    for (auto dim : shape) {
+        if (dim <= 0) {
+            return 0;
+        }
+        count *= static_cast<size_t>(dim);
+    }
+    return count;
+}
+
+Ort::Value ModelWrapper::createBoundValue(BoundTensor& tensor, ONNXTensorElementDataType type) {
+    if (type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+        tensor.half.assign(tensor.data.size(), 0);
+        return Ort::Value::CreateTensor(memoryInfo_, tensor.half.data(),
+                                        tensor.half.size() * sizeof(uint16_t),
+                                        tensor.shape.data(), tensor.shape.size(), type);
+    }
+    return Ort::Value::CreateTensor<float>(memoryInfo_, tensor.data.data(), tensor.data.size(),
+                                           tensor.shape.data(), tensor.shape.size());
+}
+
+bool ModelWrapper::bindTensors(const std::vector<std::vector<int64_t>>& inputShapes) {
+    if (!session_ || inputShapes.size() != inputNamePtrs_.size()) {
+        return false;
+    }
+    
+    try {
+        ioBinding_.reset();
+        boundValues_.clear();
+        boundInputs_.clear();
+        boundOutputs_.clear();
+        
+        // Allocate input buffers once
+        for (const auto& shape : inputShapes) {
+            size_t count = elementCount(shape);
+            if (count == 0) {
+                return false;
+            }
+            boundInputs_.push_back({shape, std::vector<AudioFloat>(count, 0.0f), {}});
+        }
+        
+        std::vector<Ort::Value> inputs;
+        for (auto& tensor : boundInputs_) {
+            inputs.push_back(Ort::Value::CreateTensor<float>(
+                memoryInfo_, tensor.data.data(), tensor.data.size(),
+                tensor.shape.data(), tensor.shape.size()));
+        }
+        
+        // Warm-up run resolves the concrete output shapes
+        auto outputs = runInference(inputs);
+        for (const auto& output : outputs) {
+            auto shape = output.GetTensorTypeAndShapeInfo().GetShape();
+            boundOutputs_.push_back({shape, std::vector<AudioFloat>(elementCount(shape), 0.0f), {}});
+        }
+        
+        // FP16 tensors bind half staging buffers that runBound() converts
+        ioBinding_ = std::make_unique<Ort::IoBinding>(*session_);
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (inputTypes_[i] == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+                boundValues_.push_back(createBoundValue(boundInputs_[i], inputTypes_[i]));
+                ioBinding_->BindInput(inputNamePtrs_[i], boundValues_.back());
+            } else {
+                ioBinding_->BindInput(inputNamePtrs_[i], inputs[i]);
+            }
+        }
+        for (size_t i = 0; i < boundOutputs_.size(); ++i) {
+            boundValues_.push_back(createBoundValue(boundOutputs_[i], outputTypes_[i]));
+            ioBinding_->BindOutput(outputNamePtrs_[i], boundValues_.back());
+        }
+        
+        // Keep the input tensors alive alongside the bound outputs
+        for (auto& input : inputs) {
+            boundValues_.push_back(std::move(input));
+        }
+        return true;
+    } catch (const Ort::Exception& e) {
+        std::cerr << "[WARNING] IoBinding unavailable for " << modelName_ << ": " << e.what() << std::endl;
+        ioBinding_.reset();
+        boundValues_.clear();
+        return false;
+    }
+}
+
+void ModelWrapper::runBound() {
+    for (auto& tensor : boundInputs_) {
+        if (!tensor.half.empty()) {
+            kernels::floatToHalf(tensor.data.data(), tensor.half.data(), tensor.data.size());
+        }
+    }
+    session_->Run(runOptions_, *ioBinding_);
+    for (auto& tensor : boundOutputs_) {
+        if (!tensor.half.empty()) {
+            kernels::halfToFloat(tensor.half.data(), tensor.data.data(), tensor.data.size());
+        }
+    }
 }
 
 // MelSpectrogramModel implementation
@@ -77,36 +262,79 @@ MelSpectrogramModel::MelSpectrogramModel()
 }
 
 MelBuffer MelSpectrogramModel::computeMelSpectrogram(const AudioBuffer& samples) {
-    if (samples.size() != frameSize_) {
+    auto mels = computeMelSpectrogram(samples.data(), samples.size());
+    return MelBuffer(mels.begin(), mels.end());
+}
+
+bool MelSpectrogramModel::bindIo(size_t frameSize) {
+    if (!bindTensors({{1, static_cast<int64_t>(frameSize)}})) {
+        return false;
+    }
+    melOutput_.resize(boundOutputs_.front().data.size());
+    return true;
+}
+
+std::span<const AudioFloat> MelSpectrogramModel::computeMelSpectrogram(const AudioFloat* samples,
+                                                                    size_t count) {
+    if (count == 0) {
         throw std::invalid_argument("Invalid sample buffer size");
     }
     
-    // Create input tensor
-    std::vector<int64_t> inputShape{1, static_cast<int64_t>(frameSize_)};
+    const float* melData = nullptr;
+    size_t melCount = 0;
+    std::vector<Ort::Value> outputs;
+    
+    if (isBound() && count == boundInputs_.front().data.size()) {
+        // Allocation-free path through the bound tensors
+        std::copy(samples, samples + count, boundInputs_.front().data.begin());
+        runBound();
+        melData = boundOutputs_.front().data.data();
+        melCount = boundOutputs_.front().data.size();
+    } else {
+        // Create input tensor
+        std::vector<int64_t> inputShape{1, static_cast<int64_t>(count)};
+        std::vector<Ort::Value> inputs;
+        inputs.push_back(Ort::Value::CreateTensor<float>(
+            memoryInfo_, const_cast<float*>(samples), count,
+            inputShape.data(), inputShape.size()));
+        
+        // Run inference
+        outputs = runInference(inputs);
+        
+        // Extract mel spectrogram data
+        const auto& melOut = outputs.front();
+        const auto melShape = melOut.GetTensorTypeAndShapeInfo().GetShape();
+        melData = melOut.GetTensorData<float>();
+        melCount = std::accumulate(melShape.begin(), melShape.end(), 1, std::multiplies<>());
+    }
+    
+    // Scale mels for Google speech embedding model
+    melOutput_.resize(melCount);
+    kernels::divideAdd(melData, melOutput_.data(), melCount, 10.0f, 2.0f);
+    
+    return melOutput_;
+}
+
+size_t MelSpectrogramModel::computeMelSpectrogramBatch(const AudioFloat* samples, size_t batch,
+                                                      size_t count, MelBuffer& out) {
+    std::vector<int64_t> inputShape{static_cast<int64_t>(batch), static_cast<int64_t>(count)};
     std::vector<Ort::Value> inputs;
     inputs.push_back(Ort::Value::CreateTensor<float>(
-        memoryInfo_, const_cast<float*>(samples.data()), frameSize_,
+        memoryInfo_, const_cast<float*>(samples), batch * count,
         inputShape.data(), inputShape.size()));
     
-    // Run inference
     auto outputs = runInference(inputs);
     
-    // Extract mel spectrogram data
     const auto& melOut = outputs.front();
-    const auto melInfo = melOut.GetTensorTypeAndShapeInfo();
-    const auto melShape = melInfo.GetShape();
-    
+    const auto melShape = melOut.GetTensorTypeAndShapeInfo().GetShape();
     const float* melData = melOut.GetTensorData<float>();
     size_t melCount = std::accumulate(melShape.begin(), melShape.end(), 1, std::multiplies<>());
     
     // Scale mels for Google speech embedding model
-    MelBuffer result;
-    result.reserve(melCount);
-    for (size_t i = 0; i < melCount; ++i) {
-        result.push_back((melData[i] / 10.0f) + 2.0f);
-    }
+    out.resize(melCount);
+    kernels::divideAdd(melData, out.data(), melCount, 10.0f, 2.0f);
     
-    return result;
+    return melCount / (batch * NUM_MELS);
 }
 
 // EmbeddingModel implementation
@@ -120,12 +348,31 @@ FeatureBuffer EmbeddingModel::extractEmbeddings(const MelBuffer& mels) {
         throw std::invalid_argument("Insufficient mel data for embedding extraction");
     }
     
+    auto embeddings = extractEmbeddings(mels.data());
+    return FeatureBuffer(embeddings.begin(), embeddings.end());
+}
+
+bool EmbeddingModel::bindIo() {
+    return bindTensors({{1, static_cast<int64_t>(EMBEDDING_WINDOW_SIZE),
+                         static_cast<int64_t>(NUM_MELS), 1}});
+}
+
+std::span<const AudioFloat> EmbeddingModel::extractEmbeddings(const AudioFloat* mels) {
+    size_t expectedSize = EMBEDDING_WINDOW_SIZE * NUM_MELS;
+    
+    if (isBound()) {
+        // Allocation-free path through the bound tensors
+        std::copy(mels, mels + expectedSize, boundInputs_.front().data.begin());
+        runBound();
+        return boundOutputs_.front().data;
+    }
+    
     // Create input tensor
     std::vector<int64_t> inputShape{1, static_cast<int64_t>(EMBEDDING_WINDOW_SIZE), 
                                    static_cast<int64_t>(NUM_MELS), 1};
     std::vector<Ort::Value> inputs;
     inputs.push_back(Ort::Value::CreateTensor<float>(
-        memoryInfo_, const_cast<float*>(mels.data()), expectedSize,
+        memoryInfo_, const_cast<float*>(mels), expectedSize,
         inputShape.data(), inputShape.size()));
     
     // Run inference
@@ -139,7 +386,33 @@ FeatureBuffer EmbeddingModel::extractEmbeddings(const MelBuffer& mels) {
     const auto embShape = embInfo.GetShape();
     size_t embCount = std::accumulate(embShape.begin(), embShape.end(), 1, std::multiplies<>());
     
-    return FeatureBuffer(embData, embData + embCount);
+    embOutput_.assign(embData, embData + embCount);
+    return embOutput_;
+}
+
+void EmbeddingModel::extractEmbeddingsBatch(const AudioFloat* const* windows, size_t batch,
+                                            std::vector<AudioFloat>& scratch, FeatureBuffer& out) {
+    const size_t windowSize = EMBEDDING_WINDOW_SIZE * NUM_MELS;
+    
+    // Gather windows into one [batch, 76, 32, 1] input
+    scratch.resize(batch * windowSize);
+    for (size_t i = 0; i < batch; ++i) {
+        std::copy(windows[i], windows[i] + windowSize, scratch.begin() + i * windowSize);
+    }
+    
+    std::vector<int64_t> inputShape{static_cast<int64_t>(batch),
+                                   static_cast<int64_t>(EMBEDDING_WINDOW_SIZE),
+                                   static_cast<int64_t>(NUM_MELS), 1};
+    std::vector<Ort::Value> inputs;
+    inputs.push_back(Ort::Value::CreateTensor<float>(
+        memoryInfo_, scratch.data(), scratch.size(),
+        inputShape.data(), inputShape.size()));
+    
+    auto outputs = runInference(inputs);
+    
+    const auto& embOut = outputs.front();
+    const float* embData = embOut.GetTensorData<float>();
+    out.assign(embData, embData + batch * EMBEDDING_FEATURES);
 }
 
 // WakeWordModel implementation
@@ -153,12 +426,30 @@ float WakeWordModel::predict(const FeatureBuffer& features) {
         throw std::invalid_argument("Insufficient features for wake word detection");
     }
     
+    return predict(features.data());
+}
+
+bool WakeWordModel::bindIo() {
+    return bindTensors({{1, static_cast<int64_t>(WAKEWORD_FEATURES),
+                         static_cast<int64_t>(EMBEDDING_FEATURES)}});
+}
+
+float WakeWordModel::predict(const AudioFloat* features) {
+    size_t expectedSize = WAKEWORD_FEATURES * EMBEDDING_FEATURES;
+    
+    if (isBound()) {
+        // Allocation-free path through the bound tensors
+        std::copy(features, features + expectedSize, boundInputs_.front().data.begin());
+        runBound();
+        return boundOutputs_.front().data[0];
+    }
+    
     // Create input tensor
     std::vector<int64_t> inputShape{1, static_cast<int64_t>(WAKEWORD_FEATURES), 
                                    static_cast<int64_t>(EMBEDDING_FEATURES)};
     std::vector<Ort::Value> inputs;
     inputs.push_back(Ort::Value::CreateTensor<float>(
-        memoryInfo_, const_cast<float*>(features.data()), expectedSize,
+        memoryInfo_, const_cast<float*>(features), expectedSize,
         inputShape.data(), inputShape.size()));
     
     // Run inference
@@ -168,7 +459,143 @@ float WakeWordModel::predict(const FeatureBuffer& features) {
     const auto& out = outputs.front();
     const float* data = out.GetTensorData<float>();
     
-    return data[0];  // Assuming single output
+    return data[0];  // First output only, see predictAll for merged graphs
+}
+
+void WakeWordModel::predictAll(const AudioFloat* features, float* scores) {
+    size_t expectedSize = WAKEWORD_FEATURES * EMBEDDING_FEATURES;
+    
+    if (isBound()) {
+        std::copy(features, features + expectedSize, boundInputs_.front().data.begin());
+        runBound();
+        for (size_t i = 0; i < boundOutputs_.size(); ++i) {
+            scores[i] = boundOutputs_[i].data[0];
+        }
+        return;
+    }
+    
+    // Create input tensor
+    std::vector<int64_t> inputShape{1, static_cast<int64_t>(WAKEWORD_FEATURES), 
+                                   static_cast<int64_t>(EMBEDDING_FEATURES)};
+    std::vector<Ort::Value> inputs;
+    inputs.push_back(Ort::Value::CreateTensor<float>(
+        memoryInfo_, const_cast<float*>(features), expectedSize,
+        inputShape.data(), inputShape.size()));
+    
+    // Run inference once for all outputs
+    auto outputs = runInference(inputs);
+    
+    // Extract one probability per output
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        scores[i] = outputs[i].GetTensorData<float>()[0];
+    }
+}
+
+void WakeWordModel::predictBatch(const AudioFloat* const* windows, size_t batch,
+                                 std::vector<AudioFloat>& scratch, float* scores) {
+    const size_t windowSize = WAKEWORD_FEATURES * EMBEDDING_FEATURES;
+    
+    if (!hasDynamicBatch()) {
+        // Fixed batch size: wrap each window in place and run it on its own
+        std::vector<int64_t> inputShape{1, static_cast<int64_t>(WAKEWORD_FEATURES),
+                                       static_cast<int64_t>(EMBEDDING_FEATURES)};
+        for (size_t i = 0; i < batch; ++i) {
+            std::vector<Ort::Value> inputs;
+            inputs.push_back(Ort::Value::CreateTensor<float>(
+                memoryInfo_, const_cast<float*>(windows[i]), windowSize,
+                inputShape.data(), inputShape.size()));
+            auto outputs = runInference(inputs);
+            scores[i] = outputs.front().GetTensorData<float>()[0];
+        }
+        return;
+    }
+    
+    // Gather windows into one [batch, 16, 96] input
+    scratch.resize(batch * windowSize);
+    for (size_t i = 0; i < batch; ++i) {
+        std::copy(windows[i], windows[i] + windowSize, scratch.begin() + i * windowSize);
+    }
+    
+    std::vector<int64_t> inputShape{static_cast<int64_t>(batch),
+                                   static_cast<int64_t>(WAKEWORD_FEATURES),
+                                   static_cast<int64_t>(EMBEDDING_FEATURES)};
+    std::vector<Ort::Value> inputs;
+    inputs.push_back(Ort::Value::CreateTensor<float>(
+        memoryInfo_, scratch.data(), scratch.size(),
+        inputShape.data(), inputShape.size()));
+    
+    auto outputs = runInference(inputs);
+    
+    // One score per batch row
+    const float* data = outputs.front().GetTensorData<float>();
+    size_t stride = outputs.front().GetTensorTypeAndShapeInfo().GetElementCount() / batch;
+    for (size_t i = 0; i < batch; ++i) {
+        scores[i] = data[i * stride];
+    }
+}
+
+// CustomVerifierModel implementation
+CustomVerifierModel::CustomVerifierModel(const std::string& wakeWord)
+    : ModelWrapper(wakeWord, ModelType::CUSTOM_VERIFIER) {
+}
+
+void CustomVerifierModel::verifyBatch(const AudioFloat* const* windows, size_t batch,
+                                      std::vector<AudioFloat>& scratch, float* probabilities) {
+    const size_t windowSize = WAKEWORD_FEATURES * EMBEDDING_FEATURES;
+    
+    // scikit-learn exports take flat rows; a [N, 16, 96] input is accepted too
+    auto rowShape = [this](size_t rows) {
+        std::vector<int64_t> shape{static_cast<int64_t>(rows)};
+        if (getInputShape().size() == 3) {
+            shape.push_back(static_cast<int64_t>(WAKEWORD_FEATURES));
+            shape.push_back(static_cast<int64_t>(EMBEDDING_FEATURES));
+        } else {
+            shape.push_back(static_cast<int64_t>(windowSize));
+        }
+        return shape;
+    };
+    
+    // Labels come out as int64; the probabilities are the float output
+    size_t probabilityOutput = 0;
+    while (probabilityOutput + 1 < outputTypes_.size() &&
+           outputTypes_[probabilityOutput] != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+        probabilityOutput++;
+    }
+    auto positive = [probabilityOutput](const std::vector<Ort::Value>& outputs, size_t rows,
+                                        float* out) {
+        const auto& value = outputs[probabilityOutput];
+        const float* data = value.GetTensorData<float>();
+        size_t stride = value.GetTensorTypeAndShapeInfo().GetElementCount() / rows;
+        for (size_t i = 0; i < rows; ++i) {
+            out[i] = data[i * stride + stride - 1];
+        }
+    };
+    
+    if (!hasDynamicBatch()) {
+        // Fixed batch size: wrap each window in place and run it on its own
+        auto inputShape = rowShape(1);
+        for (size_t i = 0; i < batch; ++i) {
+            std::vector<Ort::Value> inputs;
+            inputs.push_back(Ort::Value::CreateTensor<float>(
+                memoryInfo_, const_cast<float*>(windows[i]), windowSize,
+                inputShape.data(), inputShape.size()));
+            positive(runInference(inputs), 1, probabilities + i);
+        }
+        return;
+    }
+    
+    // Gather windows into one input with a row per window
+    scratch.resize(batch * windowSize);
+    for (size_t i = 0; i < batch; ++i) {
+        std::copy(windows[i], windows[i] + windowSize, scratch.begin() + i * windowSize);
+    }
+    
+    auto inputShape = rowShape(batch);
+    std::vector<Ort::Value> inputs;
+    inputs.push_back(Ort::Value::CreateTensor<float>(
+        memoryInfo_, scratch.data(), scratch.size(),
+        inputShape.data(), inputShape.size()));
+    positive(runInference(inputs), batch, probabilities);
 }
 
 // VADModel implementation
@@ -176,15 +603,81 @@ VADModel::VADModel()
     : ModelWrapper("VAD", ModelType::VAD) {
 }
 
+bool VADModel::prepare() {
+    if (!session_) {
+        return false;
+    }
+    
+    v5_ = std::any_of(inputNamePtrs_.begin(), inputNamePtrs_.end(),
+                      [](const char* name) { return std::string_view(name) == "state"; });
+    resetState();
+    return true;
+}
+
 float VADModel::predictVoiceActivity(const AudioBuffer& samples) {
-    // TODO: Implement VAD prediction
-    // This will depend on the specific VAD model architecture
-    (void)samples; // Suppress unused parameter warning
-    return 1.0f;  // Placeholder
+    if (!session_ || samples.size() < FRAME_SAMPLES) {
+        return 0.0f;
+    }
+    
+    // v5 expects the tail of the previous frame in front of the new one
+    const size_t context = v5_ ? V5_CONTEXT_SAMPLES : 0;
+    input_.resize(context + FRAME_SAMPLES);
+    std::copy(samples.begin(), samples.begin() + FRAME_SAMPLES, input_.begin() + context);
+    
+    std::array<int64_t, 2> inputShape{1, static_cast<int64_t>(input_.size())};
+    std::array<int64_t, 3> stateShape{2, 1, v5_ ? 128 : 64};
+    const size_t stateCount = v5_ ? STATE_SIZE : STATE_SIZE / 2;
+    int64_t sampleRate = SAMPLE_RATE;
+    
+    try {
+        // Inputs in model order: input, sr, and h/c or state
+        std::vector<Ort::Value> inputs;
+        for (const char* name : inputNamePtrs_) {
+            std::string_view inputName(name);
+            if (inputName == "sr") {
+                inputs.push_back(Ort::Value::CreateTensor<int64_t>(memoryInfo_, &sampleRate, 1, nullptr, 0));
+            } else if (inputName == "h" || inputName == "state") {
+                inputs.push_back(Ort::Value::CreateTensor<float>(
+                    memoryInfo_, internalState_.data(), stateCount, stateShape.data(), stateShape.size()));
+            } else if (inputName == "c") {
+                inputs.push_back(Ort::Value::CreateTensor<float>(
+                    memoryInfo_, internalState_.data() + STATE_SIZE / 2, stateCount,
+                    stateShape.data(), stateShape.size()));
+            } else {
+                inputs.push_back(Ort::Value::CreateTensor<float>(
+                    memoryInfo_, input_.data(), input_.size(), inputShape.data(), inputShape.size()));
+            }
+        }
+        
+        auto outputs = runInference(inputs);
+        
+        // Outputs: probability, then hn/cn or the new state
+        float probability = 0.0f;
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            std::string_view outputName(outputNamePtrs_[i]);
+            const float* data = outputs[i].GetTensorData<float>();
+            if (outputName == "output") {
+                probability = data[0];
+            } else if (outputName == "cn") {
+                std::copy(data, data + stateCount, internalState_.begin() + STATE_SIZE / 2);
+            } else {
+                std::copy(data, data + stateCount, internalState_.begin());
+            }
+        }
+        
+        if (v5_) {
+            std::copy(input_.end() - context, input_.end(), input_.begin());
+        }
+        return probability;
+    } catch (const Ort::Exception& e) {
+        std::cerr << "[ERROR] VAD inference failed: " << e.what() << std::endl;
+        return 0.0f;
+    }
 }
 
 void VADModel::resetState() {
-    internalState_.clear();
+    internalState_.assign(STATE_SIZE, 0.0f);
+    input_.assign(v5_ ? V5_CONTEXT_SAMPLES + FRAME_SAMPLES : FRAME_SAMPLES, 0.0f);
 }
 
 } // namespace openwakeword
\ No newline at end of file
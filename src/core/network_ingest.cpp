@@ -0,0 +1,474 @@
+#include "core/network_ingest.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+#endif
+
+namespace openwakeword {
+
+namespace {
+
+// Longest wait between checks for stop() and idle sources
+constexpr int POLL_INTERVAL_MS = 100;
+
+// Recheck interval for connections held back by a full stream
+constexpr int PAUSE_INTERVAL_MS = 5;
+
+// Largest UDP payload
+constexpr size_t MAX_DATAGRAM_SAMPLES = 65536 / sizeof(AudioSample);
+
+// Datagrams read per wake-up before the other sockets get their turn
+constexpr size_t MAX_DATAGRAMS_PER_WAKE = 64;
+
+// RTP sequence handling: gaps up to this many packets are filled with
+// silence, older packets within the reorder window are dropped, and any
+// larger jump is taken as a sender restart
+constexpr int MAX_CONCEALED_PACKETS = 25;
+constexpr int MAX_MISORDER_PACKETS = 64;
+
+// Kernel buffer for the UDP socket, shared by every sender
+constexpr int UDP_RECEIVE_BUFFER = 4 << 20;
+
+#ifndef _WIN32
+bool setNonBlocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+#endif
+
+} // namespace
+
+#ifdef _WIN32
+
+class NetworkIngest::EventPoller {};
+
+#else
+
+// Readiness of the listening and connected sockets
+class NetworkIngest::EventPoller {
+public:
+#ifdef __linux__
+    EventPoller() : epoll_(::epoll_create1(EPOLL_CLOEXEC)) {}
+    ~EventPoller() {
+        if (epoll_ >= 0) {
+            ::close(epoll_);
+        }
+    }
+
+    bool isValid() const { return epoll_ >= 0; }
+
+    bool add(int fd) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        return ::epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event) == 0;
+    }
+
+    void setReadable(int fd, bool readable) {
+        epoll_event event{};
+        event.events = readable ? static_cast<uint32_t>(EPOLLIN) : 0u;
+        event.data.fd = fd;
+        ::epoll_ctl(epoll_, EPOLL_CTL_MOD, fd, &event);
+    }
+
+    void remove(int fd) {
+        ::epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+    }
+
+    // Descriptors that are readable or closed by the peer
+    void wait(int timeoutMs, std::vector<int>& ready) {
+        ready.clear();
+        int count = ::epoll_wait(epoll_, events_, MAX_EVENTS, timeoutMs);
+        for (int i = 0; i < count; ++i) {
+            ready.push_back(events_[i].data.fd);
+        }
+    }
+
+private:
+    static constexpr int MAX_EVENTS = 256;
+
+    int epoll_;
+    epoll_event events_[MAX_EVENTS];
+#else
+    bool isValid() const { return true; }
+
+    bool add(int fd) {
+        fds_.push_back({fd, POLLIN, 0});
+        return true;
+    }
+
+    void setReadable(int fd, bool readable) {
+        for (auto& entry : fds_) {
+            if (entry.fd == fd) {
+                entry.events = readable ? POLLIN : 0;
+            }
+        }
+    }
+
+    void remove(int fd) {
+        std::erase_if(fds_, [fd](const pollfd& entry) { return entry.fd == fd; });
+    }
+
+    void wait(int timeoutMs, std::vector<int>& ready) {
+        ready.clear();
+        if (::poll(fds_.data(), fds_.size(), timeoutMs) <= 0) {
+            return;
+        }
+        for (const auto& entry : fds_) {
+            if ((entry.revents & (POLLIN | POLLHUP | POLLERR)) != 0) {
+                ready.push_back(entry.fd);
+            }
+        }
+    }
+
+private:
+    std::vector<pollfd> fds_;
+#endif
+};
+
+#endif
+
+NetworkIngest::NetworkIngest(Engine& engine, const Config& config)
+    : engine_(engine),
+      config_(config),
+      buffer_(std::max(MAX_DATAGRAM_SAMPLES, config.frameSize)) {
+}
+
+NetworkIngest::~NetworkIngest() {
+    closeAll();
+#ifndef _WIN32
+    if (listenSocket_ >= 0) {
+        ::close(listenSocket_);
+        std::error_code ignored;
+        std::filesystem::remove(config_.listenUnixPath, ignored);
+    }
+#endif
+}
+
+#ifdef _WIN32
+
+bool NetworkIngest::open() {
+    std::cerr << "[ERROR] Network inputs are not supported on Windows" << std::endl;
+    return false;
+}
+
+void NetworkIngest::run() {
+}
+
+void NetworkIngest::closeAll() {
+}
+
+#else
+
+bool NetworkIngest::open() {
+    poller_ = std::make_unique<EventPoller>();
+    if (!poller_->isValid()) {
+        std::cerr << "[ERROR] Failed to create network event loop" << std::endl;
+        return false;
+    }
+
+    if (!config_.listenUnixPath.empty() && !openUnixSocket()) {
+        return false;
+    }
+    if (!config_.listenUdp.empty() && !openUdpSocket()) {
+        return false;
+    }
+
+    running_ = true;
+    return true;
+}
+
+bool NetworkIngest::openUnixSocket() {
+    const std::string path = config_.listenUnixPath.string();
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "[ERROR] Unix socket path too long: " << path << std::endl;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), address.sun_path);
+
+    // A socket left behind by an earlier run would make bind fail
+    std::error_code error;
+    if (std::filesystem::is_socket(config_.listenUnixPath, error)) {
+        std::filesystem::remove(config_.listenUnixPath, error);
+    }
+
+    listenSocket_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenSocket_ < 0) {
+        std::cerr << "[ERROR] Failed to create Unix socket" << std::endl;
+        return false;
+    }
+
+    if (::bind(listenSocket_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenSocket_, SOMAXCONN) != 0 || !setNonBlocking(listenSocket_) ||
+        !poller_->add(listenSocket_)) {
+        std::cerr << "[ERROR] Failed to listen on Unix socket: " << path << std::endl;
+        ::close(listenSocket_);
+        listenSocket_ = -1;
+        return false;
+    }
+
+    if (config_.outputMode == OutputMode::VERBOSE) {
+        std::cerr << "[LOG] Listening for PCM streams on " << path << std::endl;
+    }
+    return true;
+}
+
+bool NetworkIngest::openUdpSocket() {
+    // [HOST:]PORT, IPv4 only; without a host only local senders are heard
+    std::string host;
+    std::string port = config_.listenUdp;
+    size_t colon = port.rfind(':');
+    if (colon != std::string::npos) {
+        host = port.substr(0, colon);
+        port = port.substr(colon + 1);
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int portNumber = std::atoi(port.c_str());
+    if (portNumber <= 0 || portNumber > 65535 ||
+        (!host.empty() && ::inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1)) {
+        std::cerr << "[ERROR] Invalid UDP address: " << config_.listenUdp << std::endl;
+        return false;
+    }
+    address.sin_port = htons(static_cast<uint16_t>(portNumber));
+
+    int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        std::cerr << "[ERROR] Failed to create UDP socket" << std::endl;
+        return false;
+    }
+    datagrams_ = std::make_unique<DatagramAudioReader>(fd, !config_.udpRaw);
+
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    int receiveBuffer = UDP_RECEIVE_BUFFER;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        !setNonBlocking(fd) || !poller_->add(fd)) {
+        std::cerr << "[ERROR] Failed to bind UDP socket: " << config_.listenUdp << std::endl;
+        datagrams_.reset();
+        return false;
+    }
+
+    if (config_.outputMode == OutputMode::VERBOSE) {
+        std::cerr << "[LOG] Listening for " << (config_.udpRaw ? "raw PCM" : "RTP/L16")
+                  << " datagrams on " << config_.listenUdp << std::endl;
+    }
+    return true;
+}
+
+void NetworkIngest::run() {
+    std::vector<int> ready;
+    while (running_ && engine_.isRunning()) {
+        poller_->wait(pausedConnections_ > 0 ? PAUSE_INTERVAL_MS : POLL_INTERVAL_MS, ready);
+
+        for (int fd : ready) {
+            if (fd == listenSocket_) {
+                acceptConnections();
+            } else if (datagrams_ && fd == datagrams_->getDescriptor()) {
+                readDatagrams();
+            } else {
+                auto connection = connections_.find(fd);
+                if (connection != connections_.end() && !connection->second.paused) {
+                    readConnection(connection);
+                }
+            }
+        }
+
+        resumeConnections();
+        expireSources();
+    }
+
+    closeAll();
+}
+
+void NetworkIngest::acceptConnections() {
+    while (true) {
+        int fd = ::accept(listenSocket_, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+
+        Connection connection;
+        connection.reader = std::make_unique<SocketAudioReader>(fd);
+        if (openStreams() >= config_.maxNetworkStreams) {
+            if (!refusedLogged_ && config_.outputMode != OutputMode::QUIET) {
+                std::cerr << "[WARNING] Network stream limit (" << config_.maxNetworkStreams
+                          << ") reached; refusing connections" << std::endl;
+                refusedLogged_ = true;
+            }
+            ++refusedSources_;
+            continue;
+        }
+        if (!setNonBlocking(fd) || !poller_->add(fd)) {
+            std::cerr << "[WARNING] Failed to register socket connection" << std::endl;
+            continue;
+        }
+
+        std::string name = "unix:" + config_.listenUnixPath.string() + "#" +
+                           std::to_string(nextConnection_++);
+        connection.stream = engine_.openStream(name);
+        if (config_.outputMode == OutputMode::VERBOSE) {
+            std::cerr << "[LOG] Opened stream " << name << std::endl;
+        }
+        connections_.emplace(fd, std::move(connection));
+    }
+}
+
+void NetworkIngest::readConnection(std::map<int, Connection>::iterator connection) {
+    Connection& state = connection->second;
+
+    // Take no more than fits, so pushAudio never waits; the rest stays in
+    // the socket and the sender is held back
+    size_t space = std::min(engine_.pushSpace(*state.stream), buffer_.size());
+    if (space == 0) {
+        state.paused = true;
+        ++pausedConnections_;
+        poller_->setReadable(connection->first, false);
+        return;
+    }
+
+    size_t count = state.reader->read(buffer_.data(), space);
+    if (count > 0) {
+        engine_.pushAudio(*state.stream, buffer_.data(), count);
+    } else if (!state.reader->hasMore()) {
+        closeConnection(connection);
+    }
+}
+
+void NetworkIngest::closeConnection(std::map<int, Connection>::iterator connection) {
+    Connection& state = connection->second;
+    if (state.paused) {
+        --pausedConnections_;
+    }
+    poller_->remove(connection->first);
+    engine_.closeStream(*state.stream);
+    if (config_.outputMode == OutputMode::VERBOSE) {
+        std::cerr << "[LOG] Closed stream " << state.stream->getName() << std::endl;
+    }
+    connections_.erase(connection);
+}
+
+void NetworkIngest::resumeConnections() {
+    if (pausedConnections_ == 0) {
+        return;
+    }
+    for (auto& [fd, connection] : connections_) {
+        if (connection.paused && engine_.pushSpace(*connection.stream) > 0) {
+            connection.paused = false;
+            --pausedConnections_;
+            poller_->setReadable(fd, true);
+        }
+    }
+}
+
+void NetworkIngest::readDatagrams() {
+    const auto now = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < MAX_DATAGRAMS_PER_WAKE; ++i) {
+        size_t count = datagrams_->read(buffer_.data(), buffer_.size());
+        if (datagrams_->wouldBlock() || !datagrams_->hasMore()) {
+            return;
+        }
+        if (count == 0) {
+            continue;  // Empty or not RTP
+        }
+
+        // Every source costs a whole engine stream, so unknown ones are
+        // dropped while at the limit
+        const DatagramSource& sender = datagrams_->getSource();
+        if (openStreams() >= config_.maxNetworkStreams && !sources_.contains(sender)) {
+            if (!refusedLogged_ && config_.outputMode != OutputMode::QUIET) {
+                std::cerr << "[WARNING] Network stream limit (" << config_.maxNetworkStreams
+                          << ") reached; dropping datagrams from new sources" << std::endl;
+                refusedLogged_ = true;
+            }
+            ++refusedSources_;
+            continue;
+        }
+        auto [entry, opened] = sources_.try_emplace(sender);
+        Source& source = entry->second;
+        if (opened) {
+            std::string name = "udp:" + sender.toString();
+            source.stream = engine_.openStream(name);
+            if (config_.outputMode == OutputMode::VERBOSE) {
+                std::cerr << "[LOG] Opened stream " << name << std::endl;
+            }
+        } else if (datagrams_->isRtp()) {
+            int gap = static_cast<int16_t>(datagrams_->getSequence() - source.nextSequence);
+            if (gap < 0 && gap >= -MAX_MISORDER_PACKETS) {
+                continue;  // Late or duplicate
+            }
+            if (gap > 0 && gap <= MAX_CONCEALED_PACKETS) {
+                // Assume the lost packets were as long as this one
+                silence_.assign(count, 0);
+                for (int lost = 0; lost < gap; ++lost) {
+                    pushDatagramAudio(*source.stream, silence_.data(), count);
+                }
+                concealedSamples_ += static_cast<size_t>(gap) * count;
+            }
+        }
+
+        source.nextSequence = static_cast<uint16_t>(datagrams_->getSequence() + 1);
+        source.lastPacket = now;
+        pushDatagramAudio(*source.stream, buffer_.data(), count);
+    }
+}
+
+void NetworkIngest::pushDatagramAudio(StreamContext& stream, const AudioSample* samples,
+                                      size_t count) {
+    // A sender cannot be held back, so what does not fit is lost
+    size_t pushed = engine_.tryPushAudio(stream, samples, count);
+    droppedSamples_ += count - pushed;
+}
+
+void NetworkIngest::expireSources() {
+    const auto now = std::chrono::steady_clock::now();
+    const auto timeout = std::chrono::milliseconds(config_.streamTimeoutMs);
+
+    for (auto it = sources_.begin(); it != sources_.end();) {
+        if (now - it->second.lastPacket < timeout) {
+            ++it;
+            continue;
+        }
+        engine_.closeStream(*it->second.stream);
+        if (config_.outputMode == OutputMode::VERBOSE) {
+            std::cerr << "[LOG] Closed idle stream " << it->second.stream->getName() << std::endl;
+        }
+        it = sources_.erase(it);
+    }
+}
+
+void NetworkIngest::closeAll() {
+    while (!connections_.empty()) {
+        closeConnection(connections_.begin());
+    }
+    for (auto& [sender, source] : sources_) {
+        engine_.closeStream(*source.stream);
+    }
+    sources_.clear();
+}
+
+#endif
+
+} // namespace openwakeword
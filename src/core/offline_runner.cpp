@@ -0,0 +1,465 @@
+#include "core/offline_runner.h"
+#include "core/model_loader.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include "core/sliding_window.h"
+#include "processors/audio_converter.h"
+#include "processors/audio_reader.h"
+#include "utils/kernels.h"
+
+namespace openwakeword {
+
+namespace {
+
+// Audio frames read and scored per batched step within a file
+constexpr size_t OFFLINE_BLOCK_FRAMES = 64;
+
+std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+bool isAudioFile(const std::filesystem::path& path) {
+    auto extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return extension == ".wav" || extension == ".pcm" || extension == ".raw";
+}
+
+} // namespace
+
+OfflineRunner::OfflineRunner(const Config& config)
+    : config_(config),
+      ortEnvironment_(OrtEnvironment::acquire(config_)),
+      env_(ortEnvironment_->env()),
+      sessionOptions_(ortEnvironment_->createSessionOptions(config_)),
+      melOptions_(ortEnvironment_->createSessionOptions(config_, config_.melProviders, "mel")),
+      embeddingOptions_(ortEnvironment_->createSessionOptions(config_, config_.embeddingProviders,
+                                                              "embedding")) {
+    for (const auto& wwConfig : config_.wakeWordConfigs) {
+        wakeWordOptions_.push_back(ortEnvironment_->createSessionOptions(
+            config_, wwConfig.providers, wwConfig.name));
+    }
+}
+
+OfflineRunner::~OfflineRunner() {
+    if (embeddingBatcher_) {
+        embeddingBatcher_->stop();
+    }
+}
+
+bool OfflineRunner::initialize() {
+    if (!config_.embeddingCacheDir.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(config_.embeddingCacheDir, ec);
+        if (ec) {
+            std::cerr << "[ERROR] Failed to create embedding cache directory: "
+                      << config_.embeddingCacheDir << std::endl;
+            return false;
+        }
+    }
+
+    // Sessions are created in parallel; they dominate startup
+    embeddingModel_ = std::make_unique<EmbeddingModel>();
+    for (const auto& wwConfig : config_.wakeWordConfigs) {
+        wakeWordNames_.push_back(wwConfig.name);
+        wakeWordModels_.push_back(std::make_unique<WakeWordModel>(wakeWordNames_.back()));
+    }
+
+    std::vector<std::function<bool()>> loads;
+    loads.push_back([this]() {
+        melFrontend_ = createMelFrontend(config_, env_, melOptions_.options,
+                                         melOptions_.hardware ? &sessionOptions_ : nullptr);
+        return melFrontend_ != nullptr;
+    });
+    loads.push_back([this]() {
+        if (!embeddingModel_->loadModel(config_.embModelPath, env_, embeddingOptions_.options,
+                                        embeddingOptions_.hardware ? &sessionOptions_ : nullptr)) {
+            std::cerr << "[ERROR] Failed to load speech embedding model" << std::endl;
+            return false;
+        }
+        return true;
+    });
+    for (size_t i = 0; i < wakeWordModels_.size(); ++i) {
+        loads.push_back([this, i]() {
+            const auto& options = wakeWordOptions_[i];
+            if (!wakeWordModels_[i]->loadModel(config_.wakeWordConfigs[i].modelPath, env_,
+                                               options.options,
+                                               options.hardware ? &sessionOptions_ : nullptr)) {
+                std::cerr << "[ERROR] Failed to load wake word model: " << wakeWordNames_[i]
+                          << std::endl;
+                return false;
+            }
+            return true;
+        });
+    }
+    if (!runLoadTasks(loads, config_.loadThreads)) {
+        return false;
+    }
+
+    embeddingBatcher_ = std::make_unique<EmbeddingBatcher>(
+        *embeddingModel_, config_.embeddingBatchSize,
+        std::chrono::microseconds(config_.batchWaitMicros), config_.workerThreads);
+
+    return true;
+}
+
+bool OfflineRunner::collectInputs(const Config& config, std::vector<std::filesystem::path>& files) {
+    files.clear();
+
+    auto addInput = [&files](const std::filesystem::path& input) {
+        std::error_code ec;
+        if (std::filesystem::is_directory(input, ec)) {
+            std::vector<std::filesystem::path> found;
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(
+                     input, std::filesystem::directory_options::skip_permission_denied, ec)) {
+                if (entry.is_regular_file(ec) && isAudioFile(entry.path())) {
+                    found.push_back(entry.path());
+                }
+            }
+            std::sort(found.begin(), found.end());
+            files.insert(files.end(), found.begin(), found.end());
+        } else {
+            files.push_back(input);
+        }
+    };
+
+    for (const auto& input : config.offlineInputs) {
+        addInput(input);
+    }
+
+    if (!config.offlineFileList.empty()) {
+        std::ifstream list(config.offlineFileList);
+        if (!list) {
+            std::cerr << "[ERROR] Failed to open file list: " << config.offlineFileList << std::endl;
+            return false;
+        }
+        std::string line;
+        while (std::getline(list, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (!line.empty() && line[0] != '#') {
+                addInput(line);
+            }
+        }
+    }
+
+    return true;
+}
+
+size_t OfflineRunner::run(const std::vector<std::filesystem::path>& files) {
+    // Longest files first so the last worker to finish is not left with a big one
+    std::vector<std::pair<uintmax_t, std::filesystem::path>> queue;
+    queue.reserve(files.size());
+    for (const auto& file : files) {
+        std::error_code ec;
+        auto size = std::filesystem::file_size(file, ec);
+        queue.emplace_back(ec ? 0 : size, file);
+    }
+    std::stable_sort(queue.begin(), queue.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    embeddingBatcher_->start();
+
+    std::atomic<size_t> nextFile{0};
+    std::atomic<size_t> failedFiles{0};
+    std::atomic<size_t> totalSamples{0};
+    auto startTime = std::chrono::steady_clock::now();
+
+    size_t numWorkers = std::clamp<size_t>(config_.workerThreads, 1, std::max<size_t>(queue.size(), 1));
+    std::vector<std::thread> workers;
+    for (size_t w = 0; w < numWorkers; ++w) {
+        workers.emplace_back([&]() {
+            WorkerScratch scratch;
+            std::vector<Detection> detections;
+            while (!stopRequested_) {
+                size_t index = nextFile++;
+                if (index >= queue.size()) {
+                    break;
+                }
+                const auto& file = queue[index].second;
+
+                detections.clear();
+                size_t samples = 0;
+                if (!processFile(file, scratch, detections, samples)) {
+                    failedFiles++;
+                    continue;
+                }
+                totalSamples += samples;
+                printDetections(file, detections);
+            }
+        });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    embeddingBatcher_->stop();
+
+    if (config_.outputMode != OutputMode::QUIET) {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        double audioSeconds = static_cast<double>(totalSamples) / SAMPLE_RATE;
+        std::cerr << "[LOG] Processed " << (queue.size() - failedFiles) << " file(s), "
+                  << std::fixed << std::setprecision(1) << audioSeconds << " s of audio in "
+                  << elapsed << " s (" << (elapsed > 0 ? audioSeconds / elapsed : 0.0)
+                  << "x real time)" << std::endl;
+        if (failedFiles > 0) {
+            std::cerr << "[WARNING] " << failedFiles << " file(s) could not be processed" << std::endl;
+        }
+    }
+
+    return failedFiles;
+}
+
+bool OfflineRunner::processFile(const std::filesystem::path& file, WorkerScratch& scratch,
+                                std::vector<Detection>& detections, size_t& samplesProcessed) {
+    const size_t frameSize = detectionFrameSize();
+
+    // Rescoring: an up-to-date cache entry replaces the mel and embedding stages
+    EmbeddingCacheKey cacheKey;
+    EmbeddingCacheWriter cacheWriter;
+    bool writeCache = false;
+    if (!config_.embeddingCacheDir.empty() &&
+        EmbeddingCacheKey::make(file, frameSize, config_, cacheKey)) {
+        auto cachePath = embeddingCachePath(config_.embeddingCacheDir, file);
+        EmbeddingCacheReader cache;
+        if (cache.open(cachePath, cacheKey)) {
+            replayFile(cache, scratch, detections);
+            samplesProcessed = cache.sourceSamples();
+            return true;
+        }
+        writeCache = cacheWriter.open(cachePath, cacheKey);
+    }
+
+    MappedAudioReader reader(file.string(), config_.offlineRaw);
+    if (!reader.isOpen()) {
+        return false;
+    }
+    if (!AudioConverter::isSupportedRate(reader.getSampleRate()) ||
+        reader.getChannels() > AudioConverter::MAX_CHANNELS ||
+        config_.inputChannel >= static_cast<int>(reader.getChannels())) {
+        std::cerr << "[ERROR] " << file.string() << ": unsupported format, "
+                  << reader.getSampleRate() << " Hz with " << reader.getChannels()
+                  << " channel(s)" << std::endl;
+        return false;
+    }
+
+    const size_t blockSamples = OFFLINE_BLOCK_FRAMES * config_.frameSize;
+
+    // Files in other formats are converted block by block into scratch;
+    // 16 kHz mono files are read in place
+    std::unique_ptr<AudioConverter> converter;
+    size_t convertedBlock = 0;
+    if (reader.getSampleRate() != SAMPLE_RATE || reader.getChannels() != 1) {
+        size_t inputBlock = blockSamples * reader.getSampleRate() / SAMPLE_RATE * reader.getChannels();
+        converter = std::make_unique<AudioConverter>(reader.getSampleRate(), reader.getChannels(),
+                                                     config_.inputChannel, inputBlock);
+        scratch.converted.clear();
+        scratch.converted.reserve(2 * blockSamples);
+    }
+    auto nextBlock = [&]() -> std::span<const AudioSample> {
+        if (!converter) {
+            return reader.next(blockSamples);
+        }
+        auto& pending = scratch.converted;
+        pending.erase(pending.begin(), pending.begin() + convertedBlock);
+        while (pending.size() < blockSamples && reader.hasMore()) {
+            auto converted = converter->process(reader.next(converter->inputForOutput(blockSamples)));
+            pending.insert(pending.end(), converted.begin(), converted.end());
+        }
+        convertedBlock = std::min(pending.size(), blockSamples);
+        return {pending.data(), convertedBlock};
+    };
+    const size_t melStep = EMBEDDING_STEP_SIZE * NUM_MELS;
+
+    // Same framing as the streaming pipeline: one mel call per audio frame,
+    // embeddings every EMBEDDING_STEP_SIZE mel frames, one score per embedding
+    SlidingWindow<AudioFloat> mels(NUM_MELS, EMBEDDING_WINDOW_SIZE + blockSamples / MEL_HOP_SAMPLES);
+    SlidingWindow<AudioFloat> features(EMBEDDING_FEATURES,
+                                       WAKEWORD_FEATURES + blockSamples / (MEL_HOP_SAMPLES * EMBEDDING_STEP_SIZE) + 1);
+    std::vector<ActivationTracker> activations;
+    for (const auto& wwConfig : config_.wakeWordConfigs) {
+        activations.emplace_back(wwConfig);
+    }
+
+    scratch.audio.resize(blockSamples);
+    size_t framesPerRow = 0;
+    
+    // Streaming mels: each 80 ms group is computed with the STFT context of
+    // the audio before it, as MelStreamer does
+    constexpr size_t rowSize = MelStreamer::INPUT_SAMPLES;
+    std::vector<AudioFloat> melContext(MelStreamer::CONTEXT_SAMPLES, 0.0f);
+
+    while (!stopRequested_) {
+        // Samples are read in place from the mapping
+        auto block = nextBlock();
+        size_t count = block.size();
+        samplesProcessed += count;
+
+        // A trailing partial frame is dropped, as in the streaming pipeline;
+        // conversion goes straight into the preallocated mel input
+        size_t frames = count / frameSize;
+        kernels::convertInt16ToFloat(block.data(), scratch.audio.data(), frames * frameSize);
+
+        // Mel stage. The native frontend floors each row on its own, so the
+        // whole block is one call; the ONNX graph's dB floor spans the batch,
+        // so it runs one frame at a time to match streaming.
+        if (config_.streamingMel) {
+            scratch.melInput.resize(frames * rowSize);
+            for (size_t f = 0; f < frames; ++f) {
+                AudioFloat* row = scratch.melInput.data() + f * rowSize;
+                std::copy(melContext.begin(), melContext.end(), row);
+                std::copy_n(scratch.audio.data() + f * frameSize, frameSize,
+                            row + MelStreamer::CONTEXT_SAMPLES);
+                std::copy(row + frameSize, row + rowSize, melContext.begin());
+            }
+            size_t rowsPerCall = config_.melFrontend == MelFrontendType::NATIVE ? frames : 1;
+            for (size_t f = 0; f < frames; f += rowsPerCall) {
+                framesPerRow = melFrontend_->computeMelSpectrogramBatch(
+                    scratch.melInput.data() + f * rowSize, rowsPerCall, rowSize, scratch.melOutput);
+                mels.append(scratch.melOutput.data(), rowsPerCall * framesPerRow);
+            }
+        } else if (config_.melFrontend == MelFrontendType::NATIVE) {
+            if (frames > 0) {
+                framesPerRow = melFrontend_->computeMelSpectrogramBatch(
+                    scratch.audio.data(), frames, frameSize, scratch.melOutput);
+                mels.append(scratch.melOutput.data(), frames * framesPerRow);
+            }
+        } else {
+            for (size_t f = 0; f < frames; ++f) {
+                framesPerRow = melFrontend_->computeMelSpectrogramBatch(
+                    scratch.audio.data() + f * frameSize, 1, frameSize, scratch.melOutput);
+                mels.append(scratch.melOutput.data(), framesPerRow);
+            }
+        }
+
+        // Embedding stage: every complete window of the block in one submission
+        scratch.windows.clear();
+        while (mels.size() >= EMBEDDING_WINDOW_SIZE + scratch.windows.size() * EMBEDDING_STEP_SIZE) {
+            scratch.windows.push_back(mels.data() + scratch.windows.size() * melStep);
+        }
+        size_t numEmbeddings = scratch.windows.size();
+        scratch.embeddings.resize(numEmbeddings * EMBEDDING_FEATURES);
+        embeddingBatcher_->submit(scratch.windows.data(), numEmbeddings, scratch.embeddings.data());
+        mels.consume(numEmbeddings * EMBEDDING_STEP_SIZE);
+        features.append(scratch.embeddings.data(), numEmbeddings);
+        if (writeCache) {
+            cacheWriter.append(scratch.embeddings.data(), numEmbeddings);
+        }
+
+        // Wake word stage: every complete feature window, batched per model
+        size_t firstEmbedding = features.framesWritten() - features.size();
+        features.consume(scoreEmbeddings(features.data(), features.size(), firstEmbedding,
+                                         framesPerRow, activations, scratch, detections));
+
+        if (count < blockSamples) {
+            break;
+        }
+    }
+
+    // Entries of files cut short by a stop would be incomplete
+    if (writeCache && !stopRequested_ && !cacheWriter.commit(framesPerRow, samplesProcessed)) {
+        std::cerr << "[WARNING] Failed to write embedding cache for " << file.string() << std::endl;
+    }
+
+    std::stable_sort(detections.begin(), detections.end(),
+                     [](const Detection& a, const Detection& b) { return a.frameIndex < b.frameIndex; });
+    return true;
+}
+
+void OfflineRunner::replayFile(const EmbeddingCacheReader& cache, WorkerScratch& scratch,
+                               std::vector<Detection>& detections) {
+    std::vector<ActivationTracker> activations;
+    for (const auto& wwConfig : config_.wakeWordConfigs) {
+        activations.emplace_back(wwConfig);
+    }
+
+    // Embeddings are contiguous in the mapping, so windows point straight
+    // into it; blocks only bound the scratch buffers
+    const size_t blockWindows = OFFLINE_BLOCK_FRAMES * config_.frameSize /
+                                (MEL_HOP_SAMPLES * EMBEDDING_STEP_SIZE);
+    size_t first = 0;
+    while (!stopRequested_ && first + WAKEWORD_FEATURES <= cache.size()) {
+        size_t count = std::min(cache.size() - first, blockWindows + WAKEWORD_FEATURES - 1);
+        first += scoreEmbeddings(cache.embedding(first), count, first, cache.framesPerRow(),
+                                 activations, scratch, detections);
+    }
+
+    std::stable_sort(detections.begin(), detections.end(),
+                     [](const Detection& a, const Detection& b) { return a.frameIndex < b.frameIndex; });
+}
+
+size_t OfflineRunner::scoreEmbeddings(const AudioFloat* embeddings, size_t count, size_t firstEmbedding,
+                                      size_t framesPerRow, std::vector<ActivationTracker>& activations,
+                                      WorkerScratch& scratch, std::vector<Detection>& detections) {
+    scratch.windows.clear();
+    while (count >= WAKEWORD_FEATURES + scratch.windows.size()) {
+        scratch.windows.push_back(embeddings + scratch.windows.size() * EMBEDDING_FEATURES);
+    }
+    size_t numWindows = scratch.windows.size();
+    scratch.scores.resize(numWindows);
+
+    for (size_t m = 0; m < wakeWordModels_.size(); ++m) {
+        for (size_t offset = 0; offset < numWindows; offset += config_.maxBatchSize) {
+            size_t batch = std::min(config_.maxBatchSize, numWindows - offset);
+            wakeWordModels_[m]->predictBatch(scratch.windows.data() + offset, batch,
+                                             scratch.batchInput, scratch.scores.data() + offset);
+        }
+
+        for (size_t k = 0; k < numWindows; ++k) {
+            if (activations[m].update(scratch.scores[k])) {
+                // Audio frame that completes the window's last embedding
+                size_t lastEmbedding = firstEmbedding + k + WAKEWORD_FEATURES - 1;
+                size_t lastMel = lastEmbedding * EMBEDDING_STEP_SIZE + EMBEDDING_WINDOW_SIZE - 1;
+                detections.emplace_back(wakeWordNames_[m], scratch.scores[k], lastMel / framesPerRow);
+            }
+        }
+    }
+    return numWindows;
+}
+
+size_t OfflineRunner::detectionFrameSize() const {
+    return config_.streamingMel ? MelStreamer::GROUP_SAMPLES : config_.frameSize;
+}
+
+void OfflineRunner::printDetections(const std::filesystem::path& file,
+                                    const std::vector<Detection>& detections) {
+    std::unique_lock<std::mutex> lock(outputMutex_);
+
+    for (const auto& detection : detections) {
+        // Detections fire once the triggering frame has been fully received
+        size_t sample = (detection.frameIndex + 1) * detectionFrameSize();
+        double seconds = static_cast<double>(sample) / SAMPLE_RATE;
+
+        if (config_.outputMode == OutputMode::JSON) {
+            std::cout << "{\"file\":\"" << escapeJson(file.string()) << "\""
+                      << ",\"wake_word\":\"" << detection.modelName << "\""
+                      << ",\"score\":" << detection.score
+                      << ",\"sample\":" << sample
+                      << ",\"time\":" << std::fixed << std::setprecision(3) << seconds
+                      << std::defaultfloat << "}" << std::endl;
+        } else {
+            std::cout << file.string() << " " << std::fixed << std::setprecision(3) << seconds
+                      << std::defaultfloat << " " << detection.modelName << std::endl;
+        }
+    }
+
+    if (config_.outputMode == OutputMode::VERBOSE) {
+        std::cerr << "[LOG] " << file.string() << ": " << detections.size() << " detection(s)" << std::endl;
+    }
+}
+
+} // namespace openwakeword
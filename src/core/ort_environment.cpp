@@ -0,0 +1,160 @@
+#include "core/ort_environment.h"
+#include "core/model_loader.h"
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+#if __has_include(<nnapi_provider_factory.h>)
+#include <nnapi_provider_factory.h>
+#define OPENWAKEWORD_HAS_NNAPI 1
+#endif
+
+namespace openwakeword {
+
+namespace {
+
+Ort::Env createEnv(const Config& config, bool globalThreadPools) {
+    if (!globalThreadPools) {
+        return Ort::Env(OrtLoggingLevel::ORT_LOGGING_LEVEL_WARNING, "openWakeWord");
+    }
+
+    Ort::ThreadingOptions threading;
+    threading.SetGlobalIntraOpNumThreads(config.intraOpNumThreads);
+    threading.SetGlobalInterOpNumThreads(config.interOpNumThreads);
+    // Idle pool threads sleep instead of spinning; many sessions share them
+    threading.SetGlobalSpinControl(0);
+    return Ort::Env(threading, OrtLoggingLevel::ORT_LOGGING_LEVEL_WARNING, "openWakeWord");
+}
+
+GraphOptimizationLevel toOrtLevel(GraphOptimization level) {
+    switch (level) {
+        case GraphOptimization::DISABLED: return ORT_DISABLE_ALL;
+        case GraphOptimization::BASIC: return ORT_ENABLE_BASIC;
+        case GraphOptimization::EXTENDED: return ORT_ENABLE_EXTENDED;
+        case GraphOptimization::ALL: break;
+    }
+    return ORT_ENABLE_ALL;
+}
+
+// ONNX Runtime's name for a provider from Config, e.g. "cuda:1"
+std::string ortProviderName(const std::string& provider) {
+    std::string name = provider.substr(0, provider.find(':'));
+    if (name == "cuda") return "CUDAExecutionProvider";
+    if (name == "xnnpack") return "XnnpackExecutionProvider";
+    if (name == "coreml") return "CoreMLExecutionProvider";
+    if (name == "nnapi") return "NnapiExecutionProvider";
+    return "CPUExecutionProvider";
+}
+
+// Returns false for providers this build cannot add
+bool appendProvider(Ort::SessionOptions& options, const std::string& provider, const Config& config) {
+    std::string name = provider.substr(0, provider.find(':'));
+    if (name == "cuda") {
+        OrtCUDAProviderOptions cuda{};
+        if (name.size() != provider.size()) {
+            // In range: parseProviderList checked it
+            cuda.device_id = std::stoi(provider.substr(name.size() + 1));
+        }
+        options.AppendExecutionProvider_CUDA(cuda);
+    } else if (name == "xnnpack") {
+        // XNNPACK runs its own pool; ORT's nodes stay on the intra-op threads
+        int threads = std::max(config.intraOpNumThreads, 1);
+        options.AppendExecutionProvider("XNNPACK", {{"intra_op_num_threads", std::to_string(threads)}});
+    } else if (name == "coreml") {
+        options.AppendExecutionProvider("CoreML");
+    } else if (name == "nnapi") {
+#ifdef OPENWAKEWORD_HAS_NNAPI
+        Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_Nnapi(options, 0));
+#else
+        return false;  // Needs nnapi_provider_factory.h at build time
+#endif
+    }
+    return true;
+}
+
+} // namespace
+
+OrtEnvironment::OrtEnvironment(const Config& config, bool globalThreadPools)
+    : globalThreadPools_(globalThreadPools), env_(createEnv(config, globalThreadPools)) {
+    env_.DisableTelemetryEvents();
+}
+
+std::shared_ptr<OrtEnvironment> OrtEnvironment::acquire(const Config& config) {
+    static std::mutex mutex;
+    static std::weak_ptr<OrtEnvironment> shared;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    OptimizedModelCache::configure(config.modelCacheDir, config.graphOptimization);
+    ModelRegistry::configure(config.shareModels);
+    auto environment = shared.lock();
+    if (!environment) {
+        environment = std::make_shared<OrtEnvironment>(config, config.globalThreadPool);
+        shared = environment;
+    } else if (config.globalThreadPool != environment->globalThreadPools_ &&
+               config.outputMode != OutputMode::QUIET) {
+        std::cerr << "[WARNING] ONNX Runtime environment already created "
+                  << (environment->globalThreadPools_ ? "with" : "without")
+                  << " global thread pools; keeping that setting" << std::endl;
+    }
+    return environment;
+}
+
+Ort::SessionOptions OrtEnvironment::createSessionOptions(const Config& config) const {
+    Ort::SessionOptions options;
+    if (globalThreadPools_) {
+        options.DisablePerSessionThreads();
+    } else {
+        options.SetIntraOpNumThreads(config.intraOpNumThreads);
+        options.SetInterOpNumThreads(config.interOpNumThreads);
+    }
+    options.SetGraphOptimizationLevel(toOrtLevel(config.graphOptimization));
+    options.SetExecutionMode(config.parallelExecution ? ORT_PARALLEL : ORT_SEQUENTIAL);
+    return options;
+}
+
+ModelSessionOptions OrtEnvironment::createSessionOptions(const Config& config,
+                                                         const std::vector<std::string>& providers,
+                                                         const std::string& model) const {
+    ModelSessionOptions result{createSessionOptions(config)};
+    if (providers.empty()) {
+        return result;
+    }
+    
+    static const std::vector<std::string> available = Ort::GetAvailableProviders();
+    bool warn = config.outputMode != OutputMode::QUIET;
+    for (const auto& provider : providers) {
+        if (provider == "cpu") {
+            // Everything after the CPU would never be used
+            break;
+        }
+        if (std::find(available.begin(), available.end(), ortProviderName(provider)) == available.end()) {
+            if (warn) {
+                std::cerr << "[WARNING] " << model << ": execution provider " << provider
+                          << " is not available in this ONNX Runtime build" << std::endl;
+            }
+            continue;
+        }
+        try {
+            if (!appendProvider(result.options, provider, config)) {
+                if (warn) {
+                    std::cerr << "[WARNING] " << model << ": execution provider " << provider
+                              << " is not supported by this build" << std::endl;
+                }
+                continue;
+            }
+            result.hardware = true;
+            if (config.outputMode == OutputMode::VERBOSE) {
+                std::cerr << "[LOG] " << model << ": using execution provider " << provider << std::endl;
+            }
+        } catch (const Ort::Exception& e) {
+            if (warn) {
+                std::cerr << "[WARNING] " << model << ": execution provider " << provider
+                          << " unavailable: " << e.what() << std::endl;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace openwakeword
@@ -1,16 +1,34 @@
 #include "core/pipeline.h"
+#include "core/model_loader.h"
+#include "postprocessors/custom_verifier.h"
+#include "preprocessors/speex_noise_suppressor.h"
+#include "preprocessors/vad.h"
+#include "utils/kernels.h"
+#include "utils/thread_affinity.h"
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 
 namespace openwakeword {
 
 Pipeline::Pipeline(const Config& config) 
     : config_(config),
-      env_(OrtLoggingLevel::ORT_LOGGING_LEVEL_WARNING, "openWakeWord") {
-    env_.DisableTelemetryEvents();
+      ortEnvironment_(OrtEnvironment::acquire(config_)),
+      env_(ortEnvironment_->env()),
+      sessionOptions_(ortEnvironment_->createSessionOptions(config_)),
+      melOptions_(ortEnvironment_->createSessionOptions(config_, config_.melProviders, "mel")),
+      embeddingOptions_(ortEnvironment_->createSessionOptions(config_, config_.embeddingProviders,
+                                                              "embedding")) {
+    for (const auto& wwConfig : config_.wakeWordConfigs) {
+        detectorOptions_.push_back(ortEnvironment_->createSessionOptions(
+            config_, wwConfig.providers, wwConfig.name));
+    }
     
-    // Configure session options
-    sessionOptions_.SetIntraOpNumThreads(config_.intraOpNumThreads);
-    sessionOptions_.SetInterOpNumThreads(config_.interOpNumThreads);
+    if (config_.convertsInput()) {
+        inputConverter_ = std::make_unique<AudioConverter>(
+            config_.inputSampleRate, config_.inputChannels, config_.inputChannel,
+            config_.inputSamplesFor(config_.frameSize));
+    }
     
     // Calculate expected ready count
     expectedReadyCount_ = 2 + config_.wakeWordConfigs.size(); // mel + embedding + wake words
@@ -21,51 +39,276 @@ Pipeline::~Pipeline() {
 }
 
 bool Pipeline::initialize() {
-    // Create buffers
-    audioBuffer_ = std::make_shared<ThreadSafeBuffer<AudioFloat>>();
-    melBuffer_ = std::make_shared<ThreadSafeBuffer<AudioFloat>>();
-    
-    // Create feature buffers for each wake word detector
-    for (size_t i = 0; i < config_.wakeWordConfigs.size(); ++i) {
-        featureBuffers_.push_back(std::make_shared<ThreadSafeBuffer<AudioFloat>>());
+    if (config_.micArray) {
+        std::cerr << "[WARNING] Mic array mode needs the multi-stream engine; "
+                  << "the pipeline averages the channels" << std::endl;
     }
     
-    // Initialize mel spectrogram processor
-    melProcessor_ = std::make_unique<MelSpectrogramProcessor>(env_, sessionOptions_);
+    // Create fixed-capacity buffers sized to hold bufferMilliseconds of audio
+    // at each stage's rate (16 kHz samples, 10 ms mel frames, 80 ms embeddings)
+    const size_t bufferMs = config_.bufferMilliseconds;
+    const WaitPolicy waitPolicy = config_.bufferWaitPolicy;
+    audioBuffer_ = std::make_shared<SpscRingBuffer<AudioFloat>>(
+        std::max(SAMPLE_RATE * bufferMs / 1000, 2 * config_.frameSize), waitPolicy);
+    melBuffer_ = std::make_shared<SpscRingBuffer<AudioFloat>>(
+        (bufferMs / 10) * NUM_MELS, waitPolicy);
+    
+    // One shared embedding ring; readers are registered once detectors exist
+    featureBuffer_ = std::make_shared<BroadcastRingBuffer<AudioFloat>>(
+        EMBEDDING_FEATURES, std::max(bufferMs / 80, 2 * WAKEWORD_FEATURES), waitPolicy);
+    
+    // Construct every model-backed component first; session creation
+    // dominates startup and runs in parallel below
+    melProcessor_ = std::make_unique<MelSpectrogramProcessor>(env_, melOptions_.options);
+    melProcessor_->setFallbackOptions(melOptions_.hardware ? &sessionOptions_ : nullptr);
     melProcessor_->setModelPath(config_.melModelPath);
     melProcessor_->setFrameSize(config_.frameSize);
-    if (!melProcessor_->initialize()) {
+    melProcessor_->setStreaming(config_.streamingMel);
+    
+    embeddingProcessor_ = std::make_unique<SpeechEmbeddingProcessor>(
+        env_, embeddingOptions_.options, config_.wakeWordConfigs.size());
+    embeddingProcessor_->setModelPath(config_.embModelPath);
+    embeddingProcessor_->setFallbackOptions(embeddingOptions_.hardware ? &sessionOptions_ : nullptr);
+    
+    std::unique_ptr<VADPreprocessor> vad;
+    if (config_.enableVAD) {
+        vad = std::make_unique<VADPreprocessor>(config_.vadThreshold);
+    }
+    
+    // Wake words with a custom verifier trigger at the candidate threshold;
+    // the verifier applies their own, and the collector their refractory
+    // period once a candidate is accepted
+    std::vector<WakeWordConfig> detectorConfigs = config_.wakeWordConfigs;
+    std::vector<std::unique_ptr<CustomVerifier>> verifiers;
+    for (auto& wwConfig : detectorConfigs) {
+        if (!wwConfig.verifierModelPath.empty()) {
+            verifiers.push_back(std::make_unique<CustomVerifier>(wwConfig.name,
+                                                                 wwConfig.threshold));
+            wwConfig.threshold = config_.customVerifierThreshold;
+            wwConfig.deferRefractory = true;
+        }
+    }
+    
+    std::vector<std::unique_ptr<WakeWordDetector>> loaded;
+    for (size_t w = 0; w < detectorConfigs.size(); ++w) {
+        const auto& wwConfig = detectorConfigs[w];
+        loaded.push_back(std::make_unique<WakeWordDetector>(
+            wwConfig.name, wwConfig, env_, detectorOptions_[w].options));
+        loaded.back()->setFallbackOptions(detectorOptions_[w].hardware ? &sessionOptions_ : nullptr);
+    }
+    
+    std::unique_ptr<CascadeStage> cascade;
+    if (config_.cascade) {
+        cascade = std::make_unique<CascadeStage>(config_.cascadeThreshold);
+    }
+    
+    std::vector<std::function<bool()>> loads;
+    loads.push_back([this]() {
+        if (config_.melFrontend == MelFrontendType::NATIVE) {
+            auto frontend = createMelFrontend(config_, env_, sessionOptions_);
+            if (!frontend) {
+                return false;
+            }
+            melProcessor_->setFrontend(std::move(frontend));
+        }
+        return melProcessor_->initialize();
+    });
+    loads.push_back([this]() { return embeddingProcessor_->initialize(); });
+    if (vad) {
+        loads.push_back([this, &vad]() {
+            return vad->initialize(config_.vadModelPath, env_, sessionOptions_);
+        });
+    }
+    if (cascade) {
+        loads.push_back([this, &cascade]() {
+            return cascade->initialize(config_.cascadeModelPath, env_, sessionOptions_);
+        });
+    }
+    for (auto& detector : loaded) {
+        loads.push_back([&detector]() { return detector->initialize(); });
+    }
+    for (size_t v = 0, w = 0; w < detectorConfigs.size(); ++w) {
+        if (!detectorConfigs[w].verifierModelPath.empty()) {
+            auto* verifier = verifiers[v++].get();
+            loads.push_back([this, verifier, &path = detectorConfigs[w].verifierModelPath]() {
+                return verifier->initialize(path, env_, sessionOptions_);
+            });
+        }
+    }
+    if (!runLoadTasks(loads, config_.loadThreads)) {
         return false;
     }
+    
     if (config_.outputMode == OutputMode::VERBOSE || config_.outputMode == OutputMode::NORMAL) {
-        std::cerr << "[LOG] Loaded mel spectrogram model" << std::endl;
+        std::cerr << (config_.melFrontend == MelFrontendType::NATIVE
+                          ? "[LOG] Using native mel spectrogram frontend"
+                          : "[LOG] Loaded mel spectrogram model") << std::endl;
     }
     
-    // Initialize speech embedding processor
-    embeddingProcessor_ = std::make_unique<SpeechEmbeddingProcessor>(
-        env_, sessionOptions_, config_.wakeWordConfigs.size());
-    embeddingProcessor_->setModelPath(config_.embModelPath);
-    if (!embeddingProcessor_->initialize()) {
-        return false;
+    // Audio samples per mel frame, which exceed the hop when each step's
+    // frames are computed without context
+    double samplesPerMel = MEL_HOP_SAMPLES;
+    if (!config_.streamingMel) {
+        size_t framesPerStep = (config_.frameSize - MEL_WINDOW_SAMPLES) / MEL_HOP_SAMPLES + 1;
+        samplesPerMel = static_cast<double>(config_.frameSize) / framesPerStep;
     }
+    embeddingProcessor_->setSamplesPerMel(samplesPerMel);
     if (config_.outputMode == OutputMode::VERBOSE || config_.outputMode == OutputMode::NORMAL) {
         std::cerr << "[LOG] Loaded speech embedding model" << std::endl;
     }
     
-    // Initialize wake word detectors
-    for (const auto& wwConfig : config_.wakeWordConfigs) {
-        auto wakeWord = wwConfig.modelPath.stem().string();
-        auto detector = std::make_unique<WakeWordDetector>(
-            wakeWord, wwConfig, env_, sessionOptions_);
-        if (!detector->initialize()) {
-            return false;
+    // Noise suppression first, so the VAD scores the denoised audio
+    if (config_.enableNoiseSuppression) {
+        if (SpeexNoiseSupressor::isAvailable()) {
+            // 20 ms frames
+            addPreprocessor(std::make_unique<SpeexNoiseSupressor>(SAMPLE_RATE, SAMPLE_RATE / 50));
+        } else if (config_.outputMode != OutputMode::QUIET) {
+            std::cerr << "[WARNING] Noise suppression requested but Speex support is not compiled in"
+                      << std::endl;
+        }
+    }
+    
+    // Voice activity detection on the input thread, optionally gating the
+    // embedding stage
+    if (vad) {
+        if (config_.vadGate) {
+            auto gate = std::make_shared<VoiceActivityGate>(
+                static_cast<uint64_t>(config_.vadHangoverMs) * SAMPLE_RATE / 1000);
+            vad->setGate(gate);
+            embeddingProcessor_->setGate(gate);
+        }
+        
+        if (config_.outputMode == OutputMode::VERBOSE || config_.outputMode == OutputMode::NORMAL) {
+            std::cerr << "[LOG] Loaded VAD model"
+                      << (config_.vadGate ? " (gating embedding inference)" : "") << std::endl;
+        }
+        addPreprocessor(std::move(vad));
+    }
+    
+    // Real-time mode: steps are timed against the deadline, and falling a
+    // deadline's worth of windows behind triggers the overload policy
+    size_t overloadWindows = 0;
+    if (config_.realTime) {
+        metrics_.setDeadline(std::chrono::milliseconds(config_.deadlineMs));
+        overloadWindows = std::max<size_t>(config_.deadlineMs / 80, 1);
+        if (config_.overloadPolicy == OverloadPolicy::DROP_AUDIO) {
+            embeddingProcessor_->setOverloadLimit(config_.deadlineMs / 10, &metrics_);
         }
+        if (config_.outputMode == OutputMode::VERBOSE) {
+            std::cerr << "[LOG] Real-time mode: " << config_.deadlineMs << " ms step deadline" << std::endl;
+        }
+    }
+    auto overloadLimit = [&](size_t w) -> size_t {
+        bool shed = config_.overloadPolicy == OverloadPolicy::SKIP_STEPS ||
+                    (config_.overloadPolicy == OverloadPolicy::REDUCE_MODELS && w >= config_.overloadModels);
+        return config_.realTime && shed ? overloadWindows : 0;
+    };
+    
+    // Wake word detectors, in configuration order
+    for (size_t w = 0; w < loaded.size(); ++w) {
+        auto& detector = loaded[w];
+        const auto& wwConfig = detectorConfigs[w];
         if (config_.outputMode == OutputMode::VERBOSE || config_.outputMode == OutputMode::NORMAL) {
-            std::cerr << "[LOG] Loaded wake word model: " << wakeWord << std::endl;
+            std::cerr << "[LOG] Loaded wake word model: " << detector->getName() << std::endl;
+        }
+        detector->setOverloadLimit(overloadLimit(w));
+        
+        // In group mode a merged multi-output model yields one detector per output
+        auto model = detector->getModel();
+        if (config_.groupDetectors && model->getNumScores() > 1) {
+            // A verifier is trained for one wake word, not every output
+            if (wwConfig.deferRefractory) {
+                std::cerr << "[ERROR] Custom verifier needs a single-output model, but "
+                          << wwConfig.name << " has " << model->getNumScores() << " outputs" << std::endl;
+                return false;
+            }
+            for (size_t i = 0; i < model->getNumScores(); ++i) {
+                auto outputDetector = std::make_unique<WakeWordDetector>(
+                    model->getScoreName(i), wwConfig, model, i, env_, sessionOptions_);
+                outputDetector->initialize();
+                outputDetector->setOverloadLimit(overloadLimit(w));
+                detectors_.push_back(std::move(outputDetector));
+            }
+            continue;
         }
         detectors_.push_back(std::move(detector));
     }
     
+    // Verifiers run first, ahead of any added postprocessors
+    for (auto& verifier : verifiers) {
+        if (config_.outputMode == OutputMode::VERBOSE || config_.outputMode == OutputMode::NORMAL) {
+            std::cerr << "[LOG] Loaded " << verifier->getName() << std::endl;
+        }
+    }
+    postprocessors_.insert(postprocessors_.begin(), std::make_move_iterator(verifiers.begin()),
+                           std::make_move_iterator(verifiers.end()));
+    
+    // Detection output leaves the detector threads through one collector,
+    // which also applies the postprocessors
+    collector_ = std::make_unique<DetectionCollector>(outputMutex_, config_.outputMode,
+                                                      config_.showTimestamp);
+    collector_->setPostprocessors(&postprocessors_);
+    collector_->setCallback(detectionCallback_);
+    collector_->setMetrics(&metrics_);
+    for (auto& detector : detectors_) {
+        const auto& wwConfig = detector->getConfig();
+        uint32_t id = collector_->addDetector(
+            detector->getName(), wwConfig.deferRefractory ? wwConfig.refractorySteps : 0);
+        detector->setCollector(collector_.get(), id);
+    }
+    
+    // Register embedding ring readers: one for the whole group or one per detector
+    if (config_.groupDetectors) {
+        detectorGroup_ = std::make_unique<DetectorGroup>();
+        for (auto& detector : detectors_) {
+            detectorGroup_->addDetector(detector.get());
+        }
+        featureReaders_.push_back(featureBuffer_->addReader());
+        expectedReadyCount_ = 3;  // mel + embedding + detector group
+        
+        if (config_.outputMode == OutputMode::VERBOSE) {
+            std::cerr << "[LOG] Detector group: " << detectors_.size() << " wake words, "
+                      << detectorGroup_->numModels() << " inference calls per step" << std::endl;
+        }
+        
+        if (cascade) {
+            if (config_.outputMode == OutputMode::VERBOSE || config_.outputMode == OutputMode::NORMAL) {
+                std::cerr << "[LOG] Cascade first stage: "
+                          << (cascade->hasModel() ? config_.cascadeModelPath.stem().string()
+                                                  : std::string("embedding distance"))
+                          << std::endl;
+            }
+            detectorGroup_->setCascade(std::move(cascade), config_.cascadeMargin,
+                                       config_.cascadeHoldSteps);
+        }
+    } else {
+        for (size_t i = 0; i < detectors_.size(); ++i) {
+            featureReaders_.push_back(featureBuffer_->addReader());
+        }
+        expectedReadyCount_ = 2 + detectors_.size();
+    }
+    
+    // Instrumentation: inference time per stage and model, queue depths
+    melProcessor_->setMetrics(metrics_.addStage("mel"));
+    embeddingProcessor_->setMetrics(metrics_.addStage("embedding"), &metrics_.clock());
+    if (detectorGroup_) {
+        detectorGroup_->setMetrics(metrics_);
+    } else {
+        for (auto& detector : detectors_) {
+            detector->setMetrics(&metrics_, metrics_.addStage("wake_word", detector->getName()));
+        }
+        metrics_.setStepReporters(detectors_.size());
+    }
+    metrics_.addGauge("audio_samples", [this]() { return static_cast<double>(audioBuffer_->size()); });
+    metrics_.addGauge("mel_frames", [this]() { return static_cast<double>(melBuffer_->size() / NUM_MELS); });
+    metrics_.addGauge("embeddings", [this]() { return static_cast<double>(featureBuffer_->size()); });
+    
+    if (config_.metricsPort != 0 || config_.statsIntervalSeconds != 0) {
+        metricsExporter_ = std::make_unique<MetricsExporter>(
+            metrics_, config_.metricsHost, static_cast<uint16_t>(config_.metricsPort),
+            std::chrono::seconds(config_.statsIntervalSeconds), outputMutex_);
+    }
+    
     return true;
 }
 
@@ -77,23 +320,53 @@ void Pipeline::start() {
     running_ = true;
     readyCount_ = 0;
     
+    if (metricsExporter_ && !metricsExporter_->start()) {
+        metricsExporter_.reset();
+    } else if (metricsExporter_ && config_.metricsPort != 0 &&
+               config_.outputMode != OutputMode::QUIET) {
+        std::cerr << "[LOG] Serving metrics on port " << config_.metricsPort << std::endl;
+    }
+    
+    collector_->start();
+    
     // Start mel spectrogram thread
     melThread_ = std::thread([this]() {
+        pinThread("mel", config_.melCpus);
+        prioritizeThread("mel");
         incrementReady();
         melProcessor_->run(audioBuffer_, melBuffer_, config_.outputMode);
     });
     
     // Start embedding thread
     embeddingThread_ = std::thread([this]() {
+        pinThread("embedding", config_.embeddingCpus);
+        prioritizeThread("embedding");
         incrementReady();
-        embeddingProcessor_->run(melBuffer_, featureBuffers_, config_.outputMode);
+        embeddingProcessor_->run(melBuffer_, featureBuffer_, config_.outputMode);
     });
     
-    // Start wake word detector threads
+    // Start a single detector group thread, or one thread per detector
+    if (detectorGroup_) {
+        detectorGroupThread_ = std::thread([this]() {
+            pinThread("detector group", config_.detectorCpus);
+            prioritizeThread("detector group");
+            incrementReady();
+            detectorGroup_->run(featureBuffer_, featureReaders_[0], outputMutex_,
+                                config_.outputMode, config_.showTimestamp);
+        });
+        return;
+    }
+    
     for (size_t i = 0; i < detectors_.size(); ++i) {
         detectorThreads_.emplace_back([this, i]() {
+            // One CPU per detector, round robin over the list
+            if (!config_.detectorCpus.empty()) {
+                pinThread(detectors_[i]->getName(),
+                          {config_.detectorCpus[i % config_.detectorCpus.size()]});
+            }
+            prioritizeThread(detectors_[i]->getName());
             incrementReady();
-            detectors_[i]->run(featureBuffers_[i], outputMutex_, 
+            detectors_[i]->run(featureBuffer_, featureReaders_[i], outputMutex_,
                               config_.outputMode, config_.showTimestamp);
         });
     }
@@ -120,9 +393,7 @@ void Pipeline::stop() {
         embeddingThread_.join();
     }
     
-    for (auto& buffer : featureBuffers_) {
-        buffer->setExhausted(true);
-    }
+    featureBuffer_->setExhausted(true);
     
     for (auto& thread : detectorThreads_) {
         if (thread.joinable()) {
@@ -130,45 +401,66 @@ void Pipeline::stop() {
         }
     }
     
+    if (detectorGroupThread_.joinable()) {
+        detectorGroupThread_.join();
+    }
+    
     detectorThreads_.clear();
+    
+    // Output every detection the detectors posted
+    collector_->stop();
+    
+    if (config_.realTime && config_.outputMode == OutputMode::VERBOSE) {
+        std::cerr << "[LOG] Real-time: " << metrics_.deadlineMisses() << " of "
+                  << metrics_.stepLatency().count << " steps missed the deadline, "
+                  << metrics_.overloadSkips() << " windows skipped" << std::endl;
+    }
+    
+    if (metricsExporter_) {
+        metricsExporter_->stop();
+    }
 }
 
-void Pipeline::processAudio(const AudioSample* samples, size_t sampleCount) {
+void Pipeline::processAudio(std::span<const AudioSample> samples) {
     if (!running_) {
         return;
     }
     
-    // Convert int16_t samples to float
-    std::vector<AudioFloat> floatSamples;
-    floatSamples.reserve(sampleCount);
+    // Everything after this point sees 16 kHz mono
+    if (inputConverter_) {
+        samples = inputConverter_->process(samples);
+    }
     
-    for (size_t i = 0; i < sampleCount; ++i) {
-        // Apply preprocessors here (noise suppression, etc.)
-        AudioSample processedSample = samples[i];
-        
-        // TODO: Apply preprocessors
-        // for (auto& preprocessor : preprocessors_) {
-        //     if (preprocessor->isEnabled()) {
-        //         preprocessor->process(processedSample);
-        //     }
-        // }
-        
-        // Convert to float (no normalization)
-        floatSamples.push_back(static_cast<AudioFloat>(processedSample));
+    metrics_.addAudio(samples.size());
+    
+    // Preprocessors run fused into the input thread, reframed to their
+    // native frame sizes
+    if (!preprocessors_.empty()) {
+        samples = preprocessors_.process(samples);
     }
     
-    // Push to audio buffer
-    audioBuffer_->push(floatSamples);
+    // Convert to float (no normalization) directly into the audio ring;
+    // waits if the mel stage has fallen behind
+    audioBuffer_->pushConverted(samples.data(), samples.size(), kernels::convertInt16ToFloat);
+    samplesPushed_ += samples.size();
+    metrics_.clock().markAudio(samplesPushed_);
 }
 
 void Pipeline::addPreprocessor(std::unique_ptr<Preprocessor> preprocessor) {
-    preprocessors_.push_back(std::move(preprocessor));
+    preprocessors_.add(std::move(preprocessor));
 }
 
 void Pipeline::addPostprocessor(std::unique_ptr<Postprocessor> postprocessor) {
     postprocessors_.push_back(std::move(postprocessor));
 }
 
+void Pipeline::setDetectionCallback(DetectionCallback callback) {
+    detectionCallback_ = std::move(callback);
+    if (collector_) {
+        collector_->setCallback(detectionCallback_);
+    }
+}
+
 void Pipeline::waitUntilReady() {
     std::unique_lock<std::mutex> lock(readyMutex_);
     readyCv_.wait(lock, [this]() { 
@@ -186,4 +478,41 @@ void Pipeline::incrementReady() {
     readyCv_.notify_one();
 }
 
+void Pipeline::pinThread(const std::string& stage, const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return;
+    }
+    bool pinned = pinCurrentThread(cpus);
+    if (config_.outputMode == OutputMode::QUIET) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(outputMutex_);
+    if (pinned) {
+        if (config_.outputMode == OutputMode::VERBOSE) {
+            std::cerr << "[LOG] Pinned " << stage << " thread to CPUs " << formatCpuList(cpus) << std::endl;
+        }
+    } else {
+        std::cerr << "[WARNING] Failed to pin " << stage << " thread to CPUs " << formatCpuList(cpus) << std::endl;
+    }
+}
+
+void Pipeline::prioritizeThread(const std::string& stage) {
+    if (config_.realtimePriority == 0) {
+        return;
+    }
+    bool raised = setRealtimePriority(config_.realtimePriority);
+    if (config_.outputMode == OutputMode::QUIET) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(outputMutex_);
+    if (raised) {
+        if (config_.outputMode == OutputMode::VERBOSE) {
+            std::cerr << "[LOG] Running " << stage << " thread at real-time priority "
+                      << config_.realtimePriority << std::endl;
+        }
+    } else {
+        std::cerr << "[WARNING] Failed to set real-time priority of " << stage << " thread" << std::endl;
+    }
+}
+
 } // namespace openwakeword
\ No newline at end of file
@@ -2,13 +2,20 @@
 #include <iostream>
 #include <vector>
 #include <csignal>
+#include <thread>
+#include "core/engine.h"
+#include "core/network_ingest.h"
+#include "core/offline_runner.h"
 #include "core/pipeline.h"
 #include "utils/config.h"
 
 using namespace openwakeword;
 
-// Global pipeline for signal handling
+// Global pipeline/engine for signal handling
 std::unique_ptr<Pipeline> g_pipeline;
+std::unique_ptr<Engine> g_engine;
+std::unique_ptr<NetworkIngest> g_ingest;
+std::unique_ptr<OfflineRunner> g_offline;
 
 void signalHandler(int signal) {
     if (signal == SIGINT || signal == SIGTERM) {
@@ -16,10 +23,115 @@ void signalHandler(int signal) {
         if (g_pipeline) {
             g_pipeline->stop();
         }
+        if (g_ingest) {
+            g_ingest->stop();
+        }
+        if (g_engine) {
+            g_engine->stop();
+        }
+        if (g_offline) {
+            g_offline->stop();
+        }
         exit(0);
     }
 }
 
+// Serve every --stream input and network listener from one shared engine
+int runStreams(const Config& config) {
+    g_engine = std::make_unique<Engine>(config);
+    if (!g_engine->initialize()) {
+        std::cerr << "[ERROR] Failed to initialize engine" << std::endl;
+        return 1;
+    }
+    
+    bool network = !config.listenUnixPath.empty() || !config.listenUdp.empty();
+    if (network) {
+        g_ingest = std::make_unique<NetworkIngest>(*g_engine, config);
+        if (!g_ingest->open()) {
+            std::cerr << "[ERROR] Failed to open network inputs" << std::endl;
+            return 1;
+        }
+    }
+    g_engine->start();
+    
+    if (config.outputMode != OutputMode::QUIET) {
+        std::cerr << "[LOG] Ready (" << config.streamInputs.size() << " streams"
+                  << (network ? " plus network inputs" : "") << ")" << std::endl;
+    }
+    
+    // One lightweight reader per input; all inference happens in the engine
+    std::vector<std::thread> readers;
+    for (const auto& input : config.streamInputs) {
+        auto stream = g_engine->openStream(input);
+        readers.emplace_back([&config, stream, input]() {
+            FILE* file = (input == "-") ? stdin : std::fopen(input.c_str(), "rb");
+            if (file == nullptr) {
+                std::cerr << "[ERROR] Failed to open stream input: " << input << std::endl;
+                g_engine->closeStream(*stream);
+                return;
+            }
+            
+            std::vector<AudioSample> samples(config.inputSamplesFor(config.frameSize));
+            size_t samplesRead;
+            while ((samplesRead = std::fread(samples.data(), sizeof(AudioSample),
+                                             samples.size(), file)) > 0 &&
+                   g_engine->isRunning()) {
+                g_engine->pushAudio(*stream, samples.data(), samplesRead);
+            }
+            
+            if (file != stdin) {
+                std::fclose(file);
+            }
+            g_engine->closeStream(*stream);
+        });
+    }
+    
+    // Network streams come and go until shutdown
+    if (g_ingest) {
+        g_ingest->run();
+        if (config.outputMode == OutputMode::VERBOSE) {
+            std::cerr << "[LOG] Network input: " << g_ingest->getDroppedSamples()
+                      << " samples dropped, " << g_ingest->getConcealedSamples()
+                      << " samples of lost packets concealed, "
+                      << g_ingest->getRefusedSources() << " refused at the stream limit" << std::endl;
+        }
+    }
+    
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    g_engine->waitForStreams();
+    g_engine->stop();
+    
+    return 0;
+}
+
+// Score WAV files as fast as possible
+int runOffline(const Config& config) {
+    std::vector<std::filesystem::path> files;
+    if (!OfflineRunner::collectInputs(config, files)) {
+        return 1;
+    }
+    if (files.empty()) {
+        std::cerr << "[ERROR] No WAV files to process" << std::endl;
+        return 1;
+    }
+    
+    g_offline = std::make_unique<OfflineRunner>(config);
+    if (!g_offline->initialize()) {
+        std::cerr << "[ERROR] Failed to initialize offline runner" << std::endl;
+        return 1;
+    }
+    
+    if (config.outputMode != OutputMode::QUIET) {
+        std::cerr << "[LOG] Processing " << files.size() << " file(s) with "
+                  << config.workerThreads << " worker(s)" << std::endl;
+    }
+    
+    size_t failed = g_offline->run(files);
+    return failed == 0 ? 0 : 1;
+}
+
 int main(int argc, char *argv[]) {
     // Install signal handlers
     std::signal(SIGINT, signalHandler);
@@ -37,6 +149,23 @@ int main(int argc, char *argv[]) {
         return 0;
     }
     
+    // Offline batch mode
+    if (!config.offlineInputs.empty() || !config.offlineFileList.empty()) {
+        return runOffline(config);
+    }
+    
+    // Multi-stream server mode
+    if (!config.streamInputs.empty() || !config.listenUnixPath.empty() || !config.listenUdp.empty()) {
+        return runStreams(config);
+    }
+    
+    // A mic array on stdin is served by the engine, which batches its channels
+    if (config.micArray) {
+        Config arrayConfig = config;
+        arrayConfig.streamInputs.push_back("-");
+        return runStreams(arrayConfig);
+    }
+    
     // Create and initialize pipeline
     g_pipeline = std::make_unique<Pipeline>(config);
     
@@ -55,10 +184,12 @@ int main(int argc, char *argv[]) {
         std::cerr << "[LOG] Ready" << std::endl;
     }
     
-    // Main audio input loop
-    std::vector<AudioSample> samples(config.frameSize);
+    // Main audio input loop; streaming mels are produced per 80 ms chunk, so
+    // there is no need to wait for a whole step
+    size_t readSize = config.inputSamplesFor(config.streamingMel ? CHUNK_SAMPLES : config.frameSize);
+    std::vector<AudioSample> samples(readSize);
     size_t framesRead = std::fread(samples.data(), sizeof(AudioSample), 
-                                   config.frameSize, stdin);
+                                   readSize, stdin);
     
     while (framesRead > 0 && g_pipeline->isRunning()) {
         // Process audio through pipeline
@@ -66,7 +197,7 @@ int main(int argc, char *argv[]) {
         
         // Read next chunk
         framesRead = std::fread(samples.data(), sizeof(AudioSample), 
-                               config.frameSize, stdin);
+                               readSize, stdin);
     }
     
     // Stop pipeline
@@ -0,0 +1,64 @@
+#include "postprocessors/custom_verifier.h"
+#include <iostream>
+
+namespace openwakeword {
+
+CustomVerifier::CustomVerifier(const std::string& wakeWord, float threshold)
+    : wakeWord_(wakeWord), name_("CustomVerifier(" + wakeWord + ")"), threshold_(threshold) {
+}
+
+bool CustomVerifier::initialize(const std::filesystem::path& modelPath,
+                                Ort::Env& env,
+                                const Ort::SessionOptions& options) {
+    model_ = std::make_unique<CustomVerifierModel>(wakeWord_);
+    if (!model_->loadModel(modelPath, env, options)) {
+        std::cerr << "[ERROR] Failed to load custom verifier model: " << modelPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Detection CustomVerifier::process(const Detection& detection, const FeatureBuffer& features) {
+    Detection result = detection;
+    Detection* detections[] = {&result};
+    const FeatureBuffer* windows[] = {&features};
+    processBatch(detections, windows);
+    return result;
+}
+
+void CustomVerifier::processBatch(std::span<Detection* const> detections,
+                                  std::span<const FeatureBuffer* const> features) {
+    // A candidate without its window cannot be verified
+    const size_t windowSize = WAKEWORD_FEATURES * EMBEDDING_FEATURES;
+    windows_.clear();
+    for (size_t i = 0; i < detections.size(); ++i) {
+        if (features[i]->size() < windowSize) {
+            detections[i]->accepted = false;
+        } else {
+            windows_.push_back(features[i]->data() + features[i]->size() - windowSize);
+        }
+    }
+    if (windows_.empty()) {
+        return;
+    }
+
+    probabilities_.resize(windows_.size());
+    try {
+        model_->verifyBatch(windows_.data(), windows_.size(), scratch_, probabilities_.data());
+    } catch (const Ort::Exception& e) {
+        std::cerr << "[ERROR] " << name_ << " failed: " << e.what() << std::endl;
+        probabilities_.assign(windows_.size(), 0.0f);
+    }
+
+    size_t next = 0;
+    for (size_t i = 0; i < detections.size(); ++i) {
+        if (features[i]->size() < windowSize) {
+            continue;
+        }
+        float probability = probabilities_[next++];
+        detections[i]->score = probability;
+        detections[i]->accepted = probability >= threshold_;
+    }
+}
+
+} // namespace openwakeword
@@ -0,0 +1,116 @@
+#include "preprocessors/preprocessor_chain.h"
+#include <algorithm>
+
+namespace openwakeword {
+
+void PreprocessorChain::add(std::unique_ptr<Preprocessor> preprocessor) {
+    Stage stage;
+    stage.frameSize = preprocessor->getFrameSize();
+    stage.carry.resize(stage.frameSize);
+    stage.preprocessor = std::move(preprocessor);
+    stages_.push_back(std::move(stage));
+}
+
+std::span<const AudioSample> PreprocessorChain::process(std::span<const AudioSample> input) {
+    for (auto& stage : stages_) {
+        if (!stage.preprocessor->isEnabled()) {
+            continue;
+        }
+
+        if (stage.preprocessor->modifiesAudio()) {
+            input = transform(stage, input);
+        } else {
+            analyse(stage, input);
+        }
+    }
+    return input;
+}
+
+void PreprocessorChain::analyse(Stage& stage, std::span<const AudioSample> input) {
+    Preprocessor& preprocessor = *stage.preprocessor;
+
+    // The preprocessor only reads, so whole frames run straight from the input
+    if (stage.frameSize == 0) {
+        stage.output.assign(input.begin(), input.end());
+        preprocessor.process(stage.output.data(), stage.output.size());
+        return;
+    }
+
+    size_t offset = 0;
+    if (stage.carryFill > 0) {
+        size_t take = std::min(stage.frameSize - stage.carryFill, input.size());
+        std::copy_n(input.begin(), take, stage.carry.begin() + stage.carryFill);
+        stage.carryFill += take;
+        offset = take;
+        if (stage.carryFill < stage.frameSize) {
+            return;
+        }
+        preprocessor.process(stage.carry.data(), stage.frameSize);
+        stage.carryFill = 0;
+    }
+
+    // Analysers leave audio untouched, but the interface takes mutable
+    // samples, so whole frames go through the carry buffer as well
+    for (; offset + stage.frameSize <= input.size(); offset += stage.frameSize) {
+        std::copy_n(input.begin() + offset, stage.frameSize, stage.carry.begin());
+        preprocessor.process(stage.carry.data(), stage.frameSize);
+    }
+
+    stage.carryFill = input.size() - offset;
+    std::copy(input.begin() + offset, input.end(), stage.carry.begin());
+}
+
+std::span<const AudioSample> PreprocessorChain::transform(Stage& stage, std::span<const AudioSample> input) {
+    Preprocessor& preprocessor = *stage.preprocessor;
+    stage.output.clear();
+
+    if (stage.frameSize == 0) {
+        stage.output.assign(input.begin(), input.end());
+        preprocessor.process(stage.output.data(), stage.output.size());
+        return stage.output;
+    }
+
+    // Complete the carried frame first
+    size_t offset = 0;
+    if (stage.carryFill > 0) {
+        size_t take = std::min(stage.frameSize - stage.carryFill, input.size());
+        std::copy_n(input.begin(), take, stage.carry.begin() + stage.carryFill);
+        stage.carryFill += take;
+        offset = take;
+        if (stage.carryFill < stage.frameSize) {
+            return {};
+        }
+        stage.output.insert(stage.output.end(), stage.carry.begin(), stage.carry.end());
+        stage.carryFill = 0;
+    }
+
+    // Copy every remaining whole frame once and process them in one call
+    size_t whole = (input.size() - offset) / stage.frameSize * stage.frameSize;
+    stage.output.insert(stage.output.end(), input.begin() + offset, input.begin() + offset + whole);
+    offset += whole;
+    preprocessor.process(stage.output.data(), stage.output.size());
+
+    // Carry the partial frame to the next call
+    stage.carryFill = input.size() - offset;
+    std::copy(input.begin() + offset, input.end(), stage.carry.begin());
+    return stage.output;
+}
+
+size_t PreprocessorChain::getLatencySamples() const {
+    size_t latency = 0;
+    for (const auto& stage : stages_) {
+        if (stage.frameSize > 0 && stage.preprocessor->modifiesAudio()) {
+            latency += stage.frameSize - 1;
+        }
+    }
+    return latency;
+}
+
+void PreprocessorChain::reset() {
+    for (auto& stage : stages_) {
+        stage.carryFill = 0;
+        stage.output.clear();
+    }
+}
+
+} // namespace openwakeword
@@ -1,6 +1,5 @@
 #include "preprocessors/speex_noise_suppressor.h"
 #include <iostream>
-#include <cstring>
 
 #ifdef HAVE_SPEEX
 #include <speex/speex_preprocess.h>
@@ -49,45 +48,12 @@ void SpeexNoiseSupressor::process(AudioSample* samples, size_t count) {
         return;
     }
     
-    // Process in frame-sized chunks
-    size_t processed = 0;
-    
-    // Ensure process buffer is large enough
-    if (processBuffer_.size() < static_cast<size_t>(frameSize_)) {
-        processBuffer_.resize(frameSize_);
-    }
-    
-    while (processed + static_cast<size_t>(frameSize_) <= count) {
-        // Copy to process buffer
-        std::memcpy(processBuffer_.data(), samples + processed, 
-                   frameSize_ * sizeof(AudioSample));
-        
-        // Process through Speex
-        speex_preprocess_run(state_, processBuffer_.data());
-        
-        // Copy back
-        std::memcpy(samples + processed, processBuffer_.data(), 
-                   frameSize_ * sizeof(AudioSample));
-        
-        processed += static_cast<size_t>(frameSize_);
-    }
-    
-    // Handle remaining samples (if any)
-    if (processed < count) {
-        size_t remaining = count - processed;
-        
-        // Zero-pad the buffer
-        std::memcpy(processBuffer_.data(), samples + processed, 
-                   remaining * sizeof(AudioSample));
-        std::memset(processBuffer_.data() + remaining, 0, 
-                   (frameSize_ - remaining) * sizeof(AudioSample));
-        
-        // Process
-        speex_preprocess_run(state_, processBuffer_.data());
-        
-        // Copy back only the valid samples
-        std::memcpy(samples + processed, processBuffer_.data(), 
-                   remaining * sizeof(AudioSample));
+    // Speex processes 16-bit frames in place. A trailing partial frame
+    // would need a zero-padded run that disturbs the noise estimate, so it
+    // is left untouched; PreprocessorChain never passes one.
+    const size_t frameSize = static_cast<size_t>(frameSize_);
+    for (size_t offset = 0; offset + frameSize <= count; offset += frameSize) {
+        speex_preprocess_run(state_, samples + offset);
     }
 #endif
 }
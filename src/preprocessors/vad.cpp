@@ -11,15 +11,27 @@ bool VADPreprocessor::initialize(const std::filesystem::path& modelPath,
                                 Ort::Env& env,
                                 const Ort::SessionOptions& options) {
     model_ = std::make_unique<VADModel>();
-    if (!model_->loadModel(modelPath, env, options)) {
+    if (!model_->loadModel(modelPath, env, options) || !model_->prepare()) {
         std::cerr << "[ERROR] Failed to load VAD model: " << modelPath << std::endl;
         return false;
     }
     
-    std::cerr << "[LOG] Loaded VAD model" << std::endl;
+    audioBuffer_.reserve(VADModel::FRAME_SAMPLES);
     return true;
 }
 
+void VADPreprocessor::reset() {
+    audioBuffer_.clear();
+    samplesSeen_ = 0;
+    lastScore_ = 0.0f;
+    if (model_) {
+        model_->resetState();
+    }
+    if (gate_) {
+        gate_->reset();
+    }
+}
+
 void VADPreprocessor::process(AudioFrame& frame) {
     // Process the frame through VAD
     process(frame.samples.data(), frame.samples.size());
@@ -41,18 +53,19 @@ void VADPreprocessor::process(AudioFrame& frame) {
 }
 
 void VADPreprocessor::process(AudioSample* samples, size_t count) {
-    // Convert to float for VAD processing
-    audioBuffer_.clear();
-    audioBuffer_.reserve(count);
-    
+    // Silero VAD scores fixed frames of normalized audio, so samples are
+    // buffered across calls
     for (size_t i = 0; i < count; ++i) {
-        audioBuffer_.push_back(static_cast<AudioFloat>(samples[i]));
-    }
-    
-    // Process through VAD model
-    // Note: Silero VAD expects specific frame sizes, so we may need to buffer
-    if (audioBuffer_.size() >= VAD_FRAME_SIZE) {
-        lastScore_ = model_->predictVoiceActivity(audioBuffer_);
+        audioBuffer_.push_back(static_cast<AudioFloat>(samples[i]) / 32768.0f);
+        
+        if (audioBuffer_.size() == VADModel::FRAME_SAMPLES) {
+            lastScore_ = model_->predictVoiceActivity(audioBuffer_);
+            samplesSeen_ += VADModel::FRAME_SAMPLES;
+            if (gate_) {
+                gate_->update(samplesSeen_, isVoiceDetected());
+            }
+            audioBuffer_.clear();
+        }
     }
 }
 
@@ -0,0 +1,199 @@
+#include "processors/audio_converter.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include "utils/kernels.h"
+
+namespace openwakeword {
+
+namespace {
+
+// Passband edge as a fraction of the lower Nyquist frequency
+constexpr double ROLLOFF = 0.95;
+
+constexpr double PI = 3.14159265358979323846;
+
+// Zeroth order modified Bessel function of the first kind
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50 && term > 1e-12 * sum; ++k) {
+        double factor = x / (2.0 * k);
+        term *= factor * factor;
+        sum += term;
+    }
+    return sum;
+}
+
+AudioSample toSample(float value) {
+    return static_cast<AudioSample>(std::clamp(std::lrint(value), -32768L, 32767L));
+}
+
+} // namespace
+
+AudioConverter::AudioConverter(size_t inputRate, size_t channels, int channel,
+                               size_t maxInputSamples)
+    : inputRate_(inputRate),
+      channels_(std::max<size_t>(channels, 1)),
+      channel_(channel < static_cast<int>(channels_) ? channel : -1),
+      resampling_(inputRate != SAMPLE_RATE) {
+    if (resampling_) {
+        size_t divisor = std::gcd(inputRate_, SAMPLE_RATE);
+        upFactor_ = SAMPLE_RATE / divisor;
+        downFactor_ = inputRate_ / divisor;
+        designFilter();
+    }
+
+    size_t maxFrames = maxInputSamples / channels_ + 1;
+    history_.resize(tapsPerPhase_ - 1 + maxFrames);
+    output_.resize(maxFrames * upFactor_ / downFactor_ + 2);
+    partialFrame_.reserve(channels_);
+    reset();
+}
+
+bool AudioConverter::isSupportedRate(size_t inputRate) {
+    if (inputRate < 8000 || inputRate > 192000) {
+        return false;
+    }
+    return SAMPLE_RATE / std::gcd(inputRate, SAMPLE_RATE) <= MAX_PHASES;
+}
+
+void AudioConverter::designFilter() {
+    // Prototype low-pass at the upsampled rate, cut off below the lower of
+    // the two Nyquist frequencies
+    const size_t factor = std::max(upFactor_, downFactor_);
+    const double cutoff = ROLLOFF * 0.5 / static_cast<double>(factor);
+    tapsPerPhase_ = static_cast<size_t>(
+        std::ceil(2.0 * ZERO_CROSSINGS * static_cast<double>(factor) / (ROLLOFF * upFactor_)));
+    const size_t length = tapsPerPhase_ * upFactor_;
+    const double center = (static_cast<double>(length) - 1.0) / 2.0;
+
+    std::vector<double> prototype(length);
+    double sum = 0.0;
+    for (size_t j = 0; j < length; ++j) {
+        double t = static_cast<double>(j) - center;
+        double x = 2.0 * cutoff * t;
+        double sinc = (x == 0.0) ? 1.0 : std::sin(PI * x) / (PI * x);
+        double ratio = t / (center + 1.0);
+        double window = besselI0(KAISER_BETA * std::sqrt(1.0 - ratio * ratio)) / besselI0(KAISER_BETA);
+        prototype[j] = 2.0 * cutoff * sinc * window;
+        sum += prototype[j];
+    }
+
+    // Unity gain for every phase; taps are stored newest-last so a phase
+    // runs forward over the input
+    const double scale = static_cast<double>(upFactor_) / sum;
+    phases_.resize(length);
+    for (size_t phase = 0; phase < upFactor_; ++phase) {
+        for (size_t r = 0; r < tapsPerPhase_; ++r) {
+            phases_[phase * tapsPerPhase_ + r] =
+                static_cast<float>(scale * prototype[phase + upFactor_ * (tapsPerPhase_ - 1 - r)]);
+        }
+    }
+}
+
+void AudioConverter::reset() {
+    std::fill_n(history_.begin(), tapsPerPhase_ - 1, 0.0f);
+    historySize_ = tapsPerPhase_ - 1;
+    nextInput_ = tapsPerPhase_ - 1;
+    nextPhase_ = 0;
+    partialFrame_.clear();
+}
+
+size_t AudioConverter::inputForOutput(size_t outputSamples) const {
+    if (!resampling_) {
+        return outputSamples * channels_;
+    }
+    // One output of slack for the filter phase
+    size_t frames = (outputSamples > 0 ? outputSamples - 1 : 0) * downFactor_ / upFactor_;
+    return frames * channels_;
+}
+
+std::span<const AudioSample> AudioConverter::process(std::span<const AudioSample> samples) {
+    if (isPassthrough()) {
+        return samples;
+    }
+
+    // Grow once if the chunk is larger than planned for
+    size_t maxFrames = (partialFrame_.size() + samples.size()) / channels_ + 1;
+    if (history_.size() < historySize_ + maxFrames) {
+        history_.resize(historySize_ + maxFrames);
+    }
+    size_t maxOutput = resampling_ ? maxFrames * upFactor_ / downFactor_ + 2 : maxFrames;
+    if (output_.size() < maxOutput) {
+        output_.resize(maxOutput);
+    }
+
+    // Complete a frame split by the previous call
+    float* mono = history_.data() + historySize_;
+    size_t monoFrames = 0;
+    if (!partialFrame_.empty()) {
+        size_t missing = std::min(channels_ - partialFrame_.size(), samples.size());
+        partialFrame_.insert(partialFrame_.end(), samples.begin(), samples.begin() + missing);
+        samples = samples.subspan(missing);
+        if (partialFrame_.size() == channels_) {
+            downmix(partialFrame_.data(), 1, mono);
+            partialFrame_.clear();
+            monoFrames = 1;
+        }
+    }
+
+    size_t frames = samples.size() / channels_;
+    downmix(samples.data(), frames, mono + monoFrames);
+    monoFrames += frames;
+    partialFrame_.insert(partialFrame_.end(), samples.begin() + frames * channels_, samples.end());
+
+    if (!resampling_) {
+        for (size_t i = 0; i < monoFrames; ++i) {
+            output_[i] = toSample(mono[i]);
+        }
+        return {output_.data(), monoFrames};
+    }
+
+    historySize_ += monoFrames;
+    return {output_.data(), resample(output_.data())};
+}
+
+void AudioConverter::downmix(const AudioSample* frames, size_t frameCount, float* out) const {
+    if (channels_ == 1) {
+        kernels::convertInt16ToFloat(frames, out, frameCount);
+    } else if (channel_ >= 0) {
+        const AudioSample* selected = frames + channel_;
+        for (size_t i = 0; i < frameCount; ++i) {
+            out[i] = static_cast<float>(selected[i * channels_]);
+        }
+    } else {
+        const float scale = 1.0f / static_cast<float>(channels_);
+        for (size_t i = 0; i < frameCount; ++i) {
+            const AudioSample* frame = frames + i * channels_;
+            int32_t sum = 0;
+            for (size_t c = 0; c < channels_; ++c) {
+                sum += frame[c];
+            }
+            out[i] = static_cast<float>(sum) * scale;
+        }
+    }
+}
+
+size_t AudioConverter::resample(AudioSample* out) {
+    size_t produced = 0;
+    while (nextInput_ < historySize_) {
+        const float* window = history_.data() + nextInput_ + 1 - tapsPerPhase_;
+        float value = kernels::dotProduct(phases_.data() + nextPhase_ * tapsPerPhase_, window,
+                                          tapsPerPhase_);
+        out[produced++] = toSample(value);
+
+        nextPhase_ += downFactor_;
+        nextInput_ += nextPhase_ / upFactor_;
+        nextPhase_ %= upFactor_;
+    }
+
+    // Keep only the history the next output reads
+    size_t keepFrom = std::min(nextInput_ + 1 - tapsPerPhase_, historySize_);
+    std::copy(history_.begin() + keepFrom, history_.begin() + historySize_, history_.begin());
+    historySize_ -= keepFrom;
+    nextInput_ -= keepFrom;
+    return produced;
+}
+
+} // namespace openwakeword
@@ -0,0 +1,431 @@
+#include "processors/audio_reader.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace openwakeword {
+
+namespace {
+
+// WAV header fields are little-endian
+uint32_t readLE32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint16_t readLE16(const uint8_t* data) {
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+// RTP header fields are big-endian
+uint32_t readBE32(const uint8_t* data) {
+    return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+           (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+}
+
+uint16_t readBE16(const uint8_t* data) {
+    return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+#ifndef _WIN32
+bool isTransientError() {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+#endif
+
+constexpr uint16_t WAVE_FORMAT_PCM = 0x0001;
+constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+} // namespace
+
+// StdinAudioReader implementation
+StdinAudioReader::StdinAudioReader() : input_(stdin) {
+}
+
+size_t StdinAudioReader::read(AudioSample* buffer, size_t samples) {
+    if (eof_) {
+        return 0;
+    }
+    size_t samplesRead = std::fread(buffer, sizeof(AudioSample), samples, input_);
+    if (samplesRead < samples) {
+        eof_ = true;
+    }
+    return samplesRead;
+}
+
+bool StdinAudioReader::hasMore() const {
+    return !eof_;
+}
+
+// WavFileReader implementation
+WavFileReader::WavFileReader(const std::string& filename) {
+    file_ = std::fopen(filename.c_str(), "rb");
+    if (file_ == nullptr) {
+        std::cerr << "[ERROR] Failed to open WAV file: " << filename << std::endl;
+        return;
+    }
+    
+    if (!parseHeader()) {
+        std::cerr << "[ERROR] Unsupported WAV file (16-bit PCM required): " << filename << std::endl;
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+WavFileReader::~WavFileReader() {
+    if (file_ != nullptr) {
+        std::fclose(file_);
+    }
+}
+
+bool WavFileReader::parseHeader() {
+    uint8_t riff[12];
+    if (std::fread(riff, 1, sizeof(riff), file_) != sizeof(riff) ||
+        std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    
+    bool haveFormat = false;
+    uint8_t chunkHeader[8];
+    while (std::fread(chunkHeader, 1, sizeof(chunkHeader), file_) == sizeof(chunkHeader)) {
+        uint32_t chunkSize = readLE32(chunkHeader + 4);
+        
+        if (std::memcmp(chunkHeader, "fmt ", 4) == 0) {
+            uint8_t format[40] = {};
+            size_t formatSize = std::min<size_t>(chunkSize, sizeof(format));
+            if (chunkSize < 16 || std::fread(format, 1, formatSize, file_) != formatSize) {
+                return false;
+            }
+            
+            uint16_t audioFormat = readLE16(format);
+            if (audioFormat == WAVE_FORMAT_EXTENSIBLE && chunkSize >= 26) {
+                // Sub-format GUID starts with the actual format tag
+                audioFormat = readLE16(format + 24);
+            }
+            channels_ = readLE16(format + 2);
+            sampleRate_ = readLE32(format + 4);
+            uint16_t bitsPerSample = readLE16(format + 14);
+            
+            if (audioFormat != WAVE_FORMAT_PCM || bitsPerSample != 16 || channels_ == 0) {
+                return false;
+            }
+            haveFormat = true;
+            
+            // Skip any remaining format bytes (chunks are word-aligned)
+            long skip = static_cast<long>(chunkSize - formatSize + (chunkSize & 1));
+            if (skip > 0 && std::fseek(file_, skip, SEEK_CUR) != 0) {
+                return false;
+            }
+        } else if (std::memcmp(chunkHeader, "data", 4) == 0) {
+            if (!haveFormat) {
+                return false;
+            }
+            totalSamples_ = chunkSize / (sizeof(AudioSample) * channels_);
+            remainingSamples_ = totalSamples_ * channels_;
+            headerParsed_ = true;
+            return true;
+        } else {
+            // Skip unknown chunks (LIST, fact, ...)
+            if (std::fseek(file_, static_cast<long>(chunkSize + (chunkSize & 1)), SEEK_CUR) != 0) {
+                return false;
+            }
+        }
+    }
+    
+    return false;
+}
+
+size_t WavFileReader::read(AudioSample* buffer, size_t samples) {
+    if (file_ == nullptr || remainingSamples_ == 0) {
+        return 0;
+    }
+    
+    size_t toRead = std::min(samples, remainingSamples_);
+    size_t samplesRead = std::fread(buffer, sizeof(AudioSample), toRead, file_);
+    if (samplesRead < toRead) {
+        // Truncated file
+        remainingSamples_ = 0;
+    } else {
+        remainingSamples_ -= samplesRead;
+    }
+    return samplesRead;
+}
+
+bool WavFileReader::hasMore() const {
+    return file_ != nullptr && remainingSamples_ > 0;
+}
+
+// MappedAudioReader implementation
+MappedAudioReader::MappedAudioReader(const std::string& filename, bool raw) {
+    // Samples are consumed front to back exactly once
+    if (!mapping_.open(filename, true)) {
+        std::cerr << "[ERROR] Failed to map audio file: " << filename << std::endl;
+        return;
+    }
+    
+    // Headerless PCM must be announced by name or by the caller
+    auto extension = std::filesystem::path(filename).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    raw = raw || extension == ".raw" || extension == ".pcm";
+    
+    if (!parseHeader(raw)) {
+        std::cerr << "[ERROR] Unsupported audio file (16-bit PCM WAV, or headerless PCM named "
+                     ".raw/.pcm): " << filename << std::endl;
+        mapping_.close();
+        return;
+    }
+    open_ = true;
+}
+
+MappedAudioReader::~MappedAudioReader() = default;
+
+bool MappedAudioReader::parseHeader(bool raw) {
+    const uint8_t* mapping = mapping_.data();
+    const size_t mappingSize = mapping_.size();
+    size_t dataOffset = 0;
+    size_t dataSize = mappingSize;
+    
+    if (mappingSize >= 12 && std::memcmp(mapping, "RIFF", 4) == 0 &&
+        std::memcmp(mapping + 8, "WAVE", 4) == 0) {
+        bool haveFormat = false;
+        bool haveData = false;
+        size_t offset = 12;
+        
+        while (offset + 8 <= mappingSize) {
+            const uint8_t* chunk = mapping + offset;
+            size_t chunkSize = readLE32(chunk + 4);
+            size_t bodyOffset = offset + 8;
+            
+            if (std::memcmp(chunk, "fmt ", 4) == 0) {
+                if (chunkSize < 16 || bodyOffset + 16 > mappingSize) {
+                    return false;
+                }
+                const uint8_t* format = mapping + bodyOffset;
+                uint16_t audioFormat = readLE16(format);
+                if (audioFormat == WAVE_FORMAT_EXTENSIBLE && chunkSize >= 26 &&
+                    bodyOffset + 26 <= mappingSize) {
+                    audioFormat = readLE16(format + 24);
+                }
+                channels_ = readLE16(format + 2);
+                sampleRate_ = readLE32(format + 4);
+                uint16_t bitsPerSample = readLE16(format + 14);
+                
+                if (audioFormat != WAVE_FORMAT_PCM || bitsPerSample != 16 || channels_ == 0) {
+                    return false;
+                }
+                haveFormat = true;
+            } else if (std::memcmp(chunk, "data", 4) == 0) {
+                if (!haveFormat) {
+                    return false;
+                }
+                dataOffset = bodyOffset;
+                // Truncated files keep whatever samples are present
+                dataSize = std::min(chunkSize, mappingSize - bodyOffset);
+                haveData = true;
+                break;
+            }
+            
+            // Chunks are word-aligned
+            offset = bodyOffset + chunkSize + (chunkSize & 1);
+        }
+        
+        if (!haveData) {
+            return false;
+        }
+    } else if (!raw) {
+        return false;
+    }
+    // Otherwise headerless PCM at the default rate, mono
+    
+    // Whole frames only
+    size_t sampleCount = dataSize / (sizeof(AudioSample) * channels_) * channels_;
+    const uint8_t* data = mapping + dataOffset;
+    
+    if (reinterpret_cast<uintptr_t>(data) % alignof(AudioSample) == 0) {
+        samples_ = std::span<const AudioSample>(reinterpret_cast<const AudioSample*>(data), sampleCount);
+    } else {
+        unaligned_.resize(sampleCount);
+        std::memcpy(unaligned_.data(), data, sampleCount * sizeof(AudioSample));
+        samples_ = unaligned_;
+    }
+    return true;
+}
+
+std::span<const AudioSample> MappedAudioReader::next(size_t maxSamples) {
+    size_t count = std::min(maxSamples, samples_.size() - position_);
+    auto view = samples_.subspan(position_, count);
+    position_ += count;
+    return view;
+}
+
+size_t MappedAudioReader::read(AudioSample* buffer, size_t samples) {
+    auto view = next(samples);
+    std::copy(view.begin(), view.end(), buffer);
+    return view.size();
+}
+
+// SocketAudioReader implementation
+SocketAudioReader::~SocketAudioReader() {
+#ifndef _WIN32
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+}
+
+size_t SocketAudioReader::read(AudioSample* buffer, size_t samples) {
+#ifdef _WIN32
+    (void)buffer;
+    (void)samples;
+    eof_ = true;
+    return 0;
+#else
+    if (eof_ || samples == 0) {
+        return 0;
+    }
+    
+    // Complete the carried sample in place, then receive behind it
+    auto* bytes = reinterpret_cast<uint8_t*>(buffer);
+    size_t offset = hasPartial_ ? 1 : 0;
+    if (hasPartial_) {
+        bytes[0] = partial_;
+    }
+    
+    ssize_t received = ::recv(fd_, bytes + offset, samples * sizeof(AudioSample) - offset, 0);
+    if (received < 0 && isTransientError()) {
+        if (hasPartial_) {
+            partial_ = bytes[0];
+        }
+        return 0;
+    }
+    if (received <= 0) {
+        // Closed or failed; a trailing odd byte is dropped
+        eof_ = true;
+        return 0;
+    }
+    
+    size_t total = static_cast<size_t>(received) + offset;
+    hasPartial_ = (total & 1) != 0;
+    if (hasPartial_) {
+        partial_ = bytes[total - 1];
+    }
+    return total / sizeof(AudioSample);
+#endif
+}
+
+// DatagramSource implementation
+std::string DatagramSource::toString() const {
+    std::ostringstream name;
+    name << ((address >> 24) & 0xFF) << '.' << ((address >> 16) & 0xFF) << '.'
+         << ((address >> 8) & 0xFF) << '.' << (address & 0xFF) << ':' << port;
+    if (ssrc != 0) {
+        name << "/" << std::hex << ssrc;
+    }
+    return name.str();
+}
+
+// DatagramAudioReader implementation
+DatagramAudioReader::~DatagramAudioReader() {
+#ifndef _WIN32
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+}
+
+size_t DatagramAudioReader::read(AudioSample* buffer, size_t samples) {
+#ifdef _WIN32
+    (void)buffer;
+    (void)samples;
+    failed_ = true;
+    return 0;
+#else
+    if (failed_) {
+        return 0;
+    }
+    
+    // Header into the reader, payload into the caller's buffer
+    iovec parts[2];
+    parts[0].iov_base = header_;
+    parts[0].iov_len = RTP_HEADER_SIZE;
+    parts[1].iov_base = buffer;
+    parts[1].iov_len = samples * sizeof(AudioSample);
+    
+    sockaddr_in sender{};
+    msghdr message{};
+    message.msg_name = &sender;
+    message.msg_namelen = sizeof(sender);
+    message.msg_iov = rtp_ ? parts : parts + 1;
+    message.msg_iovlen = rtp_ ? 2 : 1;
+    
+    ssize_t received = ::recvmsg(fd_, &message, 0);
+    wouldBlock_ = received < 0 && isTransientError();
+    if (received < 0) {
+        failed_ = !wouldBlock_;
+        return 0;
+    }
+    
+    source_.address = ntohl(sender.sin_addr.s_addr);
+    source_.port = ntohs(sender.sin_port);
+    source_.ssrc = 0;
+    
+    if (!rtp_) {
+        return static_cast<size_t>(received) / sizeof(AudioSample);
+    }
+    
+    // Version 2 only
+    if (static_cast<size_t>(received) < RTP_HEADER_SIZE || (header_[0] >> 6) != 2) {
+        return 0;
+    }
+    auto* payload = reinterpret_cast<uint8_t*>(buffer);
+    size_t payloadBytes = static_cast<size_t>(received) - RTP_HEADER_SIZE;
+    
+    // Trailing padding, then the CSRC list and header extension in front
+    if ((header_[0] & 0x20) != 0) {
+        size_t padding = payloadBytes > 0 ? payload[payloadBytes - 1] : 0;
+        if (padding == 0 || padding > payloadBytes) {
+            return 0;
+        }
+        payloadBytes -= padding;
+    }
+    size_t skip = 4 * static_cast<size_t>(header_[0] & 0x0F);
+    if ((header_[0] & 0x10) != 0) {
+        if (payloadBytes < skip + 4) {
+            return 0;
+        }
+        skip += 4 + 4 * static_cast<size_t>(readBE16(payload + skip + 2));
+    }
+    if (skip > payloadBytes) {
+        return 0;
+    }
+    payloadBytes -= skip;
+    if (skip > 0) {
+        std::memmove(payload, payload + skip, payloadBytes);
+    }
+    
+    sequence_ = readBE16(header_ + 2);
+    source_.ssrc = readBE32(header_ + 8);
+    
+    // L16 is big-endian; each sample is read before its bytes are overwritten
+    size_t count = payloadBytes / sizeof(AudioSample);
+    for (size_t i = 0; i < count; ++i) {
+        buffer[i] = static_cast<AudioSample>(readBE16(payload + 2 * i));
+    }
+    return count;
+#endif
+}
+
+} // namespace openwakeword
@@ -0,0 +1,56 @@
+#include "processors/cascade_stage.h"
+#include <cmath>
+#include <iostream>
+
+namespace openwakeword {
+
+bool CascadeStage::initialize(const std::filesystem::path& modelPath, Ort::Env& env,
+                              const Ort::SessionOptions& options) {
+    if (modelPath.empty()) {
+        return true;
+    }
+
+    if (!std::filesystem::exists(modelPath)) {
+        std::cerr << "[ERROR] Cascade model not found: " << modelPath << std::endl;
+        return false;
+    }
+
+    model_ = std::make_unique<WakeWordModel>(modelPath.stem().string());
+    if (!model_->loadModel(modelPath, env, options)) {
+        std::cerr << "[ERROR] Failed to load cascade model: " << modelPath << std::endl;
+        model_.reset();
+        return false;
+    }
+    model_->bindIo();
+    return true;
+}
+
+bool CascadeStage::isOpen(const AudioFloat* window) {
+    if (model_) {
+        return model_->predict(window) >= threshold_;
+    }
+
+    const AudioFloat* newest = window + (WAKEWORD_FEATURES - 1) * EMBEDDING_FEATURES;
+    if (background_.empty()) {
+        // Nothing to compare with yet
+        background_.assign(newest, newest + EMBEDDING_FEATURES);
+        return true;
+    }
+
+    float dot = 0.0f;
+    float newestNorm = 0.0f;
+    float backgroundNorm = 0.0f;
+    for (size_t i = 0; i < EMBEDDING_FEATURES; ++i) {
+        dot += newest[i] * background_[i];
+        newestNorm += newest[i] * newest[i];
+        backgroundNorm += background_[i] * background_[i];
+    }
+    float distance = 1.0f - dot / (std::sqrt(newestNorm * backgroundNorm) + 1e-12f);
+
+    for (size_t i = 0; i < EMBEDDING_FEATURES; ++i) {
+        background_[i] += (newest[i] - background_[i]) / BACKGROUND_WINDOWS;
+    }
+    return distance >= threshold_;
+}
+
+} // namespace openwakeword
@@ -0,0 +1,120 @@
+#include "processors/detector_group.h"
+#include <algorithm>
+
+namespace openwakeword {
+
+void DetectorGroup::addDetector(WakeWordDetector* detector) {
+    auto model = detector->getModel();
+    auto it = std::find_if(slots_.begin(), slots_.end(),
+                           [&model](const ModelSlot& slot) { return slot.model == model; });
+    if (it == slots_.end()) {
+        ModelSlot slot;
+        slot.model = model;
+        slot.scores.resize(model->getNumScores());
+        slot.maxBacklog = detector->getOverloadLimit();
+        slots_.push_back(std::move(slot));
+        it = slots_.end() - 1;
+    }
+    it->detectors.push_back(detector);
+    
+    // A model is only skipped if none of its detectors must keep up
+    size_t limit = detector->getOverloadLimit();
+    it->maxBacklog = limit == 0 ? 0 : (it->maxBacklog == 0 ? 0 : std::min(it->maxBacklog, limit));
+}
+
+void DetectorGroup::setCascade(std::unique_ptr<CascadeStage> first, float margin,
+                               size_t holdSteps) {
+    cascade_ = std::move(first);
+    cascadeMargin_ = margin;
+    cascadeHold_ = holdSteps;
+}
+
+void DetectorGroup::setMetrics(Metrics& metrics) {
+    metrics_ = &metrics;
+    if (cascade_) {
+        cascadeTime_ = metrics.addStage("cascade");
+    }
+    for (auto& slot : slots_) {
+        slot.inferenceTime = metrics.addStage("wake_word", slot.model->getName());
+        for (auto* detector : slot.detectors) {
+            detector->setMetrics(&metrics, nullptr);
+        }
+    }
+}
+
+void DetectorGroup::run(std::shared_ptr<BroadcastRingBuffer<AudioFloat>> input,
+                        size_t readerId,
+                        std::mutex& outputMutex,
+                        OutputMode outputMode,
+                        bool showTimestamp) {
+    while (true) {
+        // One window per step, shared by every model in the group
+        const AudioFloat* windowFeatures = input->waitForWindow(readerId, WAKEWORD_FEATURES);
+        if (windowFeatures == nullptr) {
+            break;
+        }
+        
+        size_t backlog = input->available(readerId) - WAKEWORD_FEATURES;
+        
+        bool open = true;
+        if (cascade_) {
+            ScopedTimer timer(cascadeTime_);
+            open = cascade_->isOpen(windowFeatures);
+        }
+        
+        for (auto& slot : slots_) {
+            if (slot.maxBacklog > 0 && backlog > slot.maxBacklog) {
+                // Behind the deadline: skip the model until caught up
+                for (auto* detector : slot.detectors) {
+                    detector->skipPrediction();
+                }
+                if (metrics_) {
+                    metrics_->recordOverloadSkips(1);
+                }
+                continue;
+            }
+            
+            if (cascade_) {
+                if (open) {
+                    slot.hold = cascadeHold_;
+                }
+                if (slot.hold == 0) {
+                    // Far from any detection: skip the model this window
+                    for (auto* detector : slot.detectors) {
+                        detector->skipPrediction();
+                    }
+                    continue;
+                }
+                slot.hold--;
+            }
+            
+            {
+                ScopedTimer timer(slot.inferenceTime);
+                if (slot.scores.size() > 1) {
+                    // Merged graph: one Run scores every wake word it contains
+                    slot.model->predictAll(windowFeatures, slot.scores.data());
+                } else {
+                    slot.scores[0] = slot.model->predict(windowFeatures);
+                }
+            }
+            
+            for (auto* detector : slot.detectors) {
+                float score = slot.scores[detector->getScoreIndex()];
+                if (cascade_ && score >= cascadeMargin_ * detector->getConfig().threshold) {
+                    // Close to a detection: keep running without the first stage
+                    slot.hold = cascadeHold_;
+                }
+                detector->processPrediction(score, outputMutex, outputMode, showTimestamp,
+                                            windowFeatures);
+            }
+        }
+        
+        if (metrics_) {
+            metrics_->recordStep(steps_ + WAKEWORD_FEATURES - 1);
+        }
+        ++steps_;
+        input->advance(readerId);
+    }
+}
+
+} // namespace openwakeword
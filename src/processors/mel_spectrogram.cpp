@@ -8,15 +8,27 @@ MelSpectrogramProcessor::MelSpectrogramProcessor(Ort::Env& env, const Ort::Sessi
 }
 
 bool MelSpectrogramProcessor::initialize() {
-    if (!std::filesystem::exists(modelPath_)) {
-        std::cerr << "[ERROR] Mel spectrogram model not found: " << modelPath_ << std::endl;
-        return false;
+    if (!frontend_) {
+        if (!std::filesystem::exists(modelPath_)) {
+            std::cerr << "[ERROR] Mel spectrogram model not found: " << modelPath_ << std::endl;
+            return false;
+        }
+        
+        auto model = std::make_unique<MelSpectrogramModel>();
+        if (!model->loadModel(modelPath_, env_, options_, cpuFallback_)) {
+            std::cerr << "[ERROR] Failed to load mel spectrogram model" << std::endl;
+            return false;
+        }
+        frontend_ = std::move(model);
     }
     
-    model_ = std::make_unique<MelSpectrogramModel>();
-    if (!model_->loadModel(modelPath_, env_, options_)) {
-        std::cerr << "[ERROR] Failed to load mel spectrogram model" << std::endl;
-        return false;
+    // Preallocate (the model binds tensors, falling back to per-call tensors)
+    if (streaming_) {
+        frontend_->prepare(MelStreamer::INPUT_SAMPLES);
+        streamer_ = std::make_unique<MelStreamer>(*frontend_);
+        streamedMels_.reserve((frameSize_ / MelStreamer::GROUP_SAMPLES + 1) * EMBEDDING_STEP_SIZE * NUM_MELS);
+    } else {
+        frontend_->prepare(frameSize_);
     }
     
     // Log message handled by pipeline based on output mode
@@ -30,11 +42,14 @@ bool MelSpectrogramProcessor::process() {
 }
 
 void MelSpectrogramProcessor::reset() {
-    todoSamples_.clear();
+    frameFill_ = 0;
+    if (streamer_) {
+        streamer_->reset();
+    }
 }
 
-void MelSpectrogramProcessor::run(std::shared_ptr<ThreadSafeBuffer<AudioFloat>> input,
-                                  std::shared_ptr<ThreadSafeBuffer<AudioFloat>> output,
+void MelSpectrogramProcessor::run(std::shared_ptr<SpscRingBuffer<AudioFloat>> input,
+                                  std::shared_ptr<SpscRingBuffer<AudioFloat>> output,
                                   OutputMode outputMode) {
     if (!initialized_) {
         if (outputMode != OutputMode::QUIET) {
@@ -43,29 +58,47 @@ void MelSpectrogramProcessor::run(std::shared_ptr<ThreadSafeBuffer<AudioFloat>>
         return;
     }
     
-    while (true) {
-        // Get audio samples from input buffer
-        auto samples = input->pull();
-        if (input->isExhausted() && samples.empty()) {
+    frameSamples_.resize(frameSize_);
+    frameFill_ = 0;
+    
+    while (streaming_) {
+        // Take whatever audio has arrived; mels leave in 80 ms groups
+        size_t count = input->pull(frameSamples_.data(), frameSize_);
+        if (count == 0) {
             break;
         }
         
-        // Accumulate samples
-        todoSamples_.insert(todoSamples_.end(), samples.begin(), samples.end());
+        // Only calls that complete a group run the frontend
+        auto start = std::chrono::steady_clock::now();
+        if (streamer_->process(frameSamples_.data(), count, streamedMels_) > 0) {
+            if (inferenceTime_) {
+                inferenceTime_->record(std::chrono::steady_clock::now() - start);
+            }
+            output->push(streamedMels_.data(), streamedMels_.size());
+        }
+    }
+    
+    while (!streaming_) {
+        // Pull audio straight into the frame being assembled
+        size_t count = input->pull(frameSamples_.data() + frameFill_, frameSize_ - frameFill_);
+        if (count == 0) {
+            break;
+        }
+        frameFill_ += count;
         
-        // Process complete frames
-        while (todoSamples_.size() >= frameSize_) {
-            // Extract one frame
-            AudioBuffer frameSamples(todoSamples_.begin(), todoSamples_.begin() + frameSize_);
-            
+        // Process complete frame
+        if (frameFill_ == frameSize_) {
             // Compute mel spectrogram
-            auto melData = model_->computeMelSpectrogram(frameSamples);
+            std::span<const AudioFloat> melData;
+            {
+                ScopedTimer timer(inferenceTime_);
+                melData = frontend_->computeMelSpectrogram(frameSamples_.data(), frameSize_);
+            }
             
             // Push to output buffer
-            output->push(melData);
+            output->push(melData.data(), melData.size());
             
-            // Remove processed samples
-            todoSamples_.erase(todoSamples_.begin(), todoSamples_.begin() + frameSize_);
+            frameFill_ = 0;
         }
     }
     
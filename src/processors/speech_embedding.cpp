@@ -1,4 +1,5 @@
 #include "processors/speech_embedding.h"
+#include <algorithm>
 #include <iostream>
 
 namespace openwakeword {
@@ -7,7 +8,8 @@ SpeechEmbeddingProcessor::SpeechEmbeddingProcessor(Ort::Env& env,
                                                    const Ort::SessionOptions& options,
                                                    size_t numWakeWords)
     : TransformProcessor("SpeechEmbedding"), env_(env), options_(options), 
-      numWakeWords_(numWakeWords) {
+      numWakeWords_(numWakeWords),
+      todoMels_(NUM_MELS, 2 * EMBEDDING_WINDOW_SIZE + (WAKEWORD_FEATURES - 1) * EMBEDDING_STEP_SIZE) {
 }
 
 bool SpeechEmbeddingProcessor::initialize() {
@@ -17,11 +19,14 @@ bool SpeechEmbeddingProcessor::initialize() {
     }
     
     model_ = std::make_unique<EmbeddingModel>();
-    if (!model_->loadModel(modelPath_, env_, options_)) {
+    if (!model_->loadModel(modelPath_, env_, options_, cpuFallback_)) {
         std::cerr << "[ERROR] Failed to load speech embedding model" << std::endl;
         return false;
     }
     
+    // Preallocate and bind tensors; falls back to per-call tensors on failure
+    model_->bindIo();
+    
     // Log message handled by pipeline based on output mode
     initialized_ = true;
     return true;
@@ -34,10 +39,30 @@ bool SpeechEmbeddingProcessor::process() {
 
 void SpeechEmbeddingProcessor::reset() {
     todoMels_.clear();
+    heldWindows_ = 0;
+    consumedMels_ = 0;
+    overloadSkippedWindows_ = 0;
+}
+
+void SpeechEmbeddingProcessor::publishWindow(size_t offset, BroadcastRingBuffer<AudioFloat>& output) {
+    std::span<const AudioFloat> embeddings;
+    {
+        // Extract embeddings straight from the window
+        ScopedTimer timer(inferenceTime_);
+        embeddings = model_->extractEmbeddings(todoMels_.data() + offset * NUM_MELS);
+    }
+    
+    if (clock_) {
+        clock_->markEmbedding(computedWindows_, windowEnd(offset));
+    }
+    
+    // Publish once; every wake word detector reads it in place
+    output.push(embeddings.data(), embeddings.size() / EMBEDDING_FEATURES);
+    ++computedWindows_;
 }
 
-void SpeechEmbeddingProcessor::run(std::shared_ptr<ThreadSafeBuffer<AudioFloat>> input,
-                                   std::vector<std::shared_ptr<ThreadSafeBuffer<AudioFloat>>> outputs,
+void SpeechEmbeddingProcessor::run(std::shared_ptr<SpscRingBuffer<AudioFloat>> input,
+                                   std::shared_ptr<BroadcastRingBuffer<AudioFloat>> output,
                                    OutputMode outputMode) {
     if (!initialized_) {
         if (outputMode != OutputMode::QUIET) {
@@ -46,42 +71,79 @@ void SpeechEmbeddingProcessor::run(std::shared_ptr<ThreadSafeBuffer<AudioFloat>>
         return;
     }
     
+    pullBuffer_.resize(EMBEDDING_WINDOW_SIZE * NUM_MELS);
+    size_t pending = 0;  // Floats of a partial mel frame at the start of pullBuffer_
+    
     while (true) {
-        // Get mel spectrograms from input buffer
-        auto mels = input->pull();
-        if (input->isExhausted() && mels.empty()) {
+        // Get mel spectrograms from input buffer, no more than the window can take
+        size_t room = std::min(pullBuffer_.size(), todoMels_.space() * NUM_MELS) - pending;
+        size_t count = input->pull(pullBuffer_.data() + pending, room);
+        if (count == 0) {
             break;
         }
         
-        // Accumulate mels
-        todoMels_.insert(todoMels_.end(), mels.begin(), mels.end());
+        // Accumulate whole mel frames
+        size_t available = pending + count;
+        size_t frames = available / NUM_MELS;
+        todoMels_.append(pullBuffer_.data(), frames);
+        pending = available - frames * NUM_MELS;
+        std::copy(pullBuffer_.begin() + frames * NUM_MELS,
+                  pullBuffer_.begin() + available, pullBuffer_.begin());
         
         // Process when we have enough mel frames
-        size_t melFrames = todoMels_.size() / NUM_MELS;
-        while (melFrames >= EMBEDDING_WINDOW_SIZE) {
-            // Extract window of mels
-            MelBuffer windowMels(todoMels_.begin(), 
-                               todoMels_.begin() + (EMBEDDING_WINDOW_SIZE * NUM_MELS));
-            
-            // Extract embeddings
-            auto embeddings = model_->extractEmbeddings(windowMels);
-            
-            // Send to all wake word detectors
-            for (auto& output : outputs) {
-                output->push(embeddings);
+        while (todoMels_.size() >= EMBEDDING_WINDOW_SIZE + heldWindows_ * EMBEDDING_STEP_SIZE) {
+            if (maxBacklogFrames_ > 0 && heldWindows_ == 0) {
+                // Behind the deadline: the oldest audio is skipped, so the
+                // windows computed are recent again
+                size_t backlog = input->size() / NUM_MELS + (todoMels_.size() - EMBEDDING_WINDOW_SIZE);
+                if (backlog > maxBacklogFrames_) {
+                    consumeMels(EMBEDDING_STEP_SIZE);
+                    ++overloadSkippedWindows_;
+                    if (overloadMetrics_) {
+                        overloadMetrics_->recordOverloadSkips(1);
+                    }
+                    continue;
+                }
             }
             
-            // Slide window by step size
-            todoMels_.erase(todoMels_.begin(), 
-                           todoMels_.begin() + (EMBEDDING_STEP_SIZE * NUM_MELS));
+            if (!gate_) {
+                publishWindow(0, *output);
+                
+                // Slide window by step size
+                consumeMels(EMBEDDING_STEP_SIZE);
+                continue;
+            }
             
-            melFrames = todoMels_.size() / NUM_MELS;
+            if (gate_->isOpen(windowEnd(heldWindows_ * EMBEDDING_STEP_SIZE))) {
+                // Held windows first, so the wake word model sees the audio
+                // leading up to speech onset
+                for (size_t held = 0; held <= heldWindows_; ++held) {
+                    publishWindow(held * EMBEDDING_STEP_SIZE, *output);
+                }
+                consumeMels((heldWindows_ + 1) * EMBEDDING_STEP_SIZE);
+                heldWindows_ = 0;
+            } else if (heldWindows_ < WAKEWORD_FEATURES - 1) {
+                ++heldWindows_;
+            } else {
+                // Drop the oldest held window
+                consumeMels(EMBEDDING_STEP_SIZE);
+                ++skippedWindows_;
+            }
         }
     }
     
-    // Signal that processing is complete for all outputs
-    for (auto& output : outputs) {
-        output->setExhausted(true);
+    // Signal that processing is complete for all detectors
+    output->setExhausted(true);
+    
+    if (maxBacklogFrames_ > 0 && outputMode == OutputMode::VERBOSE) {
+        std::cerr << "[LOG] Overload skipped " << overloadSkippedWindows_ << " embedding windows"
+                  << std::endl;
+    }
+    
+    if (gate_ && outputMode == OutputMode::VERBOSE) {
+        uint64_t total = computedWindows_ + skippedWindows_;
+        std::cerr << "[LOG] VAD gate skipped " << skippedWindows_ << " of " << total
+                  << " embedding windows" << std::endl;
     }
 }
 
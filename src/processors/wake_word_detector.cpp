@@ -8,21 +8,41 @@ WakeWordDetector::WakeWordDetector(const std::string& wakeWord,
                                    Ort::Env& env, 
                                    const Ort::SessionOptions& options)
     : AudioProcessor(wakeWord), wakeWord_(wakeWord), config_(config), 
-      env_(env), options_(options) {
+      env_(env), options_(options), activation_(config) {
+}
+
+WakeWordDetector::WakeWordDetector(const std::string& wakeWord,
+                                   const WakeWordConfig& config,
+                                   std::shared_ptr<WakeWordModel> model,
+                                   size_t scoreIndex,
+                                   Ort::Env& env,
+                                   const Ort::SessionOptions& options)
+    : AudioProcessor(wakeWord), wakeWord_(wakeWord), config_(config),
+      env_(env), options_(options), model_(std::move(model)), scoreIndex_(scoreIndex),
+      activation_(config) {
 }
 
 bool WakeWordDetector::initialize() {
+    if (model_ && model_->isLoaded()) {
+        // Shared model, loaded by its owner
+        initialized_ = true;
+        return true;
+    }
+    
     if (!std::filesystem::exists(config_.modelPath)) {
         std::cerr << "[ERROR] Wake word model not found: " << config_.modelPath << std::endl;
         return false;
     }
     
-    model_ = std::make_unique<WakeWordModel>(wakeWord_);
-    if (!model_->loadModel(config_.modelPath, env_, options_)) {
+    model_ = std::make_shared<WakeWordModel>(wakeWord_);
+    if (!model_->loadModel(config_.modelPath, env_, options_, cpuFallback_)) {
         std::cerr << "[ERROR] Failed to load wake word model: " << wakeWord_ << std::endl;
         return false;
     }
     
+    // Preallocate and bind tensors; falls back to per-call tensors on failure
+    model_->bindIo();
+    
     // Log message handled by pipeline based on output mode
     initialized_ = true;
     return true;
@@ -34,57 +54,125 @@ bool WakeWordDetector::process() {
 }
 
 void WakeWordDetector::reset() {
-    todoFeatures_.clear();
-    activationCount_ = 0;
+    activation_.reset();
+    windowsScored_ = 0;
+}
+
+void WakeWordDetector::run(std::shared_ptr<BroadcastRingBuffer<AudioFloat>> input,
+                           size_t readerId,
+                           std::mutex& outputMutex,
+                           OutputMode outputMode,
+                           bool showTimestamp) {
+    if (!initialized_) {
+        if (outputMode != OutputMode::QUIET) {
+            std::cerr << "[ERROR] WakeWordDetector not initialized: " << wakeWord_ << std::endl;
+        }
+        return;
+    }
+    
+    while (true) {
+        // Wait for a full window of embeddings, shared with the other detectors
+        const AudioFloat* windowFeatures = input->waitForWindow(readerId, WAKEWORD_FEATURES);
+        if (windowFeatures == nullptr) {
+            break;
+        }
+        
+        // Behind the deadline: skip steps until caught up
+        if (maxBacklog_ > 0 && input->available(readerId) - WAKEWORD_FEATURES > maxBacklog_) {
+            skipPrediction();
+            if (metrics_) {
+                metrics_->recordOverloadSkips(1);
+                metrics_->recordStep(windowsScored_ - 1 + WAKEWORD_FEATURES - 1, false);
+            }
+            input->advance(readerId);
+            continue;
+        }
+        
+        // Run wake word detection
+        float probability;
+        {
+            ScopedTimer timer(inferenceTime_);
+            probability = model_->predict(windowFeatures);
+        }
+        
+        // Process the prediction
+        processPrediction(probability, outputMutex, outputMode, showTimestamp, windowFeatures);
+        if (metrics_) {
+            // Timed against the deadline from the window's last embedding
+            metrics_->recordStep(windowsScored_ - 1 + WAKEWORD_FEATURES - 1);
+        }
+        
+        // Slide window by one embedding
+        input->advance(readerId);
+    }
 }
 
 void WakeWordDetector::processPrediction(float probability, std::mutex& outputMutex,
-                                       OutputMode outputMode, bool showTimestamp) {
-    if (config_.debug || outputMode == OutputMode::VERBOSE) {
+                                       OutputMode outputMode, bool showTimestamp,
+                                       const AudioFloat* features) {
+    bool trace = config_.debug || outputMode == OutputMode::VERBOSE;
+    bool triggered = activation_.update(probability);
+    
+    if (collector_) {
+        // Formatting and I/O happen on the collector thread
+        if (trace) {
+            DetectionEvent event;
+            event.type = DetectionEvent::Type::SCORE;
+            event.detector = collectorId_;
+            event.score = probability;
+            event.window = windowsScored_;
+            collector_->post(std::move(event));
+        }
+        if (triggered) {
+            DetectionEvent event;
+            event.type = DetectionEvent::Type::DETECTION;
+            event.detector = collectorId_;
+            event.score = probability;
+            event.window = windowsScored_;
+            if (features && collector_->wantsFeatures()) {
+                event.features.assign(features, features + WAKEWORD_FEATURES * EMBEDDING_FEATURES);
+            }
+            collector_->post(std::move(event));
+        }
+        windowsScored_++;
+        return;
+    }
+    
+    if (trace) {
         std::unique_lock<std::mutex> lock(outputMutex);
         std::cerr << wakeWord_ << " " << probability << std::endl;
     }
     
-    if (probability > config_.threshold) {
+    if (triggered) {
+        // Trigger level reached - output detection
+        {
+            std::unique_lock<std::mutex> lock(outputMutex);
+            printDetection(wakeWord_, probability, outputMode, showTimestamp);
+            std::cout.flush();
+        }
+        
+        // Timed from the audio completing the window's last embedding
+        if (metrics_) {
+            metrics_->recordDetection(windowsScored_ + WAKEWORD_FEATURES - 1);
+        }
+    }
+    windowsScored_++;
+}
+
+void WakeWordDetector::skipPrediction() {
+    activation_.update(0.0f);
+    windowsScored_++;
+}
+
+bool ActivationTracker::update(float probability) {
+    if (probability > threshold_) {
         // Activation detected
         activationCount_++;
         
-        if (activationCount_ >= config_.triggerLevel) {
-            // Trigger level reached - output detection
-            {
-                std::unique_lock<std::mutex> lock(outputMutex);
-                
-                if (outputMode == OutputMode::JSON) {
-                    // JSON output
-                    std::cout << "{";
-                    std::cout << "\"wake_word\":\"" << wakeWord_ << "\"";
-                    std::cout << ",\"score\":" << probability;
-                    if (showTimestamp) {
-                        auto now = std::chrono::system_clock::now();
-                        auto time_t = std::chrono::system_clock::to_time_t(now);
-                        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                            now.time_since_epoch()) % 1000;
-                        
-                        std::stringstream ss;
-                        ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-                        ss << "." << std::setfill('0') << std::setw(3) << ms.count();
-                        
-                        std::cout << ",\"timestamp\":\"" << ss.str() << "\"";
-                    }
-                    std::cout << "}" << std::endl;
-                } else {
-                    // Normal output
-                    if (showTimestamp) {
-                        auto now = std::chrono::system_clock::now();
-                        auto time_t = std::chrono::system_clock::to_time_t(now);
-                        std::cout << "[" << std::put_time(std::localtime(&time_t), "%H:%M:%S") << "] ";
-                    }
-                    std::cout << wakeWord_ << std::endl;
-                }
-            }
-            
-            // Enter refractory period
-            activationCount_ = -config_.refractorySteps;
+        if (activationCount_ >= triggerLevel_) {
+            // Enter refractory period, unless a postprocessor decides first
+            activationCount_ = deferRefractory_ ? triggerLevel_ - 1 : -refractorySteps_;
+            return true;
         }
     } else {
         // No activation - decay activation count
@@ -94,6 +182,45 @@ void WakeWordDetector::processPrediction(float probability, std::mutex& outputMu
             activationCount_ = std::min(0, activationCount_ + 1);
         }
     }
+    return false;
+}
+
+void printDetection(const std::string& wakeWord, float probability,
+                    OutputMode outputMode, bool showTimestamp,
+                    const std::string& source) {
+    if (outputMode == OutputMode::JSON) {
+        // JSON output
+        std::cout << "{";
+        if (!source.empty()) {
+            std::cout << "\"stream\":\"" << source << "\",";
+        }
+        std::cout << "\"wake_word\":\"" << wakeWord << "\"";
+        std::cout << ",\"score\":" << probability;
+        if (showTimestamp) {
+            auto now = std::chrono::system_clock::now();
+            auto time_t = std::chrono::system_clock::to_time_t(now);
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                now.time_since_epoch()) % 1000;
+            
+            std::stringstream ss;
+            ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
+            ss << "." << std::setfill('0') << std::setw(3) << ms.count();
+            
+            std::cout << ",\"timestamp\":\"" << ss.str() << "\"";
+        }
+        std::cout << "}" << '\n';
+    } else {
+        // Normal output
+        if (showTimestamp) {
+            auto now = std::chrono::system_clock::now();
+            auto time_t = std::chrono::system_clock::to_time_t(now);
+            std::cout << "[" << std::put_time(std::localtime(&time_t), "%H:%M:%S") << "] ";
+        }
+        if (!source.empty()) {
+            std::cout << source << " ";
+        }
+        std::cout << wakeWord << '\n';
+    }
 }
 
 } // namespace openwakeword
\ No newline at end of file
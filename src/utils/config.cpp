@@ -1,9 +1,13 @@
 #include "utils/config.h"
+#include "processors/audio_converter.h"
 #include "processors/wake_word_detector.h"
+#include "utils/kernels.h"
+#include "utils/thread_affinity.h"
 #include <iostream>
 #include <cstdlib>
 #include <filesystem>
 #include <algorithm>
+#include <charconv>
 #include <iomanip>
 #include <fstream>
 #include <sstream>
@@ -11,6 +15,161 @@
 
 namespace openwakeword {
 
+namespace {
+
+bool parseGraphOptimization(const std::string& text, GraphOptimization& level) {
+    if (text == "disable" || text == "none") level = GraphOptimization::DISABLED;
+    else if (text == "basic") level = GraphOptimization::BASIC;
+    else if (text == "extended") level = GraphOptimization::EXTENDED;
+    else if (text == "all") level = GraphOptimization::ALL;
+    else return false;
+    return true;
+}
+
+const char* graphOptimizationName(GraphOptimization level) {
+    switch (level) {
+        case GraphOptimization::DISABLED: return "disable";
+        case GraphOptimization::BASIC: return "basic";
+        case GraphOptimization::EXTENDED: return "extended";
+        case GraphOptimization::ALL: break;
+    }
+    return "all";
+}
+
+bool parseModelPrecision(const std::string& text, ModelPrecision& precision) {
+    if (text == "fp32") precision = ModelPrecision::FP32;
+    else if (text == "int8") precision = ModelPrecision::INT8;
+    else if (text == "fp16") precision = ModelPrecision::FP16;
+    else if (text == "auto") precision = ModelPrecision::AUTO;
+    else return false;
+    return true;
+}
+
+const char* modelPrecisionName(ModelPrecision precision) {
+    switch (precision) {
+        case ModelPrecision::FP32: break;
+        case ModelPrecision::INT8: return "int8";
+        case ModelPrecision::FP16: return "fp16";
+        case ModelPrecision::AUTO: return "auto";
+    }
+    return "fp32";
+}
+
+bool parseOverloadPolicy(const std::string& text, OverloadPolicy& policy) {
+    if (text == "block") policy = OverloadPolicy::BLOCK;
+    else if (text == "drop-audio") policy = OverloadPolicy::DROP_AUDIO;
+    else if (text == "skip-steps") policy = OverloadPolicy::SKIP_STEPS;
+    else if (text == "reduce-models") policy = OverloadPolicy::REDUCE_MODELS;
+    else return false;
+    return true;
+}
+
+const char* overloadPolicyName(OverloadPolicy policy) {
+    switch (policy) {
+        case OverloadPolicy::BLOCK: break;
+        case OverloadPolicy::DROP_AUDIO: return "drop-audio";
+        case OverloadPolicy::SKIP_STEPS: return "skip-steps";
+        case OverloadPolicy::REDUCE_MODELS: return "reduce-models";
+    }
+    return "block";
+}
+
+bool parseChannelFusion(const std::string& text, ChannelFusion& fusion) {
+    if (text == "max") fusion = ChannelFusion::MAX;
+    else if (text == "best" || text == "best-channel") fusion = ChannelFusion::BEST_CHANNEL;
+    else return false;
+    return true;
+}
+
+const char* channelFusionName(ChannelFusion fusion) {
+    return fusion == ChannelFusion::BEST_CHANNEL ? "best" : "max";
+}
+
+// Comma-separated execution provider names, validated here and mapped to
+// ONNX Runtime providers when sessions are created
+bool parseProviderList(const std::string& text, std::vector<std::string>& providers) {
+    providers.clear();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        std::string name = item.substr(0, item.find(':'));
+        bool hasDevice = name.size() != item.size();
+        if (name == "cuda" && hasDevice) {
+            // A device id that fits OrtCUDAProviderOptions::device_id
+            const char* device = item.c_str() + name.size() + 1;
+            const char* last = item.c_str() + item.size();
+            int deviceId = -1;
+            auto [end, error] = std::from_chars(device, last, deviceId);
+            if (error != std::errc() || end != last || deviceId < 0) {
+                return false;
+            }
+        } else if (hasDevice || (name != "cpu" && name != "cuda" && name != "xnnpack" &&
+                                 name != "coreml" && name != "nnapi")) {
+            return false;
+        }
+        providers.push_back(item);
+    }
+    return !providers.empty();
+}
+
+std::string formatProviderList(const std::vector<std::string>& providers) {
+    std::string text;
+    for (size_t i = 0; i < providers.size(); ++i) {
+        text += (i > 0 ? "," : "") + providers[i];
+    }
+    return text;
+}
+
+// NAME=LIST for --model-provider
+bool parseModelProvider(const std::string& text,
+                        std::vector<std::pair<std::string, std::vector<std::string>>>& modelProviders) {
+    size_t equals = text.find('=');
+    std::vector<std::string> providers;
+    if (equals == 0 || equals == std::string::npos ||
+        !parseProviderList(text.substr(equals + 1), providers)) {
+        return false;
+    }
+    modelProviders.emplace_back(text.substr(0, equals), std::move(providers));
+    return true;
+}
+
+// A whole non-negative number; a sign or trailing text is rejected
+bool parseCount(const std::string& text, size_t& count) {
+    const char* last = text.c_str() + text.size();
+    size_t value = 0;
+    auto [end, error] = std::from_chars(text.c_str(), last, value);
+    if (error != std::errc() || end != last) {
+        return false;
+    }
+    count = value;
+    return true;
+}
+
+// A whole number, range checked by validate()
+bool parseInteger(const std::string& text, int& number) {
+    const char* last = text.c_str() + text.size();
+    int value = 0;
+    auto [end, error] = std::from_chars(text.c_str(), last, value);
+    if (error != std::errc() || end != last) {
+        return false;
+    }
+    number = value;
+    return true;
+}
+
+// NAME=FILE
+bool parseVerifierModel(const std::string& text,
+                        std::vector<std::pair<std::string, std::filesystem::path>>& verifiers) {
+    size_t equals = text.find('=');
+    if (equals == 0 || equals == std::string::npos || equals + 1 == text.size()) {
+        return false;
+    }
+    verifiers.emplace_back(text.substr(0, equals), text.substr(equals + 1));
+    return true;
+}
+
+} // namespace
+
 ParseResult Config::parseArgs(int argc, char* argv[]) {
     std::string saveConfigPath;
     bool shouldSaveConfig = false;
@@ -33,12 +192,188 @@ ParseResult Config::parseArgs(int argc, char* argv[]) {
         } else if (arg == "--step-frames") {
             if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
             stepFrames = std::atoi(argv[++i]);
+        } else if (arg == "--buffer-ms") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            bufferMilliseconds = std::atoi(argv[++i]);
+        } else if (arg == "--intra-op-threads") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            intraOpNumThreads = std::atoi(argv[++i]);
+        } else if (arg == "--inter-op-threads") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            interOpNumThreads = std::atoi(argv[++i]);
+        } else if (arg == "--global-thread-pool") {
+            globalThreadPool = true;
+        } else if (arg == "--graph-optimization") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            if (!parseGraphOptimization(argv[++i], graphOptimization)) {
+                std::cerr << "[ERROR] Unknown graph optimization level: " << argv[i] << std::endl;
+                return ParseResult::ERROR_EXIT;
+            }
+        } else if (arg == "--parallel-execution") {
+            parallelExecution = true;
+        } else if (arg == "--model-cache") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            modelCacheDir = argv[++i];
+        } else if (arg == "--load-threads") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            loadThreads = std::atoi(argv[++i]);
+        } else if (arg == "--share-models") {
+            shareModels = true;
+        } else if (arg == "--pin-mel" || arg == "--pin-embedding" || arg == "--pin-detectors") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            auto& cpus = arg == "--pin-mel" ? melCpus
+                       : arg == "--pin-embedding" ? embeddingCpus : detectorCpus;
+            if (!parseCpuList(argv[++i], cpus)) {
+                std::cerr << "[ERROR] Invalid CPU list for " << arg << ": " << argv[i] << std::endl;
+                return ParseResult::ERROR_EXIT;
+            }
+        } else if (arg == "--real-time") {
+            realTime = true;
+        } else if (arg == "--deadline-ms") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            deadlineMs = std::atoi(argv[++i]);
+            realTime = true;
+        } else if (arg == "--overload-policy") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            if (!parseOverloadPolicy(argv[++i], overloadPolicy)) {
+                std::cerr << "[ERROR] Unknown overload policy: " << argv[i] << std::endl;
+                return ParseResult::ERROR_EXIT;
+            }
+            realTime = true;
+        } else if (arg == "--overload-models") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            overloadModels = std::atoi(argv[++i]);
+        } else if (arg == "--rt-priority") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            realtimePriority = std::atoi(argv[++i]);
+        } else if (arg == "--spin-wait") {
+            bufferWaitPolicy = WaitPolicy::SPINNING;
+        } else if (arg == "--detector-group") {
+            groupDetectors = true;
+        } else if (arg == "--cascade") {
+            cascade = true;
+            groupDetectors = true;
+        } else if (arg == "--cascade-model") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            cascadeModelPath = argv[++i];
+            cascade = true;
+            groupDetectors = true;
+        } else if (arg == "--cascade-threshold") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            cascadeThreshold = std::atof(argv[++i]);
+        } else if (arg == "--cascade-margin") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            cascadeMargin = std::atof(argv[++i]);
+        } else if (arg == "--cascade-hold") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            cascadeHoldSteps = std::atoi(argv[++i]);
+        } else if (arg == "--stream") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            streamInputs.push_back(argv[++i]);
+        } else if (arg == "--listen-unix") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            listenUnixPath = argv[++i];
+        } else if (arg == "--listen-udp") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            listenUdp = argv[++i];
+        } else if (arg == "--udp-raw") {
+            udpRaw = true;
+        } else if (arg == "--stream-timeout-ms") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            streamTimeoutMs = std::atoi(argv[++i]);
+        } else if (arg == "--max-network-streams") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            maxNetworkStreams = std::atoi(argv[++i]);
+        } else if (arg == "--mic-array") {
+            micArray = true;
+        } else if (arg == "--channel-fusion") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            if (!parseChannelFusion(argv[++i], channelFusion)) {
+                std::cerr << "[ERROR] Unknown channel fusion: " << argv[i] << std::endl;
+                return ParseResult::ERROR_EXIT;
+            }
+            micArray = true;
+        } else if (arg == "--workers") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            if (!parseCount(argv[++i], workerThreads)) {
+                std::cerr << "[ERROR] Invalid worker count: " << argv[i] << std::endl;
+                return ParseResult::ERROR_EXIT;
+            }
+        } else if (arg == "--max-batch") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            if (!parseCount(argv[++i], maxBatchSize)) {
+                std::cerr << "[ERROR] Invalid batch size: " << argv[i] << std::endl;
+                return ParseResult::ERROR_EXIT;
+            }
+        } else if (arg == "--offline") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            offlineInputs.push_back(argv[++i]);
+        } else if (arg == "--file-list") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            offlineFileList = argv[++i];
+        } else if (arg == "--offline-raw") {
+            offlineRaw = true;
+        } else if (arg == "--embedding-cache") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            embeddingCacheDir = argv[++i];
+        } else if (arg == "--embedding-batch") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            if (!parseCount(argv[++i], embeddingBatchSize)) {
+                std::cerr << "[ERROR] Invalid embedding batch size: " << argv[i] << std::endl;
+                return ParseResult::ERROR_EXIT;
+            }
+        } else if (arg == "--batch-wait-us") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            if (!parseCount(argv[++i], batchWaitMicros)) {
+                std::cerr << "[ERROR] Invalid batch wait: " << argv[i] << std::endl;
+                return ParseResult::ERROR_EXIT;
+            }
         } else if (arg == "--melspectrogram-model") {
             if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
             melModelPath = argv[++i];
+        } else if (arg == "--native-mel") {
+            melFrontend = MelFrontendType::NATIVE;
+        } else if (arg == "--streaming-mel") {
+            streamingMel = true;
+        } else if (arg == "--verify-mel") {
+            verifyMel = true;
+        } else if (arg == "--mel-tolerance") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            melTolerance = std::atof(argv[++i]);
         } else if (arg == "--embedding-model") {
             if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
             embModelPath = argv[++i];
+        } else if (arg == "--mel-provider" || arg == "--embedding-provider" ||
+                   arg == "--wakeword-provider") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            auto& providers = arg == "--mel-provider" ? melProviders
+                            : arg == "--embedding-provider" ? embeddingProviders : wakeWordProviders;
+            if (!parseProviderList(argv[++i], providers)) {
+                std::cerr << "[ERROR] Invalid execution provider list for " << arg << ": " << argv[i] << std::endl;
+                return ParseResult::ERROR_EXIT;
+            }
+        } else if (arg == "--model-provider") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            if (!parseModelProvider(argv[++i], modelProviders)) {
+                std::cerr << "[ERROR] Invalid model execution providers (expected NAME=LIST): " << argv[i] << std::endl;
+                return ParseResult::ERROR_EXIT;
+            }
+        } else if (arg == "--verifier") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            if (!parseVerifierModel(argv[++i], customVerifierModels)) {
+                std::cerr << "[ERROR] Invalid custom verifier (expected NAME=FILE): " << argv[i] << std::endl;
+                return ParseResult::ERROR_EXIT;
+            }
+            enableCustomVerifiers = true;
+        } else if (arg == "--verifier-threshold") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            customVerifierThreshold = std::atof(argv[++i]);
+        } else if (arg == "--precision") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            if (!parseModelPrecision(argv[++i], modelPrecision)) {
+                std::cerr << "[ERROR] Unknown model precision: " << argv[i] << std::endl;
+                return ParseResult::ERROR_EXIT;
+            }
         } else if (arg == "--vad-threshold") {
             if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
             vadThreshold = std::atof(argv[++i]);
@@ -47,6 +382,21 @@ ParseResult Config::parseArgs(int argc, char* argv[]) {
             if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
             vadModelPath = argv[++i];
             enableVAD = true;
+        } else if (arg == "--vad-gate") {
+            vadGate = true;
+            enableVAD = true;
+        } else if (arg == "--vad-hangover-ms") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            vadHangoverMs = std::atoi(argv[++i]);
+        } else if (arg == "--input-rate") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            inputSampleRate = std::atoi(argv[++i]);
+        } else if (arg == "--input-channels") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            inputChannels = std::atoi(argv[++i]);
+        } else if (arg == "--input-channel") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            inputChannel = std::atoi(argv[++i]);
         } else if (arg == "--enable-noise-suppression") {
             enableNoiseSuppression = true;
         } else if (arg == "--debug") {
@@ -60,6 +410,18 @@ ParseResult Config::parseArgs(int argc, char* argv[]) {
             outputMode = OutputMode::JSON;
         } else if (arg == "--timestamp") {
             showTimestamp = true;
+        } else if (arg == "--metrics-port") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            if (!parseInteger(argv[++i], metricsPort)) {
+                std::cerr << "[ERROR] Invalid metrics port: " << argv[i] << std::endl;
+                return ParseResult::ERROR_EXIT;
+            }
+        } else if (arg == "--metrics-host") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            metricsHost = argv[++i];
+        } else if (arg == "--stats-interval") {
+            if (!ensureArg(argc, argv, i)) return ParseResult::ERROR_EXIT;
+            statsIntervalSeconds = std::atoi(argv[++i]);
         } else if (arg == "--version") {
             printVersion();
             return ParseResult::INFO_EXIT;
@@ -102,10 +464,12 @@ ParseResult Config::parseArgs(int argc, char* argv[]) {
     // intraOpNumThreads = 1;  // Already set as default
     // interOpNumThreads = 1;  // Already set as default
     
-    // Create per-model configurations if not already specified
+    // Create per-model configurations if not already specified; wake words
+    // are named before their paths move to a precision variant
     if (wakeWordConfigs.empty() && !wakeWordModelPaths.empty()) {
         for (const auto& modelPath : wakeWordModelPaths) {
             WakeWordConfig config;
+            config.name = modelPath.stem().string();
             config.modelPath = modelPath;
             config.threshold = threshold;
             config.triggerLevel = triggerLevel;
@@ -114,6 +478,37 @@ ParseResult Config::parseArgs(int argc, char* argv[]) {
             wakeWordConfigs.push_back(config);
         }
     }
+    selectModelVariants();
+    
+    // Execution providers per wake word; a model's own setting wins
+    for (auto& wwConfig : wakeWordConfigs) {
+        if (wwConfig.providers.empty()) {
+            wwConfig.providers = wakeWordProviders;
+        }
+        for (const auto& [name, providers] : modelProviders) {
+            if (wwConfig.name == name) {
+                wwConfig.providers = providers;
+            }
+        }
+        if (enableCustomVerifiers) {
+            for (const auto& [name, verifier] : customVerifierModels) {
+                if (wwConfig.name == name) {
+                    wwConfig.verifierModelPath = verifier;
+                }
+            }
+        }
+    }
+    if (enableCustomVerifiers) {
+        for (const auto& [name, verifier] : customVerifierModels) {
+            bool matched = std::any_of(wakeWordConfigs.begin(), wakeWordConfigs.end(),
+                                       [&](const WakeWordConfig& wwConfig) { return wwConfig.name == name; });
+            if (!matched) {
+                std::cerr << "[ERROR] Verifier " << verifier << " names no loaded wake word: " << name
+                          << std::endl;
+                return ParseResult::ERROR_EXIT;
+            }
+        }
+    }
     
     return validate() ? ParseResult::SUCCESS : ParseResult::ERROR_EXIT;
 }
@@ -152,15 +547,106 @@ bool Config::loadFromFile(const std::filesystem::path& configPath) {
         // Parse key-value pairs
         if (key == "melspectrogram_model") melModelPath = value;
         else if (key == "embedding_model") embModelPath = value;
+        else if (key == "melProvider" || key == "embeddingProvider" || key == "wakewordProvider") {
+            auto& providers = key == "melProvider" ? melProviders
+                            : key == "embeddingProvider" ? embeddingProviders : wakeWordProviders;
+            if (!parseProviderList(value, providers)) {
+                std::cerr << "[ERROR] Invalid execution provider list for " << key << ": " << value << std::endl;
+                return false;
+            }
+        }
+        else if (key == "verifier") {
+            if (!parseVerifierModel(value, customVerifierModels)) {
+                std::cerr << "[ERROR] Invalid custom verifier (expected NAME=FILE): " << value << std::endl;
+                return false;
+            }
+            enableCustomVerifiers = true;
+        }
+        else if (key == "verifierThreshold") customVerifierThreshold = std::stof(value);
+        else if (key == "modelProvider") {
+            if (!parseModelProvider(value, modelProviders)) {
+                std::cerr << "[ERROR] Invalid model execution providers (expected NAME=LIST): " << value << std::endl;
+                return false;
+            }
+        }
+        else if (key == "precision") {
+            if (!parseModelPrecision(value, modelPrecision)) {
+                std::cerr << "[ERROR] Unknown model precision: " << value << std::endl;
+                return false;
+            }
+        }
+        else if (key == "nativeMel") {
+            melFrontend = (value == "true" || value == "1") ? MelFrontendType::NATIVE : MelFrontendType::ONNX;
+        }
+        else if (key == "streamingMel") streamingMel = (value == "true" || value == "1");
+        else if (key == "verifyMel") verifyMel = (value == "true" || value == "1");
+        else if (key == "melTolerance") melTolerance = std::stof(value);
         else if (key == "model") wakeWordModelPaths.push_back(value);
         else if (key == "threshold") threshold = std::stof(value);
         else if (key == "trigger_level") triggerLevel = std::stoi(value);
         else if (key == "refractory") refractorySteps = std::stoi(value);
         else if (key == "stepFrames") stepFrames = std::stoi(value);
+        else if (key == "bufferMs") bufferMilliseconds = std::stoi(value);
+        else if (key == "realTime") realTime = (value == "true" || value == "1");
+        else if (key == "deadlineMs") deadlineMs = std::stoul(value);
+        else if (key == "overloadPolicy") {
+            if (!parseOverloadPolicy(value, overloadPolicy)) {
+                std::cerr << "[ERROR] Unknown overload policy: " << value << std::endl;
+                return false;
+            }
+        }
+        else if (key == "overloadModels") overloadModels = std::stoul(value);
+        else if (key == "rtPriority") realtimePriority = std::stoi(value);
+        else if (key == "spinWait") {
+            bufferWaitPolicy = (value == "true" || value == "1") ? WaitPolicy::SPINNING : WaitPolicy::BLOCKING;
+        }
+        else if (key == "detectorGroup") groupDetectors = (value == "true" || value == "1");
+        else if (key == "cascade") {
+            cascade = (value == "true" || value == "1");
+            groupDetectors = groupDetectors || cascade;
+        }
+        else if (key == "cascadeModel") cascadeModelPath = value;
+        else if (key == "cascadeThreshold") cascadeThreshold = std::stof(value);
+        else if (key == "cascadeMargin") cascadeMargin = std::stof(value);
+        else if (key == "cascadeHold") cascadeHoldSteps = std::stoul(value);
+        else if (key == "stream") streamInputs.push_back(value);
+        else if (key == "listenUnix") listenUnixPath = value;
+        else if (key == "listenUdp") listenUdp = value;
+        else if (key == "udpRaw") udpRaw = (value == "true" || value == "1");
+        else if (key == "streamTimeoutMs") streamTimeoutMs = std::stoul(value);
+        else if (key == "maxNetworkStreams") maxNetworkStreams = std::stoul(value);
+        else if (key == "micArray") micArray = (value == "true" || value == "1");
+        else if (key == "channelFusion") {
+            if (!parseChannelFusion(value, channelFusion)) {
+                std::cerr << "[ERROR] Unknown channel fusion: " << value << std::endl;
+                return false;
+            }
+        }
+        else if (key == "workers" || key == "maxBatch") {
+            if (!parseCount(value, key == "workers" ? workerThreads : maxBatchSize)) {
+                std::cerr << "[ERROR] Invalid value for " << key << ": " << value << std::endl;
+                return false;
+            }
+        }
+        else if (key == "offline") offlineInputs.push_back(value);
+        else if (key == "fileList") offlineFileList = value;
+        else if (key == "offlineRaw") offlineRaw = (value == "true" || value == "1");
+        else if (key == "embeddingCache") embeddingCacheDir = value;
+        else if (key == "embeddingBatch" || key == "batchWaitUs") {
+            if (!parseCount(value, key == "embeddingBatch" ? embeddingBatchSize : batchWaitMicros)) {
+                std::cerr << "[ERROR] Invalid value for " << key << ": " << value << std::endl;
+                return false;
+            }
+        }
         else if (key == "debug") debug = (value == "true" || value == "1");
         else if (key == "enableVAD") enableVAD = (value == "true" || value == "1");
         else if (key == "vadThreshold") vadThreshold = std::stof(value);
         else if (key == "vadModelPath") vadModelPath = value;
+        else if (key == "vadGate") vadGate = (value == "true" || value == "1");
+        else if (key == "vadHangoverMs") vadHangoverMs = std::stoul(value);
+        else if (key == "inputRate") inputSampleRate = std::stoul(value);
+        else if (key == "inputChannels") inputChannels = std::stoul(value);
+        else if (key == "inputChannel") inputChannel = std::stoi(value);
         else if (key == "noise_suppression") enableNoiseSuppression = (value == "true" || value == "1");
         else if (key == "quiet") {
             if (value == "true" || value == "1") outputMode = OutputMode::QUIET;
@@ -175,8 +661,34 @@ bool Config::loadFromFile(const std::filesystem::path& configPath) {
             }
         }
         else if (key == "timestamp") showTimestamp = (value == "true" || value == "1");
+        else if (key == "metricsPort") {
+            if (!parseInteger(value, metricsPort)) {
+                std::cerr << "[ERROR] Invalid metrics port: " << value << std::endl;
+                return false;
+            }
+        }
+        else if (key == "metricsHost") metricsHost = value;
+        else if (key == "statsInterval") statsIntervalSeconds = std::stoul(value);
         else if (key == "intraOpNumThreads") intraOpNumThreads = std::stoi(value);
         else if (key == "interOpNumThreads") interOpNumThreads = std::stoi(value);
+        else if (key == "globalThreadPool") globalThreadPool = (value == "true" || value == "1");
+        else if (key == "graphOptimization") {
+            if (!parseGraphOptimization(value, graphOptimization)) {
+                std::cerr << "[ERROR] Unknown graph optimization level: " << value << std::endl;
+                return false;
+            }
+        }
+        else if (key == "parallelExecution") parallelExecution = (value == "true" || value == "1");
+        else if (key == "modelCache") modelCacheDir = value;
+        else if (key == "loadThreads") loadThreads = std::stoul(value);
+        else if (key == "shareModels") shareModels = (value == "true" || value == "1");
+        else if (key == "pinMel" || key == "pinEmbedding" || key == "pinDetectors") {
+            auto& cpus = key == "pinMel" ? melCpus : key == "pinEmbedding" ? embeddingCpus : detectorCpus;
+            if (!parseCpuList(value, cpus)) {
+                std::cerr << "[ERROR] Invalid CPU list for " << key << ": " << value << std::endl;
+                return false;
+            }
+        }
     }
     
     return true;
@@ -188,7 +700,9 @@ bool Config::validate() const {
         return false;
     }
     
-    if (!std::filesystem::exists(melModelPath)) {
+    // The native frontend needs the model only to verify against it
+    bool needMelModel = melFrontend == MelFrontendType::ONNX || verifyMel;
+    if (needMelModel && !std::filesystem::exists(melModelPath)) {
         std::cerr << "[ERROR] Mel spectrogram model not found: " << melModelPath << std::endl;
         return false;
     }
@@ -220,6 +734,113 @@ bool Config::validate() const {
         return false;
     }
     
+    if (!cascadeModelPath.empty() && !std::filesystem::exists(cascadeModelPath)) {
+        std::cerr << "[ERROR] Cascade model not found: " << cascadeModelPath << std::endl;
+        return false;
+    }
+    
+    for (const auto& [name, verifier] : customVerifierModels) {
+        if (!std::filesystem::exists(verifier)) {
+            std::cerr << "[ERROR] Custom verifier model not found: " << verifier << std::endl;
+            return false;
+        }
+    }
+    
+    if (customVerifierThreshold < 0.0f || customVerifierThreshold > 1.0f) {
+        std::cerr << "[ERROR] Custom verifier threshold must be between 0 and 1" << std::endl;
+        return false;
+    }
+    
+    if (cascadeMargin < 0.0f || cascadeMargin > 1.0f) {
+        std::cerr << "[ERROR] Cascade margin must be between 0 and 1" << std::endl;
+        return false;
+    }
+    
+    if (cascadeThreshold < 0.0f || cascadeThreshold > 1.0f) {
+        std::cerr << "[ERROR] Cascade threshold must be between 0 and 1" << std::endl;
+        return false;
+    }
+    
+    // Woken models would never run, losing every detection
+    if (cascade && cascadeHoldSteps < 1) {
+        std::cerr << "[ERROR] Cascade hold must be at least 1 window" << std::endl;
+        return false;
+    }
+    
+    if (!AudioConverter::isSupportedRate(inputSampleRate)) {
+        std::cerr << "[ERROR] Unsupported input sample rate: " << inputSampleRate << std::endl;
+        return false;
+    }
+    
+    if (inputChannels == 0 || inputChannels > AudioConverter::MAX_CHANNELS) {
+        std::cerr << "[ERROR] Input channels must be between 1 and " << AudioConverter::MAX_CHANNELS << std::endl;
+        return false;
+    }
+    
+    if (inputChannel >= static_cast<int>(inputChannels)) {
+        std::cerr << "[ERROR] Input channel " << inputChannel << " out of range for "
+                  << inputChannels << " channel(s)" << std::endl;
+        return false;
+    }
+    
+    if (micArray && (inputChannels < 2 || inputChannel >= 0)) {
+        std::cerr << "[ERROR] Mic array mode needs --input-channels of 2 or more and no --input-channel"
+                  << std::endl;
+        return false;
+    }
+    
+    if (vadGate && !enableVAD) {
+        std::cerr << "[ERROR] VAD gating requires VAD to be enabled" << std::endl;
+        return false;
+    }
+    
+    if (intraOpNumThreads < 0 || interOpNumThreads < 0) {
+        std::cerr << "[ERROR] ONNX Runtime thread counts must not be negative" << std::endl;
+        return false;
+    }
+    
+    if (metricsPort < 0 || metricsPort > 65535) {
+        std::cerr << "[ERROR] Metrics port must be between 1 and 65535: " << metricsPort << std::endl;
+        return false;
+    }
+    
+    if (workerThreads == 0 || maxBatchSize == 0 || embeddingBatchSize == 0) {
+        std::cerr << "[ERROR] Worker and batch counts must be at least 1" << std::endl;
+        return false;
+    }
+    
+    if (micArray && inputChannels > maxBatchSize) {
+        std::cerr << "[ERROR] Mic array of " << inputChannels << " channels exceeds the maximum batch size ("
+                  << maxBatchSize << ")" << std::endl;
+        return false;
+    }
+    
+    if (!listenUdp.empty() && streamTimeoutMs == 0) {
+        std::cerr << "[ERROR] Stream timeout must be at least 1 ms" << std::endl;
+        return false;
+    }
+    
+    if ((!listenUnixPath.empty() || !listenUdp.empty()) && maxNetworkStreams == 0) {
+        std::cerr << "[ERROR] Network stream limit must be at least 1" << std::endl;
+        return false;
+    }
+    
+    if (realTime && deadlineMs < 80) {
+        std::cerr << "[ERROR] Deadline must be at least one step (80 ms)" << std::endl;
+        return false;
+    }
+    
+    if (realtimePriority < 0 || realtimePriority > 99) {
+        std::cerr << "[ERROR] Real-time priority must be between 0 and 99" << std::endl;
+        return false;
+    }
+    
+    if (bufferMilliseconds < 80 * stepFrames) {
+        std::cerr << "[ERROR] Buffer must hold at least one step (" 
+                  << 80 * stepFrames << " ms)" << std::endl;
+        return false;
+    }
+    
     return true;
 }
 
@@ -244,12 +865,102 @@ void Config::printUsage(const char* programName) {
     std::cerr << "  -r, --refractory NUM          Steps to wait after activation (default: 20)" << std::endl;
     std::cerr << "  --melspectrogram-model FILE   Path to mel spectrogram model" << std::endl;
     std::cerr << "  --embedding-model FILE        Path to speech embedding model" << std::endl;
+    std::cerr << "  --precision MODE              fp32, int8, fp16 or auto: use the <model>_int8.onnx or" << std::endl;
+    std::cerr << "                                <model>_fp16.onnx embedding and wake word variants" << std::endl;
+    std::cerr << "                                when present (default: fp32)" << std::endl;
+    std::cerr << "  --verifier NAME=FILE          Confirm detections of wake word NAME with a custom" << std::endl;
+    std::cerr << "                                verifier model (can be repeated)" << std::endl;
+    std::cerr << "  --verifier-threshold NUM      Score at which verified wake words become candidates" << std::endl;
+    std::cerr << "                                for their verifier (default: 0.1)" << std::endl;
+    std::cerr << "  --native-mel                  Compute mel spectrograms natively instead of with" << std::endl;
+    std::cerr << "                                the mel spectrogram model" << std::endl;
+    std::cerr << "  --streaming-mel               Keep STFT context across chunks and emit mels every" << std::endl;
+    std::cerr << "                                80 ms, whatever the step size" << std::endl;
+    std::cerr << "  --verify-mel                  Check the native mel frontend against the model at startup" << std::endl;
+    std::cerr << "  --mel-tolerance NUM           Maximum allowed difference for --verify-mel (default: 0.001)" << std::endl;
+    std::cerr << "  --detector-group              Run all models from one thread; multi-output" << std::endl;
+    std::cerr << "                                models score one wake word per output" << std::endl;
+    std::cerr << "  --cascade                     Run wake word models only when a cheap first stage" << std::endl;
+    std::cerr << "                                or their recent scores are near a detection" << std::endl;
+    std::cerr << "                                (implies --detector-group)" << std::endl;
+    std::cerr << "  --cascade-model FILE          First-stage model (default: embedding distance check)" << std::endl;
+    std::cerr << "  --cascade-threshold NUM       First-stage score or distance that wakes the models" << std::endl;
+    std::cerr << "                                (default: 0.1)" << std::endl;
+    std::cerr << "  --cascade-margin NUM          Fraction of a model's threshold that keeps it running" << std::endl;
+    std::cerr << "                                (default: 0.5)" << std::endl;
+    std::cerr << "  --cascade-hold NUM            Windows models keep running once woken (default: 8)" << std::endl;
     std::cerr << std::endl;
     std::cerr << "AUDIO PROCESSING:" << std::endl;
+    std::cerr << "  --input-rate HZ               Input sample rate, resampled to 16 kHz (default: 16000)" << std::endl;
+    std::cerr << "  --input-channels NUM          Interleaved input channels, 1-8 (default: 1)" << std::endl;
+    std::cerr << "  --input-channel NUM           Use only this channel (from 0) instead of averaging all" << std::endl;
     std::cerr << "  --enable-noise-suppression    Enable Speex noise suppression" << std::endl;
     std::cerr << "  --vad-threshold NUM           Enable VAD with threshold (0-1)" << std::endl;
     std::cerr << "  --vad-model FILE              Path to VAD model" << std::endl;
+    std::cerr << "  --vad-gate                    Skip embedding and wake word inference when there" << std::endl;
+    std::cerr << "                                has been no recent speech (enables VAD)" << std::endl;
+    std::cerr << "  --vad-hangover-ms NUM         Time the gate stays open after speech (default: 2000)" << std::endl;
     std::cerr << "  --step-frames NUM             Audio chunks to process at once (default: 4)" << std::endl;
+    std::cerr << "  --buffer-ms NUM               Audio held between stages (default: 2000)" << std::endl;
+    std::cerr << "  --spin-wait                   Busy-wait between stages for lower latency" << std::endl;
+    std::cerr << "  --real-time                   Time wake word steps against a deadline from their" << std::endl;
+    std::cerr << "                                audio's arrival" << std::endl;
+    std::cerr << "  --deadline-ms NUM             Step deadline (default: 200; implies --real-time)" << std::endl;
+    std::cerr << "  --overload-policy POLICY      What to give up once a deadline's worth behind: block," << std::endl;
+    std::cerr << "                                drop-audio, skip-steps or reduce-models (default: block;" << std::endl;
+    std::cerr << "                                implies --real-time)" << std::endl;
+    std::cerr << "  --overload-models NUM         Wake words kept running by reduce-models, in order" << std::endl;
+    std::cerr << "                                (default: 1)" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "PERFORMANCE OPTIONS:" << std::endl;
+    std::cerr << "  --intra-op-threads NUM        ONNX Runtime threads per operator (default: 1;" << std::endl;
+    std::cerr << "                                0 lets ONNX Runtime choose)" << std::endl;
+    std::cerr << "  --inter-op-threads NUM        ONNX Runtime threads across operators (default: 1)" << std::endl;
+    std::cerr << "  --global-thread-pool          Run every session on shared process-wide thread pools" << std::endl;
+    std::cerr << "  --graph-optimization LEVEL    disable, basic, extended or all (default: all)" << std::endl;
+    std::cerr << "  --parallel-execution          Run independent graph nodes in parallel" << std::endl;
+    std::cerr << "  --model-cache DIR             Save optimized models to DIR and reuse them at startup" << std::endl;
+    std::cerr << "  --load-threads NUM            Models loaded in parallel (default: 0, one per CPU)" << std::endl;
+    std::cerr << "  --share-models                Share one memory-mapped session per model file" << std::endl;
+    std::cerr << "                                between all pipelines in the process" << std::endl;
+    std::cerr << "  --mel-provider LIST           Execution providers for the mel model, by preference:" << std::endl;
+    std::cerr << "                                cuda[:DEVICE], xnnpack, coreml, nnapi or cpu; the CPU" << std::endl;
+    std::cerr << "                                runs what they cannot (default: cpu)" << std::endl;
+    std::cerr << "  --embedding-provider LIST     Execution providers for the embedding model" << std::endl;
+    std::cerr << "  --wakeword-provider LIST      Execution providers for the wake word models" << std::endl;
+    std::cerr << "  --model-provider NAME=LIST    Execution providers for one wake word model" << std::endl;
+    std::cerr << "  --pin-mel CPUS                Pin the mel thread to CPUs, e.g. 4 or 4-7 or 4,6" << std::endl;
+    std::cerr << "  --pin-embedding CPUS          Pin the embedding thread to CPUs" << std::endl;
+    std::cerr << "  --pin-detectors CPUS          Spread the detector threads across CPUs" << std::endl;
+    std::cerr << "  --rt-priority NUM             Run the stage threads under SCHED_FIFO at priority" << std::endl;
+    std::cerr << "                                NUM (1-99; needs the privilege to do so)" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "MULTI-STREAM OPTIONS:" << std::endl;
+    std::cerr << "  --stream FILE                 Raw 16 kHz PCM input (file, FIFO or -), repeatable;" << std::endl;
+    std::cerr << "                                all streams share one set of models" << std::endl;
+    std::cerr << "  --listen-unix PATH            Accept raw PCM streams on a Unix socket, one per connection" << std::endl;
+    std::cerr << "  --listen-udp [HOST:]PORT      Receive RTP/L16 audio, one stream per sender and SSRC" << std::endl;
+    std::cerr << "                                (binds 127.0.0.1 unless HOST is given)" << std::endl;
+    std::cerr << "  --udp-raw                     UDP datagrams are raw little-endian PCM, one stream per sender" << std::endl;
+    std::cerr << "  --stream-timeout-ms NUM       Close UDP streams silent this long (default: 5000)" << std::endl;
+    std::cerr << "  --max-network-streams NUM     Refuse connections and UDP sources beyond NUM (default: 64)" << std::endl;
+    std::cerr << "  --mic-array                   Detect on every --input-channels channel of each input," << std::endl;
+    std::cerr << "                                batched together; stdin is used without --stream" << std::endl;
+    std::cerr << "  --channel-fusion MODE         Combine channel scores by max (per wake word) or best" << std::endl;
+    std::cerr << "                                (one channel for all wake words) (default: max)" << std::endl;
+    std::cerr << "  --workers NUM                 Worker threads serving streams (default: 1)" << std::endl;
+    std::cerr << "  --max-batch NUM               Maximum batch size per inference call (default: 16)" << std::endl;
+    std::cerr << "  --embedding-batch NUM         Maximum embedding windows batched across streams (default: 32)" << std::endl;
+    std::cerr << "  --batch-wait-us NUM           Longest wait for a fuller embedding batch (default: 1000)" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "OFFLINE OPTIONS:" << std::endl;
+    std::cerr << "  --offline PATH                Score a 16 kHz mono WAV/PCM file or a directory of them," << std::endl;
+    std::cerr << "                                faster than real time (repeatable); uses --workers" << std::endl;
+    std::cerr << "  --file-list FILE              Text file listing one WAV path per line" << std::endl;
+    std::cerr << "  --offline-raw                 Read files without a WAV header as 16 kHz mono PCM" << std::endl;
+    std::cerr << "                                (otherwise only .raw and .pcm files are)" << std::endl;
+    std::cerr << "  --embedding-cache DIR         Store each file's speech embeddings in DIR and rescore" << std::endl;
+    std::cerr << "                                from them on later runs, skipping mel and embedding" << std::endl;
     std::cerr << std::endl;
     std::cerr << "OUTPUT OPTIONS:" << std::endl;
     std::cerr << "  --quiet                       Suppress all output except detections" << std::endl;
@@ -258,6 +969,12 @@ void Config::printUsage(const char* programName) {
     std::cerr << "  --timestamp                   Include timestamps with detections" << std::endl;
     std::cerr << "  --debug                       Print model probabilities to stderr" << std::endl;
     std::cerr << std::endl;
+    std::cerr << "MONITORING OPTIONS:" << std::endl;
+    std::cerr << "  --metrics-port PORT           Serve Prometheus metrics (per-stage latency, queue depths," << std::endl;
+    std::cerr << "                                real-time factor) over HTTP on PORT" << std::endl;
+    std::cerr << "  --metrics-host HOST           Address the metrics endpoint binds (default: 127.0.0.1)" << std::endl;
+    std::cerr << "  --stats-interval SECS         Print a JSON stats line to stderr every SECS seconds" << std::endl;
+    std::cerr << std::endl;
     std::cerr << "EXAMPLES:" << std::endl;
     std::cerr << "  # Basic usage with single model" << std::endl;
     std::cerr << "  arecord -r 16000 -c 1 -f S16_LE -t raw - | " << programName << " --model models/alexa_v0.1.onnx" << std::endl;
@@ -267,6 +984,63 @@ void Config::printUsage(const char* programName) {
     std::cerr << "    --model models/alexa_v0.1.onnx --model models/hey_jarvis_v0.1.onnx \\" << std::endl;
     std::cerr << "    --enable-noise-suppression --threshold 0.6" << std::endl;
     std::cerr << std::endl;
+    std::cerr << "  # Re-score a directory of recordings on 8 cores" << std::endl;
+    std::cerr << "  " << programName << " --model models/alexa_v0.1.onnx --offline recordings/ --workers 8 --json" << std::endl;
+    std::cerr << std::endl;
+}
+
+std::filesystem::path Config::modelVariant(const std::filesystem::path& model,
+                                           ModelPrecision precision) {
+    if (precision == ModelPrecision::FP32 || precision == ModelPrecision::AUTO) {
+        return model;
+    }
+    std::string suffix = std::string("_") + modelPrecisionName(precision);
+    std::string stem = model.stem().string();
+    if (stem.size() >= suffix.size() && stem.compare(stem.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        // Already the variant
+        return model;
+    }
+    return model.parent_path() / (stem + suffix + model.extension().string());
+}
+
+void Config::selectModelVariants() {
+    if (modelPrecision == ModelPrecision::FP32) {
+        return;
+    }
+    
+    auto select = [this](std::filesystem::path& model) {
+        std::vector<ModelPrecision> candidates = {modelPrecision};
+        if (modelPrecision == ModelPrecision::AUTO) {
+            candidates = {ModelPrecision::INT8};
+            if (kernels::hasNativeHalfArithmetic()) {
+                candidates.push_back(ModelPrecision::FP16);
+            }
+        }
+        
+        for (auto precision : candidates) {
+            auto variant = modelVariant(model, precision);
+            if (std::filesystem::exists(variant)) {
+                if (variant != model && outputMode == OutputMode::VERBOSE) {
+                    std::cerr << "[LOG] Using " << modelPrecisionName(precision) << " model: "
+                              << variant << std::endl;
+                }
+                model = variant;
+                return;
+            }
+        }
+        if (modelPrecision != ModelPrecision::AUTO && outputMode != OutputMode::QUIET) {
+            std::cerr << "[WARNING] No " << modelPrecisionName(modelPrecision) << " variant of "
+                      << model << ", using it as is" << std::endl;
+        }
+    };
+    
+    select(embModelPath);
+    for (auto& model : wakeWordModelPaths) {
+        select(model);
+    }
+    for (auto& wwConfig : wakeWordConfigs) {
+        select(wwConfig.modelPath);
+    }
 }
 
 bool Config::ensureArg(int argc, char* argv[], int& index) {
@@ -296,6 +1070,7 @@ void Config::printVersion() {
             "unknown"
         #endif
         << std::endl;
+    std::cout << "  SIMD kernels: " << kernels::activeKernelSet() << std::endl;
     
     // Feature availability
     std::cout << std::endl;
@@ -379,6 +1154,57 @@ bool Config::saveToFile(const std::filesystem::path& configPath) const {
     file << "trigger_level=" << triggerLevel << std::endl;
     file << "refractory=" << refractorySteps << std::endl;
     file << "step_frames=" << (frameSize / CHUNK_SAMPLES) << std::endl;
+    file << "bufferMs=" << bufferMilliseconds << std::endl;
+    file << "spinWait=" << (bufferWaitPolicy == WaitPolicy::SPINNING ? "true" : "false") << std::endl;
+    if (realTime) {
+        file << "realTime=true" << std::endl;
+        file << "deadlineMs=" << deadlineMs << std::endl;
+        file << "overloadPolicy=" << overloadPolicyName(overloadPolicy) << std::endl;
+        file << "overloadModels=" << overloadModels << std::endl;
+    }
+    if (enableCustomVerifiers) {
+        for (const auto& [name, verifier] : customVerifierModels) {
+            file << "verifier=" << name << "=" << verifier.string() << std::endl;
+        }
+        file << "verifierThreshold=" << customVerifierThreshold << std::endl;
+    }
+    file << std::endl;
+    
+    file << "# ONNX Runtime and threading" << std::endl;
+    file << "intraOpNumThreads=" << intraOpNumThreads << std::endl;
+    file << "interOpNumThreads=" << interOpNumThreads << std::endl;
+    file << "globalThreadPool=" << (globalThreadPool ? "true" : "false") << std::endl;
+    file << "graphOptimization=" << graphOptimizationName(graphOptimization) << std::endl;
+    file << "parallelExecution=" << (parallelExecution ? "true" : "false") << std::endl;
+    if (!modelCacheDir.empty()) {
+        file << "modelCache=" << modelCacheDir.string() << std::endl;
+    }
+    file << "loadThreads=" << loadThreads << std::endl;
+    file << "shareModels=" << (shareModels ? "true" : "false") << std::endl;
+    if (!melProviders.empty()) {
+        file << "melProvider=" << formatProviderList(melProviders) << std::endl;
+    }
+    if (!embeddingProviders.empty()) {
+        file << "embeddingProvider=" << formatProviderList(embeddingProviders) << std::endl;
+    }
+    if (!wakeWordProviders.empty()) {
+        file << "wakewordProvider=" << formatProviderList(wakeWordProviders) << std::endl;
+    }
+    for (const auto& [name, providers] : modelProviders) {
+        file << "modelProvider=" << name << "=" << formatProviderList(providers) << std::endl;
+    }
+    if (!melCpus.empty()) {
+        file << "pinMel=" << formatCpuList(melCpus) << std::endl;
+    }
+    if (!embeddingCpus.empty()) {
+        file << "pinEmbedding=" << formatCpuList(embeddingCpus) << std::endl;
+    }
+    if (!detectorCpus.empty()) {
+        file << "pinDetectors=" << formatCpuList(detectorCpus) << std::endl;
+    }
+    if (realtimePriority > 0) {
+        file << "rtPriority=" << realtimePriority << std::endl;
+    }
     file << std::endl;
     
     file << "# Models" << std::endl;
@@ -387,22 +1213,89 @@ bool Config::saveToFile(const std::filesystem::path& configPath) const {
     }
     file << "melspectrogram_model=" << melModelPath.string() << std::endl;
     file << "embedding_model=" << embModelPath.string() << std::endl;
+    file << "nativeMel=" << (melFrontend == MelFrontendType::NATIVE ? "true" : "false") << std::endl;
+    file << "streamingMel=" << (streamingMel ? "true" : "false") << std::endl;
+    file << "verifyMel=" << (verifyMel ? "true" : "false") << std::endl;
+    file << "melTolerance=" << melTolerance << std::endl;
+    file << "detectorGroup=" << (groupDetectors ? "true" : "false") << std::endl;
+    if (cascade) {
+        file << "cascade=true" << std::endl;
+        if (!cascadeModelPath.empty()) {
+            file << "cascadeModel=" << cascadeModelPath.string() << std::endl;
+        }
+        file << "cascadeThreshold=" << cascadeThreshold << std::endl;
+        file << "cascadeMargin=" << cascadeMargin << std::endl;
+        file << "cascadeHold=" << cascadeHoldSteps << std::endl;
+    }
     file << std::endl;
     
     file << "# Audio processing" << std::endl;
+    file << "inputRate=" << inputSampleRate << std::endl;
+    file << "inputChannels=" << inputChannels << std::endl;
+    if (inputChannel >= 0) {
+        file << "inputChannel=" << inputChannel << std::endl;
+    }
     if (enableVAD) {
         file << "vad_threshold=" << vadThreshold << std::endl;
         file << "vad_model=" << vadModelPath.string() << std::endl;
+        file << "vadGate=" << (vadGate ? "true" : "false") << std::endl;
+        file << "vadHangoverMs=" << vadHangoverMs << std::endl;
     }
     file << "noise_suppression=" << (enableNoiseSuppression ? "true" : "false") << std::endl;
     file << std::endl;
     
+    file << "# Multi-stream" << std::endl;
+    for (const auto& stream : streamInputs) {
+        file << "stream=" << stream << std::endl;
+    }
+    if (!listenUnixPath.empty()) {
+        file << "listenUnix=" << listenUnixPath.string() << std::endl;
+    }
+    if (!listenUdp.empty()) {
+        file << "listenUdp=" << listenUdp << std::endl;
+        file << "udpRaw=" << (udpRaw ? "true" : "false") << std::endl;
+        file << "streamTimeoutMs=" << streamTimeoutMs << std::endl;
+    }
+    if (!listenUnixPath.empty() || !listenUdp.empty()) {
+        file << "maxNetworkStreams=" << maxNetworkStreams << std::endl;
+    }
+    if (micArray) {
+        file << "micArray=true" << std::endl;
+        file << "channelFusion=" << channelFusionName(channelFusion) << std::endl;
+    }
+    file << "workers=" << workerThreads << std::endl;
+    file << "maxBatch=" << maxBatchSize << std::endl;
+    file << "embeddingBatch=" << embeddingBatchSize << std::endl;
+    file << "batchWaitUs=" << batchWaitMicros << std::endl;
+    file << std::endl;
+    
+    file << "# Offline" << std::endl;
+    for (const auto& input : offlineInputs) {
+        file << "offline=" << input.string() << std::endl;
+    }
+    if (!offlineFileList.empty()) {
+        file << "fileList=" << offlineFileList.string() << std::endl;
+    }
+    if (offlineRaw) {
+        file << "offlineRaw=true" << std::endl;
+    }
+    if (!embeddingCacheDir.empty()) {
+        file << "embeddingCache=" << embeddingCacheDir.string() << std::endl;
+    }
+    file << std::endl;
+    
     file << "# Output" << std::endl;
     file << "debug=" << (debug ? "true" : "false") << std::endl;
     file << "quiet=" << (outputMode == OutputMode::QUIET ? "true" : "false") << std::endl;
     file << "verbose=" << (outputMode == OutputMode::VERBOSE ? "true" : "false") << std::endl;
     file << "json=" << (jsonOutput ? "true" : "false") << std::endl;
     file << "timestamp=" << (showTimestamp ? "true" : "false") << std::endl;
+    file << std::endl;
+    
+    file << "# Monitoring" << std::endl;
+    file << "metricsPort=" << metricsPort << std::endl;
+    file << "metricsHost=" << metricsHost << std::endl;
+    file << "statsInterval=" << statsIntervalSeconds << std::endl;
     
     file.close();
     std::cerr << "[LOG] Configuration saved to " << configPath << std::endl;
@@ -0,0 +1,436 @@
+#include "utils/kernels.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define OWW_KERNELS_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OWW_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+// AVX2 variants are compiled with a target attribute and only called after a
+// runtime CPU check, so the baseline build flags stay unchanged
+#if defined(OWW_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define OWW_KERNELS_AVX2 1
+#define OWW_TARGET_AVX2 __attribute__((target("avx2")))
+#define OWW_TARGET_F16C __attribute__((target("avx,f16c")))
+#endif
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+namespace openwakeword {
+namespace kernels {
+
+namespace {
+
+struct KernelSet {
+    const char* name;
+    void (*convertInt16ToFloat)(const int16_t*, float*, size_t);
+    void (*divideAdd)(const float*, float*, size_t, float, float);
+    void (*multiplyAdd)(const float*, float*, size_t, float, float);
+    float (*dotProduct)(const float*, const float*, size_t);
+    void (*floatToHalf)(const float*, uint16_t*, size_t);
+    void (*halfToFloat)(const uint16_t*, float*, size_t);
+};
+
+// Scalar reference implementations, also used for the tails
+void convertInt16ToFloatScalar(const int16_t* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<float>(in[i]);
+    }
+}
+
+void divideAddScalar(const float* in, float* out, size_t count, float divisor, float offset) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = (in[i] / divisor) + offset;
+    }
+}
+
+void multiplyAddScalar(const float* in, float* out, size_t count, float scale, float offset) {
+    for (size_t i = 0; i < count; ++i) {
+        float scaled = in[i] * scale;
+        out[i] = scaled + offset;
+    }
+}
+
+constexpr size_t DOT_LANES = 8;
+
+// Lane reduction shared by every dotProduct variant
+float reduceLanes(const float* lanes) {
+    return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) +
+           ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+}
+
+float dotProductTail(const float* a, const float* b, size_t count, float sum) {
+    for (size_t i = 0; i < count; ++i) {
+        float product = a[i] * b[i];
+        sum = sum + product;
+    }
+    return sum;
+}
+
+float dotProductScalar(const float* a, const float* b, size_t count) {
+    float lanes[DOT_LANES] = {};
+    size_t i = 0;
+    for (; i + DOT_LANES <= count; i += DOT_LANES) {
+        for (size_t lane = 0; lane < DOT_LANES; ++lane) {
+            float product = a[i + lane] * b[i + lane];
+            lanes[lane] = lanes[lane] + product;
+        }
+    }
+    return dotProductTail(a + i, b + i, count - i, reduceLanes(lanes));
+}
+
+uint16_t floatToHalfValue(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t exponent = (bits >> 23) & 0xffu;
+    uint32_t mantissa = bits & 0x7fffffu;
+    
+    if (exponent == 0xffu) {
+        // Infinity, or NaN with the quiet bit set
+        return static_cast<uint16_t>(sign | 0x7c00u | (mantissa ? 0x200u | (mantissa >> 13) : 0u));
+    }
+    int halfExponent = static_cast<int>(exponent) - 127 + 15;
+    if (halfExponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7c00u);
+    }
+    
+    uint32_t half;
+    uint32_t remainder;
+    uint32_t midpoint;
+    if (halfExponent <= 0) {
+        // Subnormal half, or zero below half the smallest subnormal
+        if (halfExponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+        half = mantissa >> shift;
+        remainder = mantissa & ((1u << shift) - 1);
+        midpoint = 1u << (shift - 1);
+    } else {
+        half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+        remainder = mantissa & 0x1fffu;
+        midpoint = 0x1000u;
+    }
+    // Round to nearest even; a carry correctly rolls into the exponent
+    if (remainder > midpoint || (remainder == midpoint && (half & 1u))) {
+        ++half;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+float halfToFloatValue(uint16_t value) {
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1fu;
+    uint32_t mantissa = value & 0x3ffu;
+    
+    uint32_t bits;
+    if (exponent == 0x1fu) {
+        // Infinity, or NaN quieted like hardware conversions do
+        bits = sign | 0x7f800000u | (mantissa ? 0x400000u | (mantissa << 13) : 0u);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        // Subnormal half: normalize into a float exponent
+        exponent = 113;
+        while (!(mantissa & 0x400u)) {
+            mantissa <<= 1;
+            --exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+    }
+    
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+void floatToHalfScalar(const float* in, uint16_t* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = floatToHalfValue(in[i]);
+    }
+}
+
+void halfToFloatScalar(const uint16_t* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = halfToFloatValue(in[i]);
+    }
+}
+
+#if defined(OWW_KERNELS_X86)
+void convertInt16ToFloatSse2(const int16_t* in, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Sign-extend by placing each value in the high half and shifting down
+        __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+        _mm_storeu_ps(out + i, _mm_cvtepi32_ps(low));
+        _mm_storeu_ps(out + i + 4, _mm_cvtepi32_ps(high));
+    }
+    convertInt16ToFloatScalar(in + i, out + i, count - i);
+}
+
+void divideAddSse2(const float* in, float* out, size_t count, float divisor, float offset) {
+    const __m128 d = _mm_set1_ps(divisor);
+    const __m128 o = _mm_set1_ps(offset);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_div_ps(_mm_loadu_ps(in + i), d), o));
+    }
+    divideAddScalar(in + i, out + i, count - i, divisor, offset);
+}
+
+void multiplyAddSse2(const float* in, float* out, size_t count, float scale, float offset) {
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 o = _mm_set1_ps(offset);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(in + i), s), o));
+    }
+    multiplyAddScalar(in + i, out + i, count - i, scale, offset);
+}
+
+float dotProductSse2(const float* a, const float* b, size_t count) {
+    __m128 low = _mm_setzero_ps();
+    __m128 high = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + DOT_LANES <= count; i += DOT_LANES) {
+        low = _mm_add_ps(low, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        high = _mm_add_ps(high, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    float lanes[DOT_LANES];
+    _mm_storeu_ps(lanes, low);
+    _mm_storeu_ps(lanes + 4, high);
+    return dotProductTail(a + i, b + i, count - i, reduceLanes(lanes));
+}
+#endif
+
+#if defined(OWW_KERNELS_AVX2)
+OWW_TARGET_AVX2
+void convertInt16ToFloatAvx2(const int16_t* in, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+        _mm256_storeu_ps(out + i, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(low)));
+        _mm256_storeu_ps(out + i + 8, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(high)));
+    }
+    convertInt16ToFloatScalar(in + i, out + i, count - i);
+}
+
+OWW_TARGET_AVX2
+void divideAddAvx2(const float* in, float* out, size_t count, float divisor, float offset) {
+    const __m256 d = _mm256_set1_ps(divisor);
+    const __m256 o = _mm256_set1_ps(offset);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_div_ps(_mm256_loadu_ps(in + i), d), o));
+    }
+    divideAddScalar(in + i, out + i, count - i, divisor, offset);
+}
+
+OWW_TARGET_AVX2
+void multiplyAddAvx2(const float* in, float* out, size_t count, float scale, float offset) {
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256 o = _mm256_set1_ps(offset);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // Separate multiply and add (no FMA) to match the scalar rounding
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i), s), o));
+    }
+    multiplyAddScalar(in + i, out + i, count - i, scale, offset);
+}
+
+OWW_TARGET_AVX2
+float dotProductAvx2(const float* a, const float* b, size_t count) {
+    __m256 sum = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + DOT_LANES <= count; i += DOT_LANES) {
+        // No FMA, to match the scalar rounding
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    float lanes[DOT_LANES];
+    _mm256_storeu_ps(lanes, sum);
+    return dotProductTail(a + i, b + i, count - i, reduceLanes(lanes));
+}
+#endif
+
+#if defined(OWW_KERNELS_AVX2)
+OWW_TARGET_F16C
+void floatToHalfF16c(const float* in, uint16_t* out, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), half);
+    }
+    floatToHalfScalar(in + i, out + i, count - i);
+}
+
+OWW_TARGET_F16C
+void halfToFloatF16c(const uint16_t* in, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(half));
+    }
+    halfToFloatScalar(in + i, out + i, count - i);
+}
+#endif
+
+#if defined(OWW_KERNELS_NEON)
+void convertInt16ToFloatNeon(const int16_t* in, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t samples = vld1q_s16(in + i);
+        vst1q_f32(out + i, vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))));
+        vst1q_f32(out + i + 4, vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples))));
+    }
+    convertInt16ToFloatScalar(in + i, out + i, count - i);
+}
+
+void divideAddNeon(const float* in, float* out, size_t count, float divisor, float offset) {
+#if defined(__aarch64__)
+    const float32x4_t d = vdupq_n_f32(divisor);
+    const float32x4_t o = vdupq_n_f32(offset);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vaddq_f32(vdivq_f32(vld1q_f32(in + i), d), o));
+    }
+    divideAddScalar(in + i, out + i, count - i, divisor, offset);
+#else
+    // 32-bit NEON has no exact division
+    divideAddScalar(in, out, count, divisor, offset);
+#endif
+}
+
+void multiplyAddNeon(const float* in, float* out, size_t count, float scale, float offset) {
+    const float32x4_t s = vdupq_n_f32(scale);
+    const float32x4_t o = vdupq_n_f32(offset);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // vmulq/vaddq rather than a fused vmlaq/vfmaq to match the scalar rounding
+        vst1q_f32(out + i, vaddq_f32(vmulq_f32(vld1q_f32(in + i), s), o));
+    }
+    multiplyAddScalar(in + i, out + i, count - i, scale, offset);
+}
+
+float dotProductNeon(const float* a, const float* b, size_t count) {
+    float32x4_t low = vdupq_n_f32(0.0f);
+    float32x4_t high = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + DOT_LANES <= count; i += DOT_LANES) {
+        low = vaddq_f32(low, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+        high = vaddq_f32(high, vmulq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4)));
+    }
+    float lanes[DOT_LANES];
+    vst1q_f32(lanes, low);
+    vst1q_f32(lanes + 4, high);
+    return dotProductTail(a + i, b + i, count - i, reduceLanes(lanes));
+}
+
+#if defined(__aarch64__)
+// FPCR rounding defaults to nearest even, as in the scalar conversion
+void floatToHalfNeon(const float* in, uint16_t* out, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1_u16(out + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(in + i))));
+    }
+    floatToHalfScalar(in + i, out + i, count - i);
+}
+
+void halfToFloatNeon(const uint16_t* in, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(in + i))));
+    }
+    halfToFloatScalar(in + i, out + i, count - i);
+}
+#else
+// 32-bit NEON half conversions need the optional FP16 extension
+constexpr auto floatToHalfNeon = floatToHalfScalar;
+constexpr auto halfToFloatNeon = halfToFloatScalar;
+#endif
+#endif
+
+KernelSet selectKernels() {
+#if defined(OWW_KERNELS_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        // F16C is a separate feature bit, so emulators and some virtual
+        // CPUs expose AVX2 without it
+        if (__builtin_cpu_supports("f16c")) {
+            return {"avx2", convertInt16ToFloatAvx2, divideAddAvx2, multiplyAddAvx2, dotProductAvx2,
+                    floatToHalfF16c, halfToFloatF16c};
+        }
+        return {"avx2", convertInt16ToFloatAvx2, divideAddAvx2, multiplyAddAvx2, dotProductAvx2,
+                floatToHalfScalar, halfToFloatScalar};
+    }
+#endif
+#if defined(OWW_KERNELS_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    return {"sse2", convertInt16ToFloatSse2, divideAddSse2, multiplyAddSse2, dotProductSse2,
+            floatToHalfScalar, halfToFloatScalar};
+#elif defined(OWW_KERNELS_NEON)
+    return {"neon", convertInt16ToFloatNeon, divideAddNeon, multiplyAddNeon, dotProductNeon,
+            floatToHalfNeon, halfToFloatNeon};
+#else
+    return {"scalar", convertInt16ToFloatScalar, divideAddScalar, multiplyAddScalar, dotProductScalar,
+            floatToHalfScalar, halfToFloatScalar};
+#endif
+}
+
+const KernelSet& activeKernels() {
+    static const KernelSet kernels = selectKernels();
+    return kernels;
+}
+
+} // namespace
+
+void convertInt16ToFloat(const int16_t* in, float* out, size_t count) {
+    activeKernels().convertInt16ToFloat(in, out, count);
+}
+
+void divideAdd(const float* in, float* out, size_t count, float divisor, float offset) {
+    activeKernels().divideAdd(in, out, count, divisor, offset);
+}
+
+void multiplyAdd(const float* in, float* out, size_t count, float scale, float offset) {
+    activeKernels().multiplyAdd(in, out, count, scale, offset);
+}
+
+float dotProduct(const float* a, const float* b, size_t count) {
+    return activeKernels().dotProduct(a, b, count);
+}
+
+void floatToHalf(const float* in, uint16_t* out, size_t count) {
+    activeKernels().floatToHalf(in, out, count);
+}
+
+void halfToFloat(const uint16_t* in, float* out, size_t count) {
+    activeKernels().halfToFloat(in, out, count);
+}
+
+bool hasNativeHalfArithmetic() {
+#if defined(__aarch64__) && defined(__APPLE__)
+    return true;  // Every Apple arm64 core implements FP16
+#elif defined(__aarch64__) && defined(__linux__) && defined(HWCAP_ASIMDHP)
+    return (getauxval(AT_HWCAP) & HWCAP_ASIMDHP) != 0;
+#else
+    return false;
+#endif
+}
+
+const char* activeKernelSet() {
+    return activeKernels().name;
+}
+
+} // namespace kernels
+} // namespace openwakeword
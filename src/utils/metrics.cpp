@@ -0,0 +1,276 @@
+#include "utils/metrics.h"
+#include <iomanip>
+#include <sstream>
+#include "core/types.h"
+
+namespace openwakeword {
+
+namespace {
+
+// Label set for the Prometheus exposition
+std::string stageLabels(const std::string& stage, const std::string& model) {
+    std::string labels = "stage=\"" + stage + "\"";
+    if (!model.empty()) {
+        labels += ",model=\"" + model + "\"";
+    }
+    return labels;
+}
+
+void writePrometheusHistogram(std::ostringstream& out, const std::string& name,
+                              const std::string& labels, const LatencyHistogram::Snapshot& snapshot) {
+    std::string separator = labels.empty() ? "" : ",";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < LatencyHistogram::NUM_BOUNDS; ++i) {
+        cumulative += snapshot.buckets[i];
+        out << name << "_bucket{" << labels << separator << "le=\""
+            << LatencyHistogram::BOUNDS[i] << "\"} " << cumulative << "\n";
+    }
+    out << name << "_bucket{" << labels << separator << "le=\"+Inf\"} " << snapshot.count << "\n";
+    out << name << "_sum" << (labels.empty() ? "" : "{" + labels + "}") << " " << snapshot.sum << "\n";
+    out << name << "_count" << (labels.empty() ? "" : "{" + labels + "}") << " " << snapshot.count << "\n";
+}
+
+void writeJsonHistogram(std::ostringstream& out, const LatencyHistogram::Snapshot& snapshot) {
+    out << "{\"count\":" << snapshot.count
+        << ",\"mean_ms\":" << snapshot.mean() * 1e3
+        << ",\"p50_ms\":" << snapshot.quantile(0.5) * 1e3
+        << ",\"p99_ms\":" << snapshot.quantile(0.99) * 1e3 << "}";
+}
+
+} // namespace
+
+void LatencyHistogram::record(std::chrono::nanoseconds elapsed) {
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    size_t bucket = 0;
+    while (bucket < NUM_BOUNDS && seconds > BOUNDS[bucket]) {
+        ++bucket;
+    }
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    sumNanos_.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    Snapshot snapshot;
+    for (size_t i = 0; i <= NUM_BOUNDS; ++i) {
+        snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets[i];
+    }
+    snapshot.sum = static_cast<double>(sumNanos_.load(std::memory_order_relaxed)) * 1e-9;
+    return snapshot;
+}
+
+double LatencyHistogram::Snapshot::quantile(double q) const {
+    if (count == 0) {
+        return 0.0;
+    }
+    auto rank = static_cast<uint64_t>(q * static_cast<double>(count));
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < NUM_BOUNDS; ++i) {
+        cumulative += buckets[i];
+        if (cumulative > rank) {
+            return BOUNDS[i];
+        }
+    }
+    // Beyond the last bound
+    return BOUNDS[NUM_BOUNDS - 1];
+}
+
+void AudioClock::markAudio(uint64_t endPosition) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    audio_[audioMarks_ % HISTORY] = {endPosition, std::chrono::steady_clock::now()};
+    audioMarks_++;
+}
+
+void AudioClock::markEmbedding(uint64_t sequence, uint64_t position) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    embeddings_[sequence % HISTORY] = {sequence, position};
+}
+
+bool AudioClock::embeddingArrival(uint64_t sequence, std::chrono::steady_clock::time_point& time) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto& embedding = embeddings_[sequence % HISTORY];
+    if (embedding.sequence != sequence) {
+        return false;
+    }
+
+    // Oldest chunk that reaches the position; marks are in position order
+    uint64_t first = audioMarks_ > HISTORY ? audioMarks_ - HISTORY : 0;
+    for (uint64_t mark = first; mark < audioMarks_; ++mark) {
+        const auto& audio = audio_[mark % HISTORY];
+        if (audio.endPosition >= embedding.position) {
+            if (mark == first && first > 0) {
+                return false;  // May have arrived in a chunk already forgotten
+            }
+            time = audio.time;
+            return true;
+        }
+    }
+    return false;
+}
+
+Metrics::Metrics() : startTime_(std::chrono::steady_clock::now()) {
+}
+
+LatencyHistogram* Metrics::addStage(const std::string& stage, const std::string& model) {
+    stages_.emplace_back();
+    stages_.back().stage = stage;
+    stages_.back().model = model;
+    return &stages_.back().histogram;
+}
+
+void Metrics::addGauge(const std::string& queue, std::function<double()> read) {
+    gauges_.push_back({queue, std::move(read)});
+}
+
+void Metrics::recordDetection(uint64_t sequence) {
+    detections_.fetch_add(1, std::memory_order_relaxed);
+
+    std::chrono::steady_clock::time_point arrival;
+    if (clock_.embeddingArrival(sequence, arrival)) {
+        detectionLatency_.record(std::chrono::steady_clock::now() - arrival);
+    }
+}
+
+void Metrics::recordStep(uint64_t sequence, bool scored) {
+    if (!hasDeadline()) {
+        return;
+    }
+    
+    // Each detector thread reports the step; it ends with the last of them
+    if (stepReporters_ > 1) {
+        std::lock_guard<std::mutex> lock(stepMutex_);
+        auto& step = steps_[sequence % STEP_HISTORY];
+        if (step.sequence != sequence) {
+            step = {sequence, 0, false};
+        }
+        step.scored = step.scored || scored;
+        if (++step.reported < stepReporters_) {
+            return;
+        }
+        scored = step.scored;
+    }
+    
+    std::chrono::steady_clock::time_point arrival;
+    if (!scored || !clock_.embeddingArrival(sequence, arrival)) {
+        return;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - arrival;
+    stepLatency_.record(elapsed);
+    if (elapsed > deadline_) {
+        deadlineMisses_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+std::vector<Metrics::StageSummary> Metrics::stageSummaries() const {
+    std::vector<StageSummary> summaries;
+    for (const auto& stage : stages_) {
+        summaries.push_back({stage.stage, stage.model, stage.histogram.snapshot()});
+    }
+    return summaries;
+}
+
+double Metrics::audioSeconds() const {
+    return static_cast<double>(audioSamples_.load(std::memory_order_relaxed)) / SAMPLE_RATE;
+}
+
+double Metrics::realTimeFactor() const {
+    double audio = audioSeconds();
+    if (audio <= 0.0) {
+        return 0.0;
+    }
+    double inference = 0.0;
+    for (const auto& stage : stages_) {
+        inference += stage.histogram.snapshot().sum;
+    }
+    return inference / audio;
+}
+
+std::string Metrics::toPrometheus() const {
+    std::ostringstream out;
+
+    out << "# HELP openwakeword_inference_seconds Inference time per call\n";
+    out << "# TYPE openwakeword_inference_seconds histogram\n";
+    for (const auto& stage : stages_) {
+        writePrometheusHistogram(out, "openwakeword_inference_seconds",
+                                 stageLabels(stage.stage, stage.model), stage.histogram.snapshot());
+    }
+
+    out << "# HELP openwakeword_detection_latency_seconds Time from the audio completing a detection to its output\n";
+    out << "# TYPE openwakeword_detection_latency_seconds histogram\n";
+    writePrometheusHistogram(out, "openwakeword_detection_latency_seconds", "", detectionLatency_.snapshot());
+
+    if (hasDeadline()) {
+        out << "# HELP openwakeword_step_latency_seconds Time from the audio completing a step to its wake word scores\n";
+        out << "# TYPE openwakeword_step_latency_seconds histogram\n";
+        writePrometheusHistogram(out, "openwakeword_step_latency_seconds", "", stepLatency_.snapshot());
+
+        out << "# HELP openwakeword_deadline_misses_total Steps scored later than the deadline\n";
+        out << "# TYPE openwakeword_deadline_misses_total counter\n";
+        out << "openwakeword_deadline_misses_total " << deadlineMisses() << "\n";
+
+        out << "# HELP openwakeword_overload_skips_total Windows skipped by the overload policy\n";
+        out << "# TYPE openwakeword_overload_skips_total counter\n";
+        out << "openwakeword_overload_skips_total " << overloadSkips() << "\n";
+    }
+
+    out << "# HELP openwakeword_queue_depth Items waiting between stages\n";
+    out << "# TYPE openwakeword_queue_depth gauge\n";
+    for (const auto& gauge : gauges_) {
+        out << "openwakeword_queue_depth{queue=\"" << gauge.queue << "\"} " << gauge.read() << "\n";
+    }
+
+    out << "# HELP openwakeword_audio_seconds_total Audio received\n";
+    out << "# TYPE openwakeword_audio_seconds_total counter\n";
+    out << "openwakeword_audio_seconds_total " << audioSeconds() << "\n";
+
+    out << "# HELP openwakeword_detections_total Wake word detections\n";
+    out << "# TYPE openwakeword_detections_total counter\n";
+    out << "openwakeword_detections_total " << detections_.load(std::memory_order_relaxed) << "\n";
+
+    out << "# HELP openwakeword_real_time_factor Inference seconds per second of audio\n";
+    out << "# TYPE openwakeword_real_time_factor gauge\n";
+    out << "openwakeword_real_time_factor " << realTimeFactor() << "\n";
+
+    double uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count();
+    out << "# HELP openwakeword_uptime_seconds Time since startup\n";
+    out << "# TYPE openwakeword_uptime_seconds gauge\n";
+    out << "openwakeword_uptime_seconds " << uptime << "\n";
+    return out.str();
+}
+
+std::string Metrics::toJson() const {
+    std::ostringstream out;
+    out << std::setprecision(4);
+
+    out << "{\"audio_seconds\":" << audioSeconds()
+        << ",\"real_time_factor\":" << realTimeFactor()
+        << ",\"detections\":" << detections_.load(std::memory_order_relaxed);
+
+    out << ",\"stages\":{";
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        const auto& stage = stages_[i];
+        out << (i > 0 ? "," : "") << "\"" << stage.stage
+            << (stage.model.empty() ? "" : ":" + stage.model) << "\":";
+        writeJsonHistogram(out, stage.histogram.snapshot());
+    }
+    out << "}";
+
+    out << ",\"queues\":{";
+    for (size_t i = 0; i < gauges_.size(); ++i) {
+        out << (i > 0 ? "," : "") << "\"" << gauges_[i].queue << "\":" << gauges_[i].read();
+    }
+    out << "}";
+
+    out << ",\"detection_latency\":";
+    writeJsonHistogram(out, detectionLatency_.snapshot());
+    if (hasDeadline()) {
+        out << ",\"step_latency\":";
+        writeJsonHistogram(out, stepLatency_.snapshot());
+        out << ",\"deadline_misses\":" << deadlineMisses()
+            << ",\"overload_skips\":" << overloadSkips();
+    }
+    out << "}";
+    return out.str();
+}
+
+} // namespace openwakeword
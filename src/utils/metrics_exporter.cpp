@@ -0,0 +1,161 @@
+#include "utils/metrics_exporter.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace openwakeword {
+
+namespace {
+
+// Longest wait between checks for stop()
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(200);
+
+} // namespace
+
+MetricsExporter::MetricsExporter(const Metrics& metrics, const std::string& host, uint16_t port,
+                                 std::chrono::seconds interval, std::mutex& logMutex)
+    : metrics_(metrics), host_(host), port_(port), interval_(interval), logMutex_(logMutex) {
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start() {
+    if (running_) {
+        return true;
+    }
+
+    if (port_ != 0) {
+#ifdef _WIN32
+        std::cerr << "[ERROR] The metrics endpoint is not supported on Windows" << std::endl;
+        return false;
+#else
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port_);
+        if (::inet_pton(AF_INET, host_.c_str(), &address.sin_addr) != 1) {
+            std::cerr << "[ERROR] Invalid metrics host: " << host_ << std::endl;
+            return false;
+        }
+
+        listenSocket_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listenSocket_ < 0) {
+            std::cerr << "[ERROR] Failed to create metrics socket" << std::endl;
+            return false;
+        }
+
+        int reuse = 1;
+        ::setsockopt(listenSocket_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        if (::bind(listenSocket_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::listen(listenSocket_, 8) != 0) {
+            std::cerr << "[ERROR] Failed to bind metrics endpoint to " << host_ << ":" << port_
+                      << std::endl;
+            ::close(listenSocket_);
+            listenSocket_ = -1;
+            return false;
+        }
+#endif
+    }
+
+    running_ = true;
+    thread_ = std::thread(&MetricsExporter::exportLoop, this);
+    return true;
+}
+
+void MetricsExporter::stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+#ifndef _WIN32
+    if (listenSocket_ >= 0) {
+        ::close(listenSocket_);
+        listenSocket_ = -1;
+    }
+#endif
+}
+
+void MetricsExporter::exportLoop() {
+    auto nextReport = std::chrono::steady_clock::now() + interval_;
+
+    while (running_) {
+        auto wait = POLL_INTERVAL;
+        if (interval_.count() > 0) {
+            auto untilReport = std::chrono::duration_cast<std::chrono::milliseconds>(
+                nextReport - std::chrono::steady_clock::now());
+            wait = std::max(std::chrono::milliseconds(0), std::min(wait, untilReport));
+        }
+
+#ifndef _WIN32
+        if (listenSocket_ >= 0) {
+            pollfd listener{listenSocket_, POLLIN, 0};
+            if (::poll(&listener, 1, static_cast<int>(wait.count())) > 0 && (listener.revents & POLLIN)) {
+                int client = ::accept(listenSocket_, nullptr, nullptr);
+                if (client >= 0) {
+                    serveClient(client);
+                }
+            }
+        } else
+#endif
+        {
+            std::this_thread::sleep_for(wait);
+        }
+
+        if (interval_.count() > 0 && std::chrono::steady_clock::now() >= nextReport) {
+            std::unique_lock<std::mutex> lock(logMutex_);
+            std::cerr << "{\"stats\":" << metrics_.toJson() << "}" << std::endl;
+            nextReport += interval_;
+        }
+    }
+}
+
+void MetricsExporter::serveClient(int client) {
+#ifndef _WIN32
+    // Slow clients must not stall the JSON reports
+    timeval timeout{1, 0};
+    ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // Every request gets the metrics; read until the end of the headers
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+        ssize_t received = ::recv(client, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    std::string body = metrics_.toPrometheus();
+    std::string response = "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: text/plain; version=0.0.4\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           "Connection: close\r\n\r\n" + body;
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t written = ::send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(written);
+    }
+    ::close(client);
+#else
+    (void)client;
+#endif
+}
+
+} // namespace openwakeword
@@ -0,0 +1,118 @@
+#include "utils/thread_affinity.h"
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace openwakeword {
+
+bool pinCurrentThread(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return true;
+    }
+
+#if defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+            return false;
+        }
+        mask |= static_cast<DWORD_PTR>(1) << cpu;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            return false;
+        }
+        CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    // macOS only offers affinity hints, not pinning
+    return false;
+#endif
+}
+
+bool setRealtimePriority(int priority) {
+#if defined(_WIN32)
+    (void)priority;
+    return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+#else
+    sched_param param{};
+    param.sched_priority = priority;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#endif
+}
+
+namespace {
+
+// One past the highest CPU id pinCurrentThread can be given
+long cpuLimit() {
+#if defined(_WIN32)
+    long limit = static_cast<long>(sizeof(DWORD_PTR) * 8);
+#elif defined(__linux__)
+    long limit = CPU_SETSIZE;
+#else
+    long limit = 1024;
+#endif
+    unsigned online = std::thread::hardware_concurrency();
+    return online > 0 ? std::min(limit, static_cast<long>(online)) : limit;
+}
+
+} // namespace
+
+bool parseCpuList(const std::string& text, std::vector<int>& cpus) {
+    cpus.clear();
+    const long limit = cpuLimit();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        size_t dash = item.find('-');
+        char* end = nullptr;
+        long first = std::strtol(item.c_str(), &end, 10);
+        if (item.empty() || end == item.c_str() || first < 0) {
+            return false;
+        }
+
+        long last = first;
+        if (dash != std::string::npos) {
+            if (end != item.c_str() + dash) {
+                return false;
+            }
+            const char* rest = item.c_str() + dash + 1;
+            last = std::strtol(rest, &end, 10);
+            if (end == rest || last < first) {
+                return false;
+            }
+        }
+        // Also keeps a huge range from being expanded
+        if (*end != '\0' || last >= limit) {
+            return false;
+        }
+
+        for (long cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return !cpus.empty();
+}
+
+std::string formatCpuList(const std::vector<int>& cpus) {
+    std::string text;
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        text += (i > 0 ? "," : "") + std::to_string(cpus[i]);
+    }
+    return text;
+}
+
+} // namespace openwakeword